@@ -0,0 +1,182 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <geometry/algorithms/render_trace.h>
+#include <file_io/render_report.h>
+#include <file_io/scene_description.h>
+#include <raytracing/render_scene_description.h>
+
+namespace
+{
+    void print_usage()
+    {
+        std::cerr << "usage: bezier_render <scene description> [--output <image.ppm>] [--hdr <image.pfm>] [--exposure <factor>] [--threads <n>] [--tile_size <n>] [--report <report.json>] [--trace <trace.json>] [--counters]\n"
+            << "renders the scene into a ppm image and prints a json report of the timings to the standard output or the report file\n"
+            << "--counters adds cycles, instructions, cache misses and branch misses per ray of the render phase (linux perf_event)\n";
+    }
+
+    double seconds_since(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        print_usage();
+        return 2;
+    }
+
+    std::string description_file = argv[1];
+    std::string output, hdr_output, exposure, threads, tile_size, report_file, trace_file;
+    bool count_hardware_events = false;
+
+    for (int i = 2; i < argc; i++)
+    {
+        std::string option = argv[i];
+
+        if ("--counters" == option)
+        {
+            count_hardware_events = true;
+            continue;
+        }
+
+        if (argc <= i + 1)
+        {
+            print_usage();
+            return 2;
+        }
+
+        if ("--output" == option) output = argv[++i];
+        else if ("--hdr" == option) hdr_output = argv[++i];
+        else if ("--exposure" == option) exposure = argv[++i];
+        else if ("--threads" == option) threads = argv[++i];
+        else if ("--tile_size" == option) tile_size = argv[++i];
+        else if ("--report" == option) report_file = argv[++i];
+        else if ("--trace" == option) trace_file = argv[++i];
+        else
+        {
+            print_usage();
+            return 2;
+        }
+    }
+
+#ifndef RENDER_TRACING
+    if (!trace_file.empty())
+    {
+        std::cerr << "--trace needs a build with RENDER_TRACING\n";
+        return 2;
+    }
+#endif
+
+    render_report report;
+    report.scene = description_file;
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::string error;
+    auto description = load_scene_description(description_file, error);
+
+    if (!description.has_value())
+    {
+        std::cerr << description_file << ": " << error << "\n";
+        return 1;
+    }
+
+    // the command line overrides the description
+    try
+    {
+        if (!output.empty()) description->output = output;
+        if (!hdr_output.empty()) description->hdr_output = hdr_output;
+        if (!exposure.empty()) description->mapping.exposure = std::stod(exposure);
+        if (!threads.empty()) description->threads = std::stoi(threads);
+        if (!tile_size.empty()) description->tile_size = std::stoi(tile_size);
+    }
+    catch (const std::exception&)
+    {
+        print_usage();
+        return 2;
+    }
+
+    if (description->threads < 0 || description->tile_size <= 0 || description->mapping.exposure <= 0)
+    {
+        print_usage();
+        return 2;
+    }
+
+    if (!supports_float_output(*description))
+    {
+        std::cerr << description_file << ": float images, aovs, supersampling and tone mapping need the exact renderer without max_depth\n";
+        return 1;
+    }
+
+    report.output = description->output.string();
+    report.phase_seconds.emplace_back("load", seconds_since(start));
+
+    // the renderers log to the standard output, which is reserved for the report
+    std::streambuf* standard_output = std::cout.rdbuf(std::cerr.rdbuf());
+
+    std::optional<hardware_counters> counters;
+
+    if (count_hardware_events)
+    {
+        counters.emplace();
+
+        if (!counters->is_available())
+        {
+            std::cerr << "hardware counters unavailable, the kernel grants none without a pmu or above perf_event_paranoid 2\n";
+        }
+    }
+
+    auto frame = render_scene_description(*description, report, counters.has_value() ? &*counters : nullptr);
+
+    std::cout.rdbuf(standard_output);
+
+#ifdef RENDER_TRACING
+    if (!trace_file.empty())
+    {
+        std::ofstream stream(trace_file, std::ofstream::trunc);
+        write_chrome_trace(stream);
+
+        if (!stream)
+        {
+            std::cerr << "can't write " << trace_file << "\n";
+            return 1;
+        }
+    }
+#endif
+
+    start = std::chrono::steady_clock::now();
+
+    auto failed = write_rendered_frame(*description, frame);
+
+    if (!failed.empty())
+    {
+        std::cerr << "can't write " << failed << "\n";
+        return 1;
+    }
+
+    report.phase_seconds.emplace_back("write", seconds_since(start));
+
+    if (report_file.empty())
+    {
+        write_json(std::cout, report);
+    }
+    else
+    {
+        std::ofstream stream(report_file, std::ofstream::trunc);
+        write_json(stream, report);
+
+        if (!stream)
+        {
+            std::cerr << "can't write " << report_file << "\n";
+            return 1;
+        }
+    }
+
+    return 0;
+}
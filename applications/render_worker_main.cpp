@@ -0,0 +1,38 @@
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <distributed/render_worker.h>
+#include <file_io/scene_file.h>
+
+// render_worker <host> <port> <scene file> [threads]
+int main(int argc, char** argv)
+{
+    if (argc < 4)
+    {
+        std::cerr << "usage: render_worker <host> <port> <scene file> [threads]\n";
+        return 2;
+    }
+
+    auto scene = load_scene(argv[3]);
+
+    if (!scene.has_value())
+    {
+        std::cerr << "can't read scene " << argv[3] << "\n";
+        return 1;
+    }
+
+    int threadcount = 4 < argc ? std::stoi(argv[4]) : std::max(1u, std::thread::hardware_concurrency());
+
+    int rendered_tiles = run_render_worker(argv[1], std::stoi(argv[2]), *scene, threadcount);
+
+    if (rendered_tiles < 0)
+    {
+        std::cerr << "can't connect to " << argv[1] << ":" << argv[2] << "\n";
+        return 1;
+    }
+
+    std::cout << "rendered " << rendered_tiles << " tiles\n";
+
+    return 0;
+}
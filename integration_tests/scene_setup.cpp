@@ -17,7 +17,12 @@ void compare_actual_with_expected_file(const std::string file_name)
 
 std::filesystem::path get_actual_folder()
 {
-    return std::filesystem::path(__FILE__).parent_path() / "actual";
+    // not versioned, created on the first run
+    auto folder = std::filesystem::path(__FILE__).parent_path() / "actual";
+
+    std::filesystem::create_directories(folder);
+
+    return folder;
 }
 
 std::filesystem::path get_expected_folder()
@@ -62,6 +67,31 @@ std::function<std::vector<int>(double, double)> get_texture(int index)
     }
 }
 
+material get_material(int index)
+{
+    switch (index)
+    {
+    case 0:
+        return checker_material(color{ {255, 210, 80} }, color{ {210, 80, 255} });
+    case 1:
+        return checker_material(color{ {255, 80, 210} }, color{ {25, 255, 45} });
+    default:
+        return constant_material(color{ {0, 0, 0} });
+    }
+}
+
+material_table get_materials(const std::vector<int>& indices)
+{
+    material_table table;
+
+    for (auto index : indices)
+    {
+        table.materials.push_back(get_material(index));
+    }
+
+    return table;
+}
+
 varmesh<4> get_curved_patch()
 {
     varmesh<4> m(3, 3);
@@ -174,6 +204,8 @@ varmesh_scene_descriptor get_curved_patch_scene()
     1E-5
     };
 
+    scene.materials = get_materials({ 0 });
+
     return scene;
 }
 
@@ -191,6 +223,8 @@ varmesh_scene_descriptor get_twisted_patch_scene()
     1E-9
     };
 
+    scene.materials = get_materials({ 0 });
+
     return scene;
 }
 
@@ -208,6 +242,8 @@ varmesh_scene_descriptor get_sphere_scene()
     1E-5
     };
 
+    scene.materials = get_materials({ 0 });
+
     return scene;
 }
 
@@ -227,7 +263,7 @@ multiple_surfaces_scene_descriptor get_multiple_surfaces_scene()
         scene_object{ plane, get_texture(0)}
     };
 
-    return multiple_surfaces_scene_descriptor {
+    multiple_surfaces_scene_descriptor scene{
             512,
             512,
             v3{ 0, 0, -5 },
@@ -237,6 +273,10 @@ multiple_surfaces_scene_descriptor get_multiple_surfaces_scene()
                 objects,
                 1E-8
     };
+
+    scene.materials = get_materials({ 0, 1, 0 });
+
+    return scene;
 }
 
 multiple_surfaces_scene_descriptor get_multiple_splitted_surfaces_scene()
@@ -268,7 +308,7 @@ multiple_surfaces_scene_descriptor get_multiple_splitted_surfaces_scene()
         objects.push_back(scene_object{ p, get_texture(0) });
     }
 
-    return multiple_surfaces_scene_descriptor{
+    multiple_surfaces_scene_descriptor scene{
             512,
             512,
             v3{ 0, 0, -5 },
@@ -278,4 +318,53 @@ multiple_surfaces_scene_descriptor get_multiple_splitted_surfaces_scene()
                 objects,
                 1E-8
     };
-}
\ No newline at end of file
+
+    std::vector<int> material_indices{ 0, 1, 0 };
+    material_indices.resize(objects.size(), 0);
+
+    scene.materials = get_materials(material_indices);
+
+    return scene;
+}
+
+multiple_surfaces_scene_descriptor get_reflective_multiple_surfaces_scene()
+{
+    auto scene = get_multiple_surfaces_scene();
+
+    scene.surfaces[0].reflectivity = 0.3;
+    scene.surfaces[1].reflectivity = 0.3;
+    scene.surfaces[2].reflectivity = 0.5;
+    scene.max_depth = 2;
+
+    return scene;
+}
+
+multiple_surfaces_scene_descriptor get_multiple_patches_scene(int splits)
+{
+    auto scene = get_multiple_surfaces_scene();
+
+    std::vector<scene_object> patches;
+    std::vector<int> material_indices;
+
+    for (int surface = 0; surface < 2; surface++)
+    {
+        for (int i = 0; i < splits; i++)
+        {
+            for (int j = 0; j < splits; j++)
+            {
+                scene_object patch = scene.surfaces[surface];
+                bezier_clip_surface(patch.mesh, v2{ double(i) / splits, double(i + 1) / splits }, v2{ double(j) / splits, double(j + 1) / splits });
+                patches.push_back(patch);
+                material_indices.push_back(surface);
+            }
+        }
+    }
+
+    patches.push_back(scene.surfaces[2]);
+    material_indices.push_back(0);
+
+    scene.surfaces = patches;
+    scene.materials = get_materials(material_indices);
+
+    return scene;
+}
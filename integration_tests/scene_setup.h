@@ -19,6 +19,10 @@ std::filesystem::path get_expected_folder();
 
 std::function<std::vector<int>(double, double)> get_texture(int index);
 
+// the checkers of get_texture as materials
+material get_material(int index);
+material_table get_materials(const std::vector<int>& indices);
+
 varmesh<4> get_curved_patch();
 
 varmesh<4> get_sphere_patch();
@@ -33,5 +37,8 @@ varmesh_scene_descriptor get_twisted_patch_scene();
 
 multiple_surfaces_scene_descriptor get_multiple_surfaces_scene();
 multiple_surfaces_scene_descriptor get_multiple_splitted_surfaces_scene();
+multiple_surfaces_scene_descriptor get_reflective_multiple_surfaces_scene();
+// the curved surfaces of the multiple surfaces scene split into splits x splits patches each
+multiple_surfaces_scene_descriptor get_multiple_patches_scene(int splits);
 
 #endif // test_integration_scene_setup_h
@@ -0,0 +1,396 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include "scene_setup.h"
+
+#include <geometry/algorithms/bilinear_patch_intersection.h>
+#include <geometry/linear_algebra/formulas.h>
+#include <graphics/screen_geometry.h>
+#include <raytracing/hardware_counters.h>
+#include <file_io/file_io.h>
+
+
+using ::testing::InitGoogleTest;
+using ::testing::Test;
+using ::testing::TestCase;
+using ::testing::TestEventListeners;
+using ::testing::TestInfo;
+using ::testing::TestPartResult;
+using ::testing::UnitTest;
+
+template<class F> double measure_seconds(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    f();
+
+    std::chrono::duration<double> elapsed_seconds = std::chrono::steady_clock::now() - start;
+
+    return elapsed_seconds.count();
+}
+
+TEST(Benchmark, secondary_rays_unsorted_and_sorted)
+{
+    auto scene = get_reflective_multiple_surfaces_scene();
+    scene.screen_width = 192;
+    scene.screen_height = 192;
+
+    std::vector<int> unsorted_pixel, sorted_pixel;
+
+    double unsorted_seconds = measure_seconds([&] { unsorted_pixel = std::get<0>(raytrace_scene_recursive_multithreaded(scene, threads_to_use(), false)); });
+    double sorted_seconds = measure_seconds([&] { sorted_pixel = std::get<0>(raytrace_scene_recursive_multithreaded(scene, threads_to_use(), true)); });
+
+    EXPECT_EQ(unsorted_pixel, sorted_pixel);
+
+    double primary_rays = scene.screen_width * scene.screen_height;
+
+    std::cout << "\nunsorted: " << primary_rays / unsorted_seconds << " primary rays/s"
+        << "\nsorted:   " << primary_rays / sorted_seconds << " primary rays/s\n";
+}
+
+TEST(Benchmark, clipping_and_hybrid_solver)
+{
+    auto scene = get_multiple_surfaces_scene();
+    scene.screen_width = 192;
+    scene.screen_height = 192;
+
+    intersection_statistics clipping_statistics, hybrid_statistics;
+    std::vector<int> clipping_pixel, hybrid_pixel;
+
+    double clipping_seconds = measure_seconds([&] { clipping_pixel = std::get<0>(raytrace_scene_through_quasi_interpolation_multithreaded(scene, threads_to_use(), clipping_statistics)); });
+
+    scene.solver = intersection_solver::hybrid;
+
+    double hybrid_seconds = measure_seconds([&] { hybrid_pixel = std::get<0>(raytrace_scene_through_quasi_interpolation_multithreaded(scene, threads_to_use(), hybrid_statistics)); });
+
+    int differing_pixel = 0;
+    for (int i = 0; i < clipping_pixel.size(); i += 3)
+    {
+        if (!std::equal(clipping_pixel.begin() + i, clipping_pixel.begin() + i + 3, hybrid_pixel.begin() + i))
+        {
+            differing_pixel++;
+        }
+    }
+
+    EXPECT_GT(clipping_statistics.clipping_steps, hybrid_statistics.clipping_steps);
+    EXPECT_LT(differing_pixel, scene.screen_width * scene.screen_height / 200);
+
+    double primary_rays = scene.screen_width * scene.screen_height;
+
+    std::cout << "\nclipping: " << primary_rays / clipping_seconds << " primary rays/s, " << clipping_statistics
+        << "\nhybrid:   " << primary_rays / hybrid_seconds << " primary rays/s, " << hybrid_statistics
+        << "\ndiffering pixel: " << differing_pixel << "\n";
+}
+
+TEST(Benchmark, clipping_and_float_first_solver)
+{
+    auto scene = get_multiple_surfaces_scene();
+    scene.screen_width = 192;
+    scene.screen_height = 192;
+
+    intersection_statistics clipping_statistics, float_statistics;
+    std::vector<int> clipping_pixel, float_pixel;
+
+    double clipping_seconds = measure_seconds([&] { clipping_pixel = std::get<0>(raytrace_scene_through_quasi_interpolation_multithreaded(scene, threads_to_use(), clipping_statistics)); });
+
+    scene.solver = intersection_solver::float_first;
+
+    double float_seconds = measure_seconds([&] { float_pixel = std::get<0>(raytrace_scene_through_quasi_interpolation_multithreaded(scene, threads_to_use(), float_statistics)); });
+
+    int differing_pixel = 0;
+    for (int i = 0; i < clipping_pixel.size(); i += 3)
+    {
+        if (!std::equal(clipping_pixel.begin() + i, clipping_pixel.begin() + i + 3, float_pixel.begin() + i))
+        {
+            differing_pixel++;
+        }
+    }
+
+    EXPECT_LT(float_statistics.double_resolves, float_statistics.float_solves);
+    EXPECT_LT(differing_pixel, scene.screen_width * scene.screen_height / 200);
+
+    double primary_rays = scene.screen_width * scene.screen_height;
+
+    std::cout << "\nclipping:    " << primary_rays / clipping_seconds << " primary rays/s, " << clipping_statistics
+        << "\nfloat first: " << primary_rays / float_seconds << " primary rays/s, " << float_statistics
+        << "\ndiffering pixel: " << differing_pixel << "\n";
+}
+
+TEST(Benchmark, bilinear_clipping_and_analytic)
+{
+    auto scene = get_multiple_splitted_surfaces_scene();
+    scene.screen_width = 128;
+    scene.screen_height = 128;
+
+    screen_geometry screen(scene.screen_width, scene.screen_height, scene.field_of_view, 0, 0, 0);
+
+    // the projected planar patches of all primary rays
+    std::vector<varmesh<2>> meshes;
+
+    for (int y = 0; y < scene.screen_height; y++)
+    {
+        for (int x = 0; x < scene.screen_width; x++)
+        {
+            auto [vertical_plane, horizontal_plane] = planes_of_ray(scene.origin, screen.get_corresponding_ray(x, y));
+
+            for (const auto& surface : scene.surfaces)
+            {
+                if (surface.mesh.row_size() == 2 && surface.mesh.col_size() == 2)
+                {
+                    meshes.push_back(project_mesh(surface.mesh, vertical_plane, horizontal_plane));
+                }
+            }
+        }
+    }
+
+    intersection_statistics& statistics = thread_intersection_statistics();
+    statistics = intersection_statistics{};
+
+    std::vector<int> clipping_root_count, analytic_root_count;
+
+    double clipping_seconds = measure_seconds([&] {
+        for (const auto& m : meshes)
+        {
+            clipping_root_count.push_back(bilinear_patch_roots_clipping(m, scene.epsilon).size());
+        }
+    });
+
+    long long clipping_steps = statistics.clipping_steps;
+
+    double analytic_seconds = measure_seconds([&] {
+        std::array<v2, 2> roots;
+
+        for (const auto& m : meshes)
+        {
+            analytic_root_count.push_back(bilinear_patch_roots_analytic(m, scene.epsilon, roots));
+        }
+    });
+
+    int differing_count = 0;
+    for (int i = 0; i < meshes.size(); i++)
+    {
+        differing_count += clipping_root_count[i] != analytic_root_count[i];
+    }
+
+    // the timings are only printed, the analytic solver takes no clipping steps
+    EXPECT_LT(differing_count, meshes.size() / 1000 + 1);
+    EXPECT_LT(0, clipping_steps);
+    EXPECT_EQ(clipping_steps, statistics.clipping_steps);
+
+    std::cout << "\nclipping: " << meshes.size() / clipping_seconds << " patches/s, " << clipping_steps << " clipping steps"
+        << "\nanalytic: " << meshes.size() / analytic_seconds << " patches/s"
+        << "\ndiffering root counts: " << differing_count << " of " << meshes.size() << "\n";
+}
+
+TEST(Benchmark, exact_and_tessellated_frame)
+{
+    auto scene = get_multiple_surfaces_scene();
+    scene.screen_width = 192;
+    scene.screen_height = 192;
+
+    std::vector<int> exact_pixel, tessellated_pixel;
+
+    double exact_seconds = measure_seconds([&] { exact_pixel = std::get<0>(raytrace_scene_through_quasi_interpolation_multithreaded(scene, threads_to_use())); });
+
+    std::optional<tessellated_scene_descriptor> tessellated;
+
+    double tessellation_seconds = measure_seconds([&] { tessellated = tessellate_scene(scene, screen_space_tessellation_settings(scene, 0.5), threads_to_use()); });
+
+    double tessellated_seconds = measure_seconds([&] { tessellated_pixel = std::get<0>(raytrace_scene_with_tessellated_surfaces_multithreaded(*tessellated, threads_to_use())); });
+
+    // parallel tessellation merges the patches in order
+    EXPECT_EQ(tessellated->facettes, tessellate_scene(scene, screen_space_tessellation_settings(scene, 0.5), 1).facettes);
+
+    int differing_pixel = 0;
+    for (int i = 0; i < exact_pixel.size(); i += 3)
+    {
+        bool differs = false;
+        for (int c = 0; c < 3; c++)
+        {
+            differs = differs || 8 < std::abs(exact_pixel[i + c] - tessellated_pixel[i + c]);
+        }
+        differing_pixel += differs;
+    }
+
+    EXPECT_LT(differing_pixel, scene.screen_width * scene.screen_height / 50);
+
+    std::cout << "\nexact:       " << exact_seconds << " s per frame"
+        << "\ntessellated: " << tessellated_seconds << " s per frame after " << tessellation_seconds << " s for " << tessellated->facettes.size() << " triangles"
+        << "\ndiffering pixel: " << differing_pixel << " of " << scene.screen_width * scene.screen_height << "\n";
+}
+
+TEST(Benchmark, exact_and_hybrid_frame)
+{
+    auto scene = get_multiple_surfaces_scene();
+    scene.screen_width = 192;
+    scene.screen_height = 192;
+
+    intersection_statistics exact_statistics, hybrid_statistics;
+    std::vector<int> exact_pixel, hybrid_pixel;
+
+    double exact_seconds = measure_seconds([&] { exact_pixel = std::get<0>(raytrace_scene_through_quasi_interpolation_multithreaded(scene, threads_to_use(), exact_statistics)); });
+
+    std::optional<hybrid_surfaces_scene_descriptor> hybrid;
+
+    double preparation_seconds = measure_seconds([&] { hybrid.emplace(scene); });
+    hybrid->solver = intersection_solver::hybrid;
+
+    double hybrid_seconds = measure_seconds([&] { hybrid_pixel = std::get<0>(raytrace_scene_through_quasi_interpolation_multithreaded(*hybrid, threads_to_use(), hybrid_statistics)); });
+
+    int differing_pixel = 0;
+    for (int i = 0; i < exact_pixel.size(); i += 3)
+    {
+        if (!std::equal(exact_pixel.begin() + i, exact_pixel.begin() + i + 3, hybrid_pixel.begin() + i))
+        {
+            differing_pixel++;
+        }
+    }
+
+    EXPECT_EQ(0, differing_pixel);
+    EXPECT_GT(exact_statistics.clipping_steps, hybrid_statistics.clipping_steps);
+
+    double primary_rays = scene.screen_width * scene.screen_height;
+
+    std::cout << "\nexact:  " << primary_rays / exact_seconds << " primary rays/s, " << exact_statistics
+        << "\nhybrid: " << primary_rays / hybrid_seconds << " primary rays/s after " << preparation_seconds << " s for " << hybrid->leaf_bounds.size() << " leaves, " << hybrid_statistics
+        << "\ndiffering pixel: " << differing_pixel << " of " << scene.screen_width * scene.screen_height << "\n";
+}
+
+TEST(Benchmark, unbounded_and_bounded_patches)
+{
+    auto scene = get_multiple_patches_scene(8);
+    scene.screen_width = 192;
+    scene.screen_height = 192;
+
+    bounded_surfaces_scene_descriptor bounded(scene);
+
+    intersection_statistics unbounded_statistics, bounded_statistics;
+    std::vector<int> unbounded_pixel, bounded_pixel;
+
+    double unbounded_seconds = measure_seconds([&] { unbounded_pixel = std::get<0>(raytrace_scene_through_quasi_interpolation_multithreaded(scene, threads_to_use(), unbounded_statistics)); });
+    double bounded_seconds = measure_seconds([&] { bounded_pixel = std::get<0>(raytrace_scene_through_quasi_interpolation_multithreaded(bounded, threads_to_use(), bounded_statistics)); });
+
+    EXPECT_EQ(unbounded_pixel, bounded_pixel);
+    EXPECT_EQ(scene.screen_width * scene.screen_height * scene.surfaces.size(), bounded_statistics.bounds_tests);
+
+    double primary_rays = scene.screen_width * scene.screen_height;
+    double rejection_rate = double(bounded_statistics.box_rejections + bounded_statistics.sphere_rejections) / bounded_statistics.bounds_tests;
+
+    std::cout << "\nunbounded: " << primary_rays / unbounded_seconds << " primary rays/s"
+        << "\nbounded:   " << primary_rays / bounded_seconds << " primary rays/s, " << bounded_statistics
+        << "\nrejected patches: " << 100 * rejection_rate << "%\n";
+}
+
+TEST(Benchmark, unbinned_and_binned_patches)
+{
+    auto scene = get_multiple_patches_scene(8);
+    scene.screen_width = 192;
+    scene.screen_height = 192;
+
+    std::optional<binned_surfaces_scene_descriptor> binned;
+
+    double binning_seconds = measure_seconds([&] { binned = bin_surfaces_to_tiles(scene); });
+
+    intersection_statistics unbinned_statistics, binned_statistics;
+    std::vector<int> unbinned_pixel, binned_pixel;
+
+    double unbinned_seconds = measure_seconds([&] { unbinned_pixel = std::get<0>(raytrace_scene_through_quasi_interpolation_multithreaded(scene, threads_to_use(), unbinned_statistics)); });
+    double binned_seconds = measure_seconds([&] { binned_pixel = std::get<0>(raytrace_scene_through_quasi_interpolation_multithreaded(*binned, threads_to_use(), binned_statistics)); });
+
+    EXPECT_EQ(unbinned_pixel, binned_pixel);
+
+    double candidates = 0;
+    for (const auto& surfaces : binned->tile_surfaces)
+    {
+        candidates += surfaces.size();
+    }
+
+    double primary_rays = scene.screen_width * scene.screen_height;
+
+    std::cout << "\nunbinned: " << primary_rays / unbinned_seconds << " primary rays/s, " << unbinned_statistics
+        << "\nbinned:   " << primary_rays / binned_seconds << " primary rays/s after " << binning_seconds << " s, " << binned_statistics
+        << "\nsurfaces per tile: " << candidates / binned->tiles.size() << " of " << scene.surfaces.size() << "\n";
+}
+
+TEST(Benchmark, uniform_and_adaptive_supersampling)
+{
+    auto scene = get_multiple_surfaces_scene();
+    scene.screen_width = 192;
+    scene.screen_height = 192;
+
+    auto binned = bin_surfaces_to_tiles(scene);
+
+    supersampling_settings uniform;
+    uniform.strata = 4;
+    uniform.max_samples = 16;
+    // every pixel is refined until it has all samples
+    uniform.contrast_threshold = -1;
+    uniform.noise_threshold = -1;
+
+    supersampling_settings adaptive;
+    adaptive.strata = 4;
+    adaptive.max_samples = 16;
+
+    intersection_statistics uniform_statistics, adaptive_statistics;
+    std::optional<hdr_image> uniform_image, adaptive_image;
+
+    double uniform_seconds = measure_seconds([&] { uniform_image = raytrace_scene_supersampled_multithreaded(binned, uniform, threads_to_use(), uniform_statistics); });
+    double adaptive_seconds = measure_seconds([&] { adaptive_image = raytrace_scene_supersampled_multithreaded(binned, adaptive, threads_to_use(), adaptive_statistics); });
+
+    double uniform_samples = 0, adaptive_samples = 0, difference = 0;
+
+    for (int index = 0; index < scene.screen_width * scene.screen_height; index++)
+    {
+        uniform_samples += uniform_image->weights[index];
+        adaptive_samples += adaptive_image->weights[index];
+
+        for (int c = 0; c < 3; c++)
+        {
+            difference = std::max(difference, std::abs(uniform_image->resolve(index)[c] - adaptive_image->resolve(index)[c]));
+        }
+    }
+
+    double pixels = scene.screen_width * scene.screen_height;
+
+    std::cout << "\nuniform:  " << uniform_samples / pixels << " samples per pixel in " << uniform_seconds << " s, " << uniform_statistics
+        << "\nadaptive: " << adaptive_samples / pixels << " samples per pixel in " << adaptive_seconds << " s, " << adaptive_statistics
+        << "\nlargest difference: " << 255 * difference << " of 255\n";
+}
+
+TEST(Benchmark, hardware_counters_per_ray)
+{
+    hardware_counters counters;
+
+    if (!counters.is_available())
+    {
+        GTEST_SKIP() << "hardware counters unavailable, the kernel grants none without a pmu or above perf_event_paranoid 2";
+    }
+
+    auto measure = [&](const char* mode, int rays, auto render) {
+        counters.start();
+
+        double seconds = measure_seconds(render);
+
+        auto values = counters.stop();
+
+        std::cout << mode << ": " << seconds << " s, ";
+        write_per_ray(std::cout, values, rays);
+        std::cout << "\n";
+
+        EXPECT_LT(0, values.instructions.value_or(1));
+    };
+
+    auto scene = get_twisted_patch_scene();
+
+    measure("quasi-interpolation", scene.screen_width * scene.screen_height, [&] { raytrace_scene_through_quasi_interpolation_multithreaded(scene, threads_to_use()); });
+    measure("hierarchy", scene.screen_width * scene.screen_height, [&] { raytrace_scene_with_meshes_hierarchy_multithreaded(scene, threads_to_use()); });
+
+    auto teapot = std::filesystem::path(__FILE__).parent_path().parent_path() / "3d_models" / "teapot.obj";
+
+    auto [facets, points] = parse_wavefront(teapot.string());
+
+    facetted_surface_scene_descriptor facetted = { 640, 480, {14, 9, -12}, 0, 0, 0, 30, {1, 1, 1}, points, facets };
+
+    measure("facetted", facetted.screen_width * facetted.screen_height, [&] { raytrace_scene_with_facetted_surface_multithreaded(facetted, threads_to_use()); });
+}
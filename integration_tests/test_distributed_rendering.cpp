@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <thread>
+
+#include <distributed/render_coordinator.h>
+#include <distributed/render_worker.h>
+#include <distributed/tile_protocol.h>
+#include <file_io/scene_file.h>
+
+#include "scene_setup.h"
+
+namespace
+{
+    multiple_surfaces_scene_descriptor get_small_multiple_surfaces_scene()
+    {
+        auto scene = get_multiple_surfaces_scene();
+
+        scene.screen_width = 160;
+        scene.screen_height = 128;
+
+        return scene;
+    }
+}
+
+TEST(DistributedRendering, test_scene_file_round_trip)
+{
+    auto scene = get_small_multiple_surfaces_scene();
+
+    auto file_path = get_actual_folder() / "multiple_surfaces_scene.scene";
+
+    ASSERT_TRUE(save_scene(file_path, scene));
+
+    auto loaded = load_scene(file_path);
+
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(scene.surfaces.size(), loaded->surfaces.size());
+
+    auto [pixel, width, height] = raytrace_scene_through_quasi_interpolation_multithreaded(scene, threads_to_use());
+    auto [loaded_pixel, loaded_width, loaded_height] = raytrace_scene_through_quasi_interpolation_multithreaded(*loaded, threads_to_use());
+
+    EXPECT_EQ(pixel, loaded_pixel);
+}
+
+TEST(DistributedRendering, test_reject_corrupt_scene_files)
+{
+    auto scene = get_small_multiple_surfaces_scene();
+
+    auto file_path = get_actual_folder() / "corrupt_scene.scene";
+    ASSERT_TRUE(save_scene(file_path, scene));
+
+    std::string bytes;
+    {
+        std::ifstream stream(file_path, std::ifstream::binary);
+        bytes.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+
+    auto write_corrupted = [&](size_t offset, std::uint32_t value) {
+        std::string corrupted = bytes;
+        std::memcpy(corrupted.data() + offset, &value, sizeof(value));
+        std::ofstream(file_path, std::ofstream::binary | std::ofstream::trunc) << corrupted;
+    };
+
+    // magic, version, screen, camera, rotation, field of view, light, epsilon, max depth and solver
+    size_t surface_count_offset = 2 * 4 + 2 * 4 + 3 * 8 + 3 * 8 + 8 + 3 * 8 + 8 + 2 * 4;
+    size_t rows_offset = surface_count_offset + 4;
+
+    // counts beyond the end of the file aren't allocated
+    write_corrupted(rows_offset, 0x7fffffff);
+    EXPECT_FALSE(load_scene(file_path).has_value());
+
+    write_corrupted(surface_count_offset - 4, 7);
+    EXPECT_FALSE(load_scene(file_path).has_value());
+
+    write_corrupted(8, 0);
+    EXPECT_FALSE(load_scene(file_path).has_value());
+
+    // truncated
+    std::ofstream(file_path, std::ofstream::binary | std::ofstream::trunc) << bytes.substr(0, bytes.size() - 1);
+    EXPECT_FALSE(load_scene(file_path).has_value());
+
+    std::ofstream(file_path, std::ofstream::binary | std::ofstream::trunc) << bytes;
+    EXPECT_TRUE(load_scene(file_path).has_value());
+}
+
+TEST(DistributedRendering, test_coordinator_without_socket_returns_at_once)
+{
+    render_coordinator listening(64, 64);
+    ASSERT_TRUE(listening.is_listening());
+
+    render_coordinator occupied(64, 64, 32, listening.port());
+
+    EXPECT_FALSE(occupied.is_listening());
+    EXPECT_TRUE(occupied.render().empty());
+
+    // the results of the tiles couldn't be received
+    for (int tile_size : { 0, maximal_tile_size + 1 })
+    {
+        render_coordinator oversized(64, 64, tile_size);
+
+        EXPECT_FALSE(oversized.is_listening());
+        EXPECT_TRUE(oversized.render().empty());
+    }
+}
+
+TEST(DistributedRendering, test_workers_render_same_image_as_single_machine)
+{
+    auto scene = get_small_multiple_surfaces_scene();
+
+    auto file_path = get_actual_folder() / "distributed_scene.scene";
+    ASSERT_TRUE(save_scene(file_path, scene));
+
+    render_coordinator coordinator(scene.screen_width, scene.screen_height, 32, 0, 10);
+    ASSERT_TRUE(coordinator.is_listening());
+
+    auto frame = std::async(std::launch::async, [&] { return coordinator.render(); });
+
+    // a worker, that dies with its tile, must not leave a hole in the frame
+    {
+        int socket = connect_to_coordinator("127.0.0.1", coordinator.port());
+        ASSERT_LE(0, socket);
+        ASSERT_TRUE(send_message(socket, tile_message::request));
+
+        auto tile = receive_message(socket);
+        ASSERT_TRUE(tile.has_value());
+        EXPECT_EQ(tile_message::tile, tile->first);
+
+        close_socket(socket);
+    }
+
+    std::vector<std::future<int>> workers;
+    for (int i = 0; i < 3; i++)
+    {
+        workers.push_back(std::async(std::launch::async, [&] {
+            auto worker_scene = load_scene(file_path);
+            return worker_scene.has_value() ? run_render_worker("127.0.0.1", coordinator.port(), *worker_scene, 2) : -1;
+        }));
+    }
+
+    auto pixel = frame.get();
+
+    int rendered_tiles = 0;
+    for (auto& worker : workers)
+    {
+        int tiles = worker.get();
+        EXPECT_LE(0, tiles);
+        rendered_tiles += tiles;
+    }
+
+    EXPECT_EQ(coordinator.tile_count(), rendered_tiles);
+    EXPECT_LE(1, coordinator.reissued_tiles());
+
+    auto [expected_pixel, width, height] = raytrace_scene_through_quasi_interpolation_multithreaded(scene, threads_to_use());
+
+    EXPECT_EQ(expected_pixel, pixel);
+}
@@ -164,3 +164,27 @@ TEST(Nurbs, test_planar_patch_diagonal)
     serialize_as_ppm(get_actual_folder() / file_name, width, height, pixel);
     compare_actual_with_expected_file(file_name);
 }
+
+
+TEST(Nurbs, test_curved_patch_zebra)
+{
+    auto scene = get_curved_patch_scene();
+    scene.screen_width = 128;
+    scene.screen_height = 128;
+
+    surface_analysis_settings settings;
+
+    auto [pixel, width, height] = raytrace_scene_surface_analysis_multithreaded(scene, settings, threads_to_use());
+
+    int white = 0;
+    for (int i = 0; i < pixel.size(); i += 3)
+    {
+        EXPECT_TRUE((pixel[i] == 0 && pixel[i + 1] == 0 && pixel[i + 2] == 0) || (pixel[i] == 255 && pixel[i + 1] == 255 && pixel[i + 2] == 255));
+        white += pixel[i] == 255 ? 1 : 0;
+    }
+
+    EXPECT_LT(100, white);
+
+    auto file_name = GET_TEST_NAME + ".ppm";
+    serialize_as_ppm(get_actual_folder() / file_name, width, height, pixel);
+}
\ No newline at end of file
@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <raytracing/render_scene_description.h>
+#include <raytracing/render_job.h>
+
 #include "scene_setup.h"
 
 
@@ -68,4 +71,598 @@ TEST(MultipleSurfacesScene, test_splitted_plane_scene)
 
     auto file_name = GET_TEST_NAME + ".ppm";
     serialize_as_ppm(get_actual_folder() / file_name, width, height, pixel);
-}
\ No newline at end of file
+}
+
+TEST(MultipleSurfacesScene, test_recursive_depth_zero_matches_primary)
+{
+    auto scene = get_multiple_surfaces_scene();
+    scene.screen_width = 128;
+    scene.screen_height = 128;
+
+    auto [primary_pixel, primary_width, primary_height] = raytrace_scene_through_quasi_interpolation_multithreaded(scene, threads_to_use());
+    auto [pixel, width, height] = raytrace_scene_recursive_multithreaded(scene, threads_to_use());
+
+    EXPECT_EQ(primary_pixel, pixel);
+}
+
+TEST(MultipleSurfacesScene, test_reflective_scene)
+{
+    auto scene = get_reflective_multiple_surfaces_scene();
+    scene.screen_width = 128;
+    scene.screen_height = 128;
+
+    auto [pixel, width, height] = raytrace_scene_recursive_multithreaded(scene, threads_to_use());
+
+    scene.max_depth = 0;
+    auto [primary_pixel, primary_width, primary_height] = raytrace_scene_recursive_multithreaded(scene, threads_to_use());
+
+    EXPECT_NE(primary_pixel, pixel);
+
+    auto file_name = GET_TEST_NAME + ".ppm";
+    serialize_as_ppm(get_actual_folder() / file_name, width, height, pixel);
+}
+TEST(MultipleSurfacesScene, test_trimmed_plane)
+{
+    auto scene = get_multiple_surfaces_scene();
+    scene.screen_width = 256;
+    scene.screen_height = 256;
+
+    // a square hole in the near part of the plane
+    std::vector<v2> outer{ v2{ {0, 0} }, v2{ {1, 0} }, v2{ {1, 1} }, v2{ {0, 1} } };
+    std::vector<v2> hole{ v2{ {0.3, 0.9} }, v2{ {0.7, 0.9} }, v2{ {0.7, 0.98} }, v2{ {0.3, 0.98} } };
+
+    scene.surfaces[2].trim = trim_region({ outer, hole });
+
+    const auto& plane = scene.surfaces[2].mesh;
+
+    v3 in_hole = remove_dimension(evaluate_bezier_surface(plane, 0.5, 0.94)) - scene.origin;
+    v3 on_plane = remove_dimension(evaluate_bezier_surface(plane, 0.5, 0.8)) - scene.origin;
+
+    auto hole_hit = get_ray_surface_intersection(normalize(in_hole), scene, scene.epsilon);
+    auto plane_hit = get_ray_surface_intersection(normalize(on_plane), scene, scene.epsilon);
+
+    EXPECT_TRUE(!hole_hit.has_value() || 2 != std::get<0>(*hole_hit));
+    ASSERT_TRUE(plane_hit.has_value());
+    EXPECT_EQ(2, std::get<0>(*plane_hit));
+
+    auto [pixel, width, height] = raytrace_scene_through_quasi_interpolation_multithreaded(scene, threads_to_use());
+
+    auto file_name = GET_TEST_NAME + ".ppm";
+    serialize_as_ppm(get_actual_folder() / file_name, width, height, pixel);
+}
+
+TEST(MultipleSurfacesScene, test_hybrid_matches_exact)
+{
+    auto scene = get_multiple_splitted_surfaces_scene();
+    scene.screen_width = 128;
+    scene.screen_height = 128;
+
+    // the hole is solved in the window of a leaf, which is only partially trimmed away
+    std::vector<v2> outer{ v2{ {0, 0} }, v2{ {1, 0} }, v2{ {1, 1} }, v2{ {0, 1} } };
+    std::vector<v2> hole{ v2{ {0.3, 0.3} }, v2{ {0.6, 0.3} }, v2{ {0.6, 0.6} }, v2{ {0.3, 0.6} } };
+    scene.surfaces[0].trim = trim_region({ outer, hole });
+
+    hybrid_surfaces_scene_descriptor hybrid(scene);
+
+    EXPECT_EQ(hybrid.leaf_surfaces.size(), hybrid.leaf_u.size());
+    EXPECT_EQ(hybrid.leaf_surfaces.size(), hybrid.leaf_bounds.size());
+
+    intersection_statistics statistics;
+
+    auto exact_pixel = std::get<0>(raytrace_scene_through_quasi_interpolation_multithreaded(scene, threads_to_use()));
+    auto [pixel, width, height] = raytrace_scene_through_quasi_interpolation_multithreaded(hybrid, threads_to_use(), statistics);
+
+    int differing_pixel = 0;
+    for (int i = 0; i < pixel.size(); i += 3)
+    {
+        if (!std::equal(pixel.begin() + i, pixel.begin() + i + 3, exact_pixel.begin() + i))
+        {
+            differing_pixel++;
+        }
+    }
+
+    // the boxes of the leaves bound their surfaces, so the hybrid tracer finds every hit of the exact one
+    EXPECT_EQ(0, differing_pixel);
+    EXPECT_LT(0, statistics.seeded_windows);
+
+    auto file_name = GET_TEST_NAME + ".ppm";
+    serialize_as_ppm(get_actual_folder() / file_name, width, height, pixel);
+}
+
+TEST(MultipleSurfacesScene, test_binned_matches_unbinned)
+{
+    auto scene = get_multiple_patches_scene(4);
+    scene.screen_width = 128;
+    scene.screen_height = 128;
+
+    auto binned = bin_surfaces_to_tiles(scene, 16);
+
+    ASSERT_EQ(64, binned.tiles.size());
+
+    // the far end of the plane is behind no tile, its near end is on the lower edge of the screen
+    EXPECT_TRUE(std::find(binned.tile_surfaces[0].begin(), binned.tile_surfaces[0].end(), 32) == binned.tile_surfaces[0].end());
+    EXPECT_FALSE(binned.tile_surfaces[63].empty());
+
+    intersection_statistics statistics;
+
+    auto unbinned_pixel = std::get<0>(raytrace_scene_through_quasi_interpolation_multithreaded(scene, threads_to_use()));
+    auto [pixel, width, height] = raytrace_scene_through_quasi_interpolation_multithreaded(binned, threads_to_use(), statistics);
+
+    EXPECT_EQ(unbinned_pixel, pixel);
+
+    auto file_name = GET_TEST_NAME + ".ppm";
+    serialize_as_ppm(get_actual_folder() / file_name, width, height, pixel);
+}
+
+TEST(MultipleSurfacesScene, test_mipmapped_plane)
+{
+    auto scene = get_multiple_surfaces_scene();
+    scene.screen_width = 256;
+    scene.screen_height = 256;
+
+    // only the plane
+    scene.surfaces.erase(scene.surfaces.begin(), scene.surfaces.begin() + 2);
+    scene.materials.materials.erase(scene.materials.materials.begin(), scene.materials.materials.begin() + 2);
+
+    // a fine checker on the plane, which reaches far into the distance
+    bitmap_texture checker{ 512, 512, std::vector<color>(512 * 512) };
+    for (int y = 0; y < 512; y++)
+    {
+        for (int x = 0; x < 512; x++)
+        {
+            checker.texels[y * 512 + x] = (x / 8 + y / 8) % 2 ? color{ {255, 210, 80} } : color{ {210, 80, 255} };
+        }
+    }
+
+    std::vector<int> texture_pixel;
+    for (const auto& texel : checker.texels)
+    {
+        texture_pixel.insert(texture_pixel.end(), texel.begin(), texel.end());
+    }
+    serialize_as_ppm(get_actual_folder() / "checker_texture.ppm", 512, 512, texture_pixel);
+
+    auto loaded = load_ppm(get_actual_folder() / "checker_texture.ppm");
+    ASSERT_TRUE(loaded.has_value());
+
+    scene.materials.bitmaps.push_back(*loaded);
+    scene.materials.mipmaps.push_back(mipmapped_texture(*loaded));
+
+    scene.materials.materials[0] = material{ material_kind::bitmap, color{}, color{}, 0, 0 };
+    auto [bitmap_pixel, bitmap_width, bitmap_height] = raytrace_scene_through_quasi_interpolation_multithreaded(scene, threads_to_use());
+
+    scene.materials.materials[0] = material{ material_kind::mipmap, color{}, color{}, 0, 0 };
+    auto [pixel, width, height] = raytrace_scene_through_quasi_interpolation_multithreaded(scene, threads_to_use());
+
+    // the plane aliases without mip mapping, with it the squares smaller than a pixel converge to the mean colour
+    auto variation = [&](const std::vector<int>& image) {
+        double sum = 0;
+        for (int y = 140; y < 176; y++)
+        {
+            for (int x = 1; x < width; x++)
+            {
+                sum += std::abs(image[3 * (y * width + x) + 1] - image[3 * (y * width + x - 1) + 1]);
+            }
+        }
+        return sum;
+    };
+
+    EXPECT_LT(2 * variation(pixel), variation(bitmap_pixel));
+
+    auto file_name = GET_TEST_NAME + ".ppm";
+    serialize_as_ppm(get_actual_folder() / file_name, width, height, pixel);
+}
+
+TEST(MultipleSurfacesScene, test_update_surface_retraces_dirty_tiles)
+{
+    auto base_scene = get_multiple_surfaces_scene();
+    base_scene.screen_width = 128;
+    base_scene.screen_height = 128;
+
+    accelerated_surfaces_scene_descriptor scene(base_scene);
+
+    auto [primary_pixel, primary_width, primary_height] = raytrace_scene_through_quasi_interpolation_multithreaded(base_scene, threads_to_use());
+    auto [pixel, width, height] = raytrace_scene_through_quasi_interpolation_multithreaded(scene, threads_to_use());
+
+    EXPECT_EQ(primary_pixel, pixel);
+
+    varmesh<4> moved = scene.surfaces[1].mesh;
+    moved[1][1] = moved[1][1] + v4{{0.2, 0.3, -0.2, 0}};
+
+    auto tiles = update_surface(scene, 1, moved, 16);
+
+    EXPECT_LT(0, tiles.size());
+    EXPECT_GT(64, tiles.size());
+
+    raytrace_scene_tiles_multithreaded(pixel, tiles, scene, threads_to_use());
+
+    base_scene.surfaces[1].mesh = moved;
+
+    auto [updated_pixel, updated_width, updated_height] = raytrace_scene_through_quasi_interpolation_multithreaded(base_scene, threads_to_use());
+
+    EXPECT_NE(primary_pixel, updated_pixel);
+    EXPECT_EQ(updated_pixel, pixel);
+}
+
+TEST(MultipleSurfacesScene, test_render_scene_description)
+{
+    std::string error;
+    auto description = load_scene_description(std::filesystem::path(__FILE__).parent_path().parent_path() / "3d_models" / "curved_patch.txt", error);
+
+    ASSERT_TRUE(description.has_value()) << error;
+
+    render_report report;
+    auto pixel = render_scene_description(*description, report).pixel;
+
+    EXPECT_EQ("binned", report.renderer);
+    EXPECT_TRUE(report.statistics.has_value());
+
+    auto scene = get_curved_patch_scene();
+
+    auto [expected_pixel, width, height] = raytrace_scene_through_quasi_interpolation_multithreaded(scene, threads_to_use());
+
+    EXPECT_EQ(expected_pixel, pixel);
+
+    // a failed write of the image is reported
+    description->output = get_actual_folder() / "missing_folder" / "curved_patch.ppm";
+
+    rendered_frame frame;
+    frame.pixel = pixel;
+
+    EXPECT_EQ(description->output.string(), write_rendered_frame(*description, frame));
+
+    description->scene.max_depth = 1;
+
+    render_report recursive_report;
+    render_scene_description(*description, recursive_report);
+
+    EXPECT_EQ("recursive", recursive_report.renderer);
+    EXPECT_TRUE(recursive_report.statistics.has_value());
+}
+
+TEST(MultipleSurfacesScene, test_aovs_of_the_same_pass)
+{
+    auto scene = get_multiple_surfaces_scene();
+    scene.screen_width = 128;
+    scene.screen_height = 128;
+
+    aov_selection selection{ true, true, true, true, true };
+
+    aov_buffers aovs(scene.screen_width, scene.screen_height, selection);
+    intersection_statistics statistics;
+
+    auto [pixel, width, height] = raytrace_scene_through_quasi_interpolation_multithreaded(scene, threads_to_use(), statistics, aovs);
+    auto [expected_pixel, expected_width, expected_height] = raytrace_scene_through_quasi_interpolation_multithreaded(scene, threads_to_use());
+
+    EXPECT_EQ(expected_pixel, pixel);
+
+    screen_geometry screen(scene.screen_width, scene.screen_height, scene.field_of_view, 0, 0, 0);
+
+    long long cost = 0;
+    int hits = 0;
+
+    for (int index = 0; index < width * height; index++)
+    {
+        cost += aovs.cost[index];
+
+        auto intersection = get_ray_surface_intersection(normalize(screen.get_corresponding_ray(index % width, index / width)), scene, scene.epsilon);
+
+        if (!intersection.has_value())
+        {
+            EXPECT_EQ(-1, aovs.object_id[index]);
+            EXPECT_TRUE(std::isinf(aovs.depth[index]));
+            continue;
+        }
+
+        hits++;
+
+        auto [object, distance_vector, normale, uv] = *intersection;
+
+        EXPECT_EQ(object, aovs.object_id[index]);
+        EXPECT_FLOAT_EQ(float(length(distance_vector)), aovs.depth[index]);
+        EXPECT_NEAR(1, std::hypot(aovs.normal[0][index], aovs.normal[1][index], aovs.normal[2][index]), 1E-6);
+        EXPECT_FLOAT_EQ(float(uv[0]), aovs.uv[0][index]);
+        EXPECT_FLOAT_EQ(float(uv[1]), aovs.uv[1][index]);
+    }
+
+    EXPECT_LT(0, hits);
+    EXPECT_EQ(statistics.clipping_steps + statistics.newton_iterations, cost);
+
+    // binning changes the cost, but not the hits
+    auto binned = bin_surfaces_to_tiles(scene, 16);
+
+    aov_buffers binned_aovs(scene.screen_width, scene.screen_height, aov_selection{ true, false, false, true, false });
+
+    auto [binned_pixel, binned_width, binned_height] = raytrace_scene_through_quasi_interpolation_multithreaded(binned, threads_to_use(), statistics, binned_aovs);
+
+    EXPECT_EQ(expected_pixel, binned_pixel);
+    EXPECT_EQ(aovs.object_id, binned_aovs.object_id);
+    EXPECT_EQ(aovs.depth, binned_aovs.depth);
+    EXPECT_TRUE(binned_aovs.normal[0].empty());
+    EXPECT_TRUE(binned_aovs.cost.empty());
+}
+
+TEST(MultipleSurfacesScene, test_tone_mapped_hdr_matches_8_bit)
+{
+    auto scene = get_multiple_surfaces_scene();
+    scene.screen_width = 128;
+    scene.screen_height = 128;
+
+    auto binned = bin_surfaces_to_tiles(scene, 16);
+
+    intersection_statistics statistics;
+
+    auto image = raytrace_scene_hdr_multithreaded(binned, threads_to_use(), statistics);
+
+    auto [expected_pixel, width, height] = raytrace_scene_through_quasi_interpolation_multithreaded(scene, threads_to_use());
+
+    auto pixel = tone_map(image);
+
+    ASSERT_EQ(expected_pixel.size(), pixel.size());
+
+    // float rounding may only move values on the half
+    int different = 0;
+    for (int i = 0; i < pixel.size(); i++)
+    {
+        EXPECT_NEAR(expected_pixel[i], pixel[i], 1);
+        different += expected_pixel[i] != pixel[i];
+    }
+
+    EXPECT_GT(pixel.size() / 1000, different);
+
+    // a darker exposure without rendering again
+    auto darker = tone_map(image, tone_mapping{ 0.5 });
+
+    for (int i = 0; i < pixel.size(); i++)
+    {
+        EXPECT_NEAR(0.5 * expected_pixel[i], darker[i], 1);
+    }
+}
+
+TEST(MultipleSurfacesScene, test_hints_keep_closest_hit)
+{
+    auto scene = get_multiple_surfaces_scene();
+    scene.screen_width = 96;
+    scene.screen_height = 96;
+
+    auto binned = bin_surfaces_to_tiles(scene, 16);
+    supersampling_state state(binned);
+
+    screen_geometry screen(scene.screen_width, scene.screen_height, scene.field_of_view, 0, 0, 0);
+
+    std::vector<std::vector<int>> hint_lists{ {}, { 2 }, { 1, 0 }, { 2, 1, 0 } };
+
+    for (int y = 0; y < scene.screen_height; y += 3)
+    {
+        for (int x = 0; x < scene.screen_width; x += 3)
+        {
+            v2 point = stratified_sample(x, y, x + y, 4);
+
+            auto ray = normalize(screen.get_corresponding_ray(x, y, point[0], point[1]));
+
+            int tile = (y / 16) * ((scene.screen_width + 15) / 16) + x / 16;
+
+            auto expected = get_ray_surface_intersection(ray, scene, scene.epsilon);
+            auto hinted = get_ray_surface_intersection(ray, tile, hint_lists[(x + y) % hint_lists.size()], binned, state.surface_bounds, scene.epsilon);
+
+            ASSERT_EQ(expected.has_value(), hinted.has_value());
+
+            if (expected.has_value())
+            {
+                EXPECT_EQ(std::get<0>(*expected), std::get<0>(*hinted));
+                EXPECT_EQ(std::get<1>(*expected), std::get<1>(*hinted));
+            }
+        }
+    }
+}
+
+TEST(MultipleSurfacesScene, test_adaptive_supersampling)
+{
+    auto scene = get_multiple_surfaces_scene();
+    scene.screen_width = 96;
+    scene.screen_height = 96;
+
+    auto binned = bin_surfaces_to_tiles(scene, 16);
+
+    supersampling_settings settings;
+    settings.strata = 4;
+    settings.max_samples = 16;
+
+    intersection_statistics statistics;
+
+    auto image = raytrace_scene_supersampled_multithreaded(binned, settings, threads_to_use(), statistics);
+
+    // the stratified samples of every pixel as reference
+    hdr_image reference(scene.screen_width, scene.screen_height);
+    screen_geometry screen(scene.screen_width, scene.screen_height, scene.field_of_view, 0, 0, 0);
+
+    for (int y = 0; y < scene.screen_height; y++)
+    {
+        for (int x = 0; x < scene.screen_width; x++)
+        {
+            for (int sample = 0; sample < 16; sample++)
+            {
+                v2 point = stratified_sample(x, y, sample, 4);
+
+                auto intersection = get_ray_surface_intersection(normalize(screen.get_corresponding_ray(x, y, point[0], point[1])), scene, scene.epsilon);
+
+                reference.add_sample(scene.screen_width * y + x, intersection.has_value() ? (1. / 255) * shade_intersection(*intersection, scene) : v3{ 0, 0, 0 });
+            }
+        }
+    }
+
+    auto [centre_pixel, width, height] = raytrace_scene_through_quasi_interpolation_multithreaded(scene, threads_to_use());
+
+    double samples = 0, adaptive_error = 0, centre_error = 0;
+    int refined = 0;
+
+    for (int index = 0; index < width * height; index++)
+    {
+        samples += image.weights[index];
+        refined += 1 < image.weights[index];
+
+        EXPECT_LE(image.weights[index], settings.max_samples);
+
+        v3 expected = reference.resolve(index);
+
+        for (int c = 0; c < 3; c++)
+        {
+            adaptive_error += std::abs(image.resolve(index)[c] - expected[c]);
+            centre_error += std::abs(centre_pixel[3 * index + c] / 255. - expected[c]);
+        }
+    }
+
+    // only the edges of the surfaces and of the checkers are refined
+    EXPECT_LT(0, refined);
+    EXPECT_GT(0.5 * width * height, refined);
+    EXPECT_GT(8, samples / (width * height));
+    EXPECT_GT(0.5 * centre_error, adaptive_error);
+}
+
+TEST(MultipleSurfacesScene, test_clipping_polls_cancellation)
+{
+    auto scene = get_multiple_surfaces_scene();
+
+    screen_geometry screen(scene.screen_width, scene.screen_height, scene.field_of_view, 0, 0, 0);
+
+    auto clipping_steps = [&] {
+        thread_intersection_statistics() = intersection_statistics{};
+
+        for (int x = 0; x < scene.screen_width; x += 4)
+        {
+            get_ray_surface_intersection(normalize(screen.get_corresponding_ray(x, scene.screen_height / 2)), scene, scene.epsilon);
+        }
+
+        return thread_intersection_statistics().clipping_steps;
+    };
+
+    long long uncancelled = clipping_steps();
+
+    cancellation_token token;
+    token.cancel();
+
+    long long cancelled;
+
+    {
+        scoped_cancellation_token scope(&token);
+
+        cancelled = clipping_steps();
+    }
+
+    EXPECT_EQ(nullptr, thread_cancellation_token());
+    EXPECT_GT(uncancelled, cancelled);
+}
+
+TEST(MultipleSurfacesScene, test_render_until_cancelled)
+{
+    auto scene = get_multiple_surfaces_scene();
+    scene.screen_width = 96;
+    scene.screen_height = 96;
+
+    auto binned = bin_surfaces_to_tiles(scene, 16);
+
+    supersampling_settings settings;
+
+    intersection_statistics statistics;
+
+    auto start = std::chrono::steady_clock::now();
+
+    auto image = raytrace_scene_supersampled_multithreaded(binned, settings, threads_to_use(), statistics);
+
+    auto duration = std::chrono::steady_clock::now() - start;
+
+    // without cancellation the same image
+    cancellation_token token;
+
+    auto render = raytrace_scene_until_cancelled_multithreaded(binned, settings, token, threads_to_use(), statistics);
+
+    EXPECT_TRUE(render.complete);
+    EXPECT_EQ(image.weights, render.image.weights);
+    EXPECT_EQ(image.channels, render.image.channels);
+    EXPECT_EQ(std::vector<unsigned char>(render.coverage.size(), 1), render.coverage);
+
+    // nothing is traced after the deadline
+    render = raytrace_scene_until_deadline_multithreaded(binned, settings, std::chrono::steady_clock::now(), threads_to_use(), statistics);
+
+    EXPECT_FALSE(render.complete);
+    EXPECT_EQ(std::vector<unsigned char>(render.coverage.size(), 0), render.coverage);
+    EXPECT_EQ(std::vector<float>(render.image.weights.size(), 0), render.image.weights);
+
+    // the tiles at the centre come first, the covered pixels have at least their centre sample
+    render = raytrace_scene_until_deadline_multithreaded(binned, settings, std::chrono::steady_clock::now() + duration / 4, threads_to_use(), statistics);
+
+    int covered = 0;
+
+    for (size_t index = 0; index < render.coverage.size(); index++)
+    {
+        covered += render.coverage[index];
+
+        EXPECT_EQ(0 < render.coverage[index], 1 <= render.image.weights[index]);
+    }
+
+    // whole tiles are covered, no refinement pass starts before all tiles have their centre samples
+    EXPECT_EQ(0, covered % (16 * 16));
+
+    if (covered < int(render.coverage.size()))
+    {
+        EXPECT_EQ(0, render.passes);
+    }
+
+    if (0 < covered)
+    {
+        EXPECT_EQ(1, render.coverage[scene.screen_width * (scene.screen_height / 2) + scene.screen_width / 2]);
+    }
+}
+
+TEST(MultipleSurfacesScene, test_render_job)
+{
+    auto scene = get_multiple_surfaces_scene();
+    scene.screen_width = 96;
+    scene.screen_height = 96;
+
+    auto binned = bin_surfaces_to_tiles(scene, 16);
+
+    auto expected = raytrace_scene_through_quasi_interpolation_multithreaded(scene, threads_to_use());
+
+    auto job = start_render_job(binned, threads_to_use());
+
+    auto result = job.result.get();
+
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(std::get<0>(expected), std::get<0>(*result));
+    EXPECT_EQ(binned.tiles.size(), job.progress->completed_units());
+    EXPECT_EQ(1, job.progress->fraction());
+    EXPECT_EQ(0, job.progress->remaining_seconds());
+
+    // the tracers of raytrace_scene_multithreaded, pixel by pixel
+    auto trace = [](std::vector<int>::iterator pixel, v3 ray, multiple_surfaces_scene_descriptor& scene) {
+        trace_ray(pixel, ray, scene);
+    };
+
+    auto pixel_job = start_render_job<multiple_surfaces_scene_descriptor>(scene, trace, threads_to_use());
+
+    result = pixel_job.result.get();
+
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(std::get<0>(expected), std::get<0>(*result));
+    EXPECT_EQ(scene.screen_width * scene.screen_height, pixel_job.progress->completed_units());
+}
+
+TEST(MultipleSurfacesScene, test_cancel_render_job)
+{
+    auto scene = get_multiple_surfaces_scene();
+
+    auto binned = bin_surfaces_to_tiles(scene, 16);
+
+    auto job = start_render_job(binned, threads_to_use());
+
+    while (0 == job.progress->completed_units())
+    {
+        std::this_thread::yield();
+    }
+
+    job.cancel();
+
+    EXPECT_FALSE(job.result.get().has_value());
+    EXPECT_GT(job.progress->total_units(), job.progress->completed_units());
+    EXPECT_TRUE(job.progress->remaining_seconds().has_value());
+}
@@ -0,0 +1,222 @@
+#include "render_coordinator.h"
+#include "tile_protocol.h"
+
+#include <algorithm>
+#include <thread>
+
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+    // the results of larger tiles couldn't be received
+    bool is_valid_tile_size(int tile_size)
+    {
+        return 1 <= tile_size && tile_size <= maximal_tile_size;
+    }
+}
+
+render_coordinator::render_coordinator(int screen_width, int screen_height, int tile_size, int port, int timeout_seconds) :
+    screen_width(screen_width), screen_height(screen_height), timeout_seconds(timeout_seconds),
+    tiles(is_valid_tile_size(tile_size) ? screen_tiles_overlapping(screen_width, screen_height, tile_size, 0, 0, screen_width - 1, screen_height - 1) : std::vector<screen_tile>{}),
+    pixel(3 * screen_width * screen_height, 0), finished(tiles.size(), false)
+{
+    if (!is_valid_tile_size(tile_size))
+    {
+        return;
+    }
+
+    for (int i = 0; i < tiles.size(); i++)
+    {
+        pending.push_back(i);
+    }
+
+    listening_socket = socket(AF_INET, SOCK_STREAM, 0);
+
+    if (listening_socket < 0)
+    {
+        return;
+    }
+
+    int reuse = 1;
+    setsockopt(listening_socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+
+    socklen_t length = sizeof(address);
+
+    if (0 != bind(listening_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address))
+        || 0 != listen(listening_socket, 16)
+        || 0 != getsockname(listening_socket, reinterpret_cast<sockaddr*>(&address), &length))
+    {
+        close(listening_socket);
+        listening_socket = -1;
+        return;
+    }
+
+    listening_port = ntohs(address.sin_port);
+}
+
+render_coordinator::~render_coordinator()
+{
+    if (0 <= listening_socket)
+    {
+        close(listening_socket);
+    }
+}
+
+std::vector<int> render_coordinator::render()
+{
+    if (!is_listening())
+    {
+        return {};
+    }
+
+    std::vector<std::thread> connections;
+    std::vector<int> sockets;
+
+    while (true)
+    {
+        {
+            std::lock_guard<std::mutex> guard(m);
+
+            if (finished_count == tiles.size())
+            {
+                break;
+            }
+        }
+
+        // wakes up regularly to notice the completion of the frame
+        pollfd listening{ listening_socket, POLLIN, 0 };
+
+        if (0 < poll(&listening, 1, 100))
+        {
+            int s = accept(listening_socket, nullptr, nullptr);
+
+            if (0 <= s)
+            {
+                // a stalled worker can neither block the receive of its result nor the send of its tile
+                configure_socket(s, timeout_seconds);
+
+                sockets.push_back(s);
+                connections.emplace_back([this, s] { serve_worker(s); });
+            }
+        }
+    }
+
+    // releases connections still waiting for a request
+    for (int s : sockets)
+    {
+        shutdown(s, SHUT_RDWR);
+    }
+
+    for (auto& connection : connections)
+    {
+        connection.join();
+    }
+
+    for (int s : sockets)
+    {
+        close(s);
+    }
+
+    return pixel;
+}
+
+void render_coordinator::serve_worker(int socket)
+{
+    while (true)
+    {
+        auto request = receive_message(socket);
+
+        if (!request.has_value() || tile_message::request != request->first)
+        {
+            return;
+        }
+
+        int tile = take_tile();
+
+        if (tile < 0)
+        {
+            send_message(socket, tile_message::done);
+            return;
+        }
+
+        const screen_tile& t = tiles[tile];
+
+        auto result = send_message(socket, tile_message::tile, { tile, t.x_begin, t.y_begin, t.x_end, t.y_end }) ? receive_message(socket) : std::nullopt;
+
+        size_t expected_size = 1 + 3 * (t.x_end - t.x_begin) * (t.y_end - t.y_begin);
+
+        if (!result.has_value() || tile_message::result != result->first || expected_size != result->second.size() || tile != result->second[0])
+        {
+            return_tile(tile);
+            return;
+        }
+
+        store_result(tile, result->second);
+    }
+}
+
+int render_coordinator::take_tile()
+{
+    std::unique_lock<std::mutex> lock(m);
+
+    changed.wait(lock, [this] { return !pending.empty() || finished_count == tiles.size(); });
+
+    if (pending.empty())
+    {
+        return -1;
+    }
+
+    int tile = pending.front();
+    pending.pop_front();
+
+    return tile;
+}
+
+void render_coordinator::return_tile(int tile)
+{
+    std::lock_guard<std::mutex> guard(m);
+
+    if (!finished[tile])
+    {
+        pending.push_back(tile);
+        reissued++;
+    }
+
+    changed.notify_all();
+}
+
+void render_coordinator::store_result(int tile, const std::vector<std::int32_t>& payload)
+{
+    const screen_tile& t = tiles[tile];
+
+    std::lock_guard<std::mutex> guard(m);
+
+    if (finished[tile])
+    {
+        return;
+    }
+
+    auto source = payload.begin() + 1;
+
+    for (int y = t.y_begin; y < t.y_end; y++)
+    {
+        int row_size = 3 * (t.x_end - t.x_begin);
+
+        std::copy(source, source + row_size, pixel.begin() + 3 * (screen_width * y + t.x_begin));
+
+        source += row_size;
+    }
+
+    finished[tile] = true;
+    finished_count++;
+
+    changed.notify_all();
+}
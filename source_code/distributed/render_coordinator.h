@@ -0,0 +1,60 @@
+#ifndef render_coordinator_h
+#define render_coordinator_h
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include <graphics/screen_geometry.h>
+
+// splits a frame into tiles and serves them to the workers connecting over tcp, one tile per request, so faster
+// workers get more tiles; the tile of a worker, that disconnects or doesn't answer within the timeout, is issued again
+class render_coordinator
+{
+public:
+    // listens on all interfaces; port 0 picks a free port, see port(); tile_size from 1 to maximal_tile_size
+    render_coordinator(int screen_width, int screen_height, int tile_size = 32, int port = 0, int timeout_seconds = 60);
+    ~render_coordinator();
+
+    render_coordinator(const render_coordinator&) = delete;
+    render_coordinator& operator=(const render_coordinator&) = delete;
+
+    // false, if the socket couldn't be opened or the tile size is out of range
+    bool is_listening() const { return 0 <= listening_socket; }
+    int port() const { return listening_port; }
+
+    // blocks, until the results of all tiles are back, and returns the frame with three channels per pixel; empty, if
+    // the coordinator isn't listening
+    std::vector<int> render();
+
+    int tile_count() const { return tiles.size(); }
+    int reissued_tiles() const { return reissued; }
+
+private:
+    void serve_worker(int socket);
+
+    // the next tile to issue, waits while all remaining tiles are issued; -1 when the frame is complete
+    int take_tile();
+    void return_tile(int tile);
+    void store_result(int tile, const std::vector<std::int32_t>& payload);
+
+    int screen_width;
+    int screen_height;
+    int timeout_seconds;
+
+    int listening_socket = -1;
+    int listening_port = 0;
+
+    std::vector<screen_tile> tiles;
+    std::vector<int> pixel;
+
+    std::mutex m;
+    std::condition_variable changed;
+    std::deque<int> pending;
+    std::vector<bool> finished;
+    int finished_count = 0;
+    int reissued = 0;
+};
+
+#endif
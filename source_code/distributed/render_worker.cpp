@@ -0,0 +1,73 @@
+#include "render_worker.h"
+#include "tile_protocol.h"
+
+#include <raytracing/raytrace_mesh_through_quasi_interpolation.h>
+#include <raytracing/render_threads.h>
+#include <raytracing/synciterator.h>
+
+void raytrace_scene_tile(std::vector<int>& tile_pixel, const screen_tile& tile, multiple_surfaces_scene_descriptor& scene, int threadcount)
+{
+    int tile_width = tile.x_end - tile.x_begin;
+    int tile_height = tile.y_end - tile.y_begin;
+
+    tile_pixel.assign(3 * tile_width * tile_height, 0);
+
+    synciterator iter(tile_width, tile_height);
+
+    trace_multithreaded(threadcount, [&] {
+        screen_geometry screen(scene.screen_width, scene.screen_height, scene.field_of_view, 0, 0, 0);
+
+        std::pair<int, int> xy;
+
+        while ((xy = iter.next()) != std::make_pair(-1, -1))
+        {
+            auto ray = normalize(screen.get_corresponding_ray(tile.x_begin + xy.first, tile.y_begin + xy.second));
+
+            trace_ray(tile_pixel.begin() + 3 * (tile_width * xy.second + xy.first), ray, scene);
+        }
+    });
+}
+
+int run_render_worker(const std::string& host, int port, multiple_surfaces_scene_descriptor& scene, int threadcount)
+{
+    int socket = connect_to_coordinator(host, port);
+
+    if (socket < 0)
+    {
+        return -1;
+    }
+
+    int rendered_tiles = 0;
+
+    std::vector<int> tile_pixel;
+
+    while (send_message(socket, tile_message::request))
+    {
+        auto message = receive_message(socket);
+
+        if (!message.has_value() || tile_message::tile != message->first || 5 != message->second.size())
+        {
+            break;
+        }
+
+        const auto& payload = message->second;
+
+        screen_tile tile{ payload[1], payload[2], payload[3], payload[4] };
+
+        raytrace_scene_tile(tile_pixel, tile, scene, threadcount);
+
+        std::vector<std::int32_t> result{ payload[0] };
+        result.insert(result.end(), tile_pixel.begin(), tile_pixel.end());
+
+        if (!send_message(socket, tile_message::result, result))
+        {
+            break;
+        }
+
+        rendered_tiles++;
+    }
+
+    close_socket(socket);
+
+    return rendered_tiles;
+}
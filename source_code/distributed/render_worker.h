@@ -0,0 +1,16 @@
+#ifndef render_worker_h
+#define render_worker_h
+
+#include <string>
+#include <vector>
+
+#include <raytracing/scene_descriptor.h>
+
+// traces the camera rays of the pixels of tile into tile_pixel, row by row, with threadcount threads
+void raytrace_scene_tile(std::vector<int>& tile_pixel, const screen_tile& tile, multiple_surfaces_scene_descriptor& scene, int threadcount);
+
+// asks the coordinator for tiles of scene and sends back their pixels, until it is done; returns the number of
+// rendered tiles, -1 if the coordinator can't be reached
+int run_render_worker(const std::string& host, int port, multiple_surfaces_scene_descriptor& scene, int threadcount);
+
+#endif
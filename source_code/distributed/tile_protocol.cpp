@@ -0,0 +1,162 @@
+#include "tile_protocol.h"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace
+{
+    // the pixels of the largest tile and its index
+    const std::int32_t maximal_payload_size = 3 * maximal_tile_size * maximal_tile_size + 1;
+
+    // linux suppresses SIGPIPE per send, the bsds per socket, see configure_socket
+#ifdef MSG_NOSIGNAL
+    const int send_flags = MSG_NOSIGNAL;
+#else
+    const int send_flags = 0;
+#endif
+
+    bool send_all(int socket, const char* data, size_t size)
+    {
+        while (0 < size)
+        {
+            ssize_t sent = send(socket, data, size, send_flags);
+
+            if (sent <= 0)
+            {
+                return false;
+            }
+
+            data += sent;
+            size -= sent;
+        }
+
+        return true;
+    }
+
+    bool receive_all(int socket, char* data, size_t size)
+    {
+        while (0 < size)
+        {
+            ssize_t received = recv(socket, data, size, 0);
+
+            if (received <= 0)
+            {
+                return false;
+            }
+
+            data += received;
+            size -= received;
+        }
+
+        return true;
+    }
+}
+
+bool send_message(int socket, tile_message type, const std::vector<std::int32_t>& payload)
+{
+    std::vector<std::uint32_t> words;
+    words.reserve(payload.size() + 2);
+
+    words.push_back(htonl(static_cast<std::uint32_t>(type)));
+    words.push_back(htonl(static_cast<std::uint32_t>(payload.size())));
+
+    for (auto value : payload)
+    {
+        words.push_back(htonl(static_cast<std::uint32_t>(value)));
+    }
+
+    return send_all(socket, reinterpret_cast<const char*>(words.data()), words.size() * sizeof(std::uint32_t));
+}
+
+std::optional<std::pair<tile_message, std::vector<std::int32_t>>> receive_message(int socket)
+{
+    std::uint32_t header[2];
+
+    if (!receive_all(socket, reinterpret_cast<char*>(header), sizeof(header)))
+    {
+        return {};
+    }
+
+    auto type = static_cast<tile_message>(ntohl(header[0]));
+    auto size = static_cast<std::int32_t>(ntohl(header[1]));
+
+    if (size < 0 || maximal_payload_size < size)
+    {
+        return {};
+    }
+
+    std::vector<std::int32_t> payload(size);
+
+    if (!receive_all(socket, reinterpret_cast<char*>(payload.data()), size * sizeof(std::int32_t)))
+    {
+        return {};
+    }
+
+    for (auto& value : payload)
+    {
+        value = static_cast<std::int32_t>(ntohl(static_cast<std::uint32_t>(value)));
+    }
+
+    return std::make_pair(type, std::move(payload));
+}
+
+int connect_to_coordinator(const std::string& host, int port)
+{
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo* addresses = nullptr;
+
+    if (0 != getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses))
+    {
+        return -1;
+    }
+
+    int result = -1;
+
+    for (addrinfo* address = addresses; address != nullptr && result < 0; address = address->ai_next)
+    {
+        int s = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+
+        if (s < 0)
+        {
+            continue;
+        }
+
+        if (0 == connect(s, address->ai_addr, address->ai_addrlen))
+        {
+            configure_socket(s, 0);
+            result = s;
+        }
+        else
+        {
+            close(s);
+        }
+    }
+
+    freeaddrinfo(addresses);
+
+    return result;
+}
+
+void configure_socket(int socket, int timeout_seconds)
+{
+    timeval timeout{ timeout_seconds, 0 };
+    setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+#ifdef SO_NOSIGPIPE
+    int no_sigpipe = 1;
+    setsockopt(socket, SOL_SOCKET, SO_NOSIGPIPE, &no_sigpipe, sizeof(no_sigpipe));
+#endif
+}
+
+void close_socket(int socket)
+{
+    close(socket);
+}
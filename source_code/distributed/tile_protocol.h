@@ -0,0 +1,32 @@
+#ifndef tile_protocol_h
+#define tile_protocol_h
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// the worker asks for a tile with a request, the coordinator answers with a tile or with done; a result carries the
+// index of the tile and its pixels row by row, three channels each
+enum class tile_message : std::int32_t { request = 1, tile = 2, result = 3, done = 4 };
+
+// results of larger tiles are rejected as malformed
+const int maximal_tile_size = 1024;
+
+// a message is its type, the number of payload integers and the payload, all as 32 bit integers in network byte order
+bool send_message(int socket, tile_message type, const std::vector<std::int32_t>& payload = {});
+
+// empty, if the connection is closed, times out or the message is malformed
+std::optional<std::pair<tile_message, std::vector<std::int32_t>>> receive_message(int socket);
+
+// connected tcp socket, -1 on failure
+int connect_to_coordinator(const std::string& host, int port);
+
+// sending and receiving on the socket fail after timeout_seconds without progress, 0 waits forever; a closed peer
+// fails the send instead of raising SIGPIPE
+void configure_socket(int socket, int timeout_seconds);
+
+void close_socket(int socket);
+
+#endif
@@ -1,9 +1,13 @@
 #include <fstream>
 #include <sstream>
+#include <cctype>
+#include <algorithm>
+#include <bit>
+#include <functional>
 
 #include "file_io.h"
 
-void serialize_as_ppm(const std::filesystem::path &file_path, int image_width, int image_height, const std::vector<int> &pixel)
+bool serialize_as_ppm(const std::filesystem::path &file_path, int image_width, int image_height, const std::vector<int> &pixel)
 {
     std::ofstream open_file(file_path, std::ofstream::trunc);
     
@@ -13,6 +17,10 @@ void serialize_as_ppm(const std::filesystem::path &file_path, int image_width, i
     {
         open_file << *current_pixel << " ";
     }
+
+    open_file.close();
+
+    return bool(open_file);
 }
 
 std::pair<std::vector<v3>, std::vector<std::array<int, 3>>> parse_wavefront(std::string file_path)
@@ -65,3 +73,196 @@ std::string read_text_file(const std::filesystem::path& file)
     return "";
 }
 
+
+namespace
+{
+    // larger images than 32768 x 32768 are malformed
+    const int maximal_ppm_size = 32768;
+
+    // skips whitespace and comments between the tokens of a ppm header
+    void skip_ppm_separators(std::istream& stream)
+    {
+        while (stream.good())
+        {
+            int c = stream.peek();
+
+            if ('#' == c)
+            {
+                std::string comment;
+                std::getline(stream, comment);
+            }
+            else if (std::isspace(c))
+            {
+                stream.get();
+            }
+            else
+            {
+                return;
+            }
+        }
+    }
+}
+
+std::optional<bitmap_texture> load_ppm(const std::filesystem::path& file_path)
+{
+    std::ifstream stream(file_path, std::ifstream::binary);
+
+    std::string magic;
+    int width, height, max_value;
+
+    stream >> magic;
+    skip_ppm_separators(stream);
+    stream >> width;
+    skip_ppm_separators(stream);
+    stream >> height;
+    skip_ppm_separators(stream);
+    stream >> max_value;
+
+    if (!stream || ("P3" != magic && "P6" != magic) || width <= 0 || height <= 0 || maximal_ppm_size < width || maximal_ppm_size < height
+        || max_value <= 0 || 255 < max_value)
+    {
+        return std::nullopt;
+    }
+
+    bitmap_texture bitmap{ width, height, std::vector<color>(size_t(width) * height) };
+
+    if ("P6" == magic)
+    {
+        // exactly one whitespace character separates the header from the binary data
+        stream.get();
+
+        std::vector<char> data(3 * bitmap.texels.size());
+
+        if (!stream.read(data.data(), data.size()))
+        {
+            return std::nullopt;
+        }
+
+        for (size_t i = 0; i < bitmap.texels.size(); i++)
+        {
+            for (int c = 0; c < 3; c++)
+            {
+                bitmap.texels[i][c] = std::min(int((unsigned char)data[3 * i + c]), max_value) * 255 / max_value;
+            }
+        }
+    }
+    else
+    {
+        for (auto& texel : bitmap.texels)
+        {
+            for (int c = 0; c < 3; c++)
+            {
+                // a number followed by whitespace or the end of the file
+                if (!(stream >> texel[c]) || (EOF != stream.peek() && !std::isspace(stream.peek())))
+                {
+                    return std::nullopt;
+                }
+
+                texel[c] = std::clamp(texel[c], 0, max_value) * 255 / max_value;
+            }
+        }
+    }
+
+    return bitmap;
+}
+
+namespace
+{
+    float swap_bytes(float value)
+    {
+        auto bytes = std::bit_cast<std::array<char, sizeof(float)>>(value);
+        std::reverse(bytes.begin(), bytes.end());
+
+        return std::bit_cast<float>(bytes);
+    }
+
+    float little_endian(float value)
+    {
+        return std::endian::little == std::endian::native ? value : swap_bytes(value);
+    }
+
+    bool write_pfm(const std::filesystem::path& file_path, int image_width, int image_height, int channel_count, const std::function<float(int, int)>& value)
+    {
+        std::ofstream stream(file_path, std::ofstream::binary | std::ofstream::trunc);
+
+        // the negative scale marks little endian data
+        stream << (3 == channel_count ? "PF" : "Pf") << "\n" << image_width << " " << image_height << "\n-1.0\n";
+
+        std::vector<float> row(channel_count * image_width);
+
+        for (int y = image_height - 1; 0 <= y; y--)
+        {
+            for (int x = 0; x < image_width; x++)
+            {
+                for (int c = 0; c < channel_count; c++)
+                {
+                    row[channel_count * x + c] = little_endian(value(image_width * y + x, c));
+                }
+            }
+
+            stream.write(reinterpret_cast<const char*>(row.data()), row.size() * sizeof(float));
+        }
+
+        return bool(stream);
+    }
+}
+
+bool serialize_as_pfm(const std::filesystem::path& file_path, const hdr_image& image)
+{
+    return write_pfm(file_path, image.width, image.height, 3, [&](int index, int c) { return float(image.resolve(index)[c]); });
+}
+
+bool serialize_as_pfm(const std::filesystem::path& file_path, int image_width, int image_height, const std::vector<float>& channel)
+{
+    return write_pfm(file_path, image_width, image_height, 1, [&](int index, int) { return channel[index]; });
+}
+
+std::optional<hdr_image> load_pfm(const std::filesystem::path& file_path)
+{
+    std::ifstream stream(file_path, std::ifstream::binary);
+
+    std::string magic;
+    int width, height;
+    double scale;
+
+    stream >> magic >> width >> height >> scale;
+
+    if (!stream || ("PF" != magic && "Pf" != magic) || width <= 0 || height <= 0 || 0 == scale)
+    {
+        return std::nullopt;
+    }
+
+    // exactly one whitespace character separates the header from the data
+    stream.get();
+
+    int channel_count = "PF" == magic ? 3 : 1;
+    bool swap = (scale < 0) != (std::endian::little == std::endian::native);
+
+    hdr_image image(width, height);
+
+    std::vector<float> row(channel_count * width);
+
+    for (int y = height - 1; 0 <= y; y--)
+    {
+        if (!stream.read(reinterpret_cast<char*>(row.data()), row.size() * sizeof(float)))
+        {
+            return std::nullopt;
+        }
+
+        for (int x = 0; x < width; x++)
+        {
+            v3 radiance;
+
+            for (int c = 0; c < 3; c++)
+            {
+                float value = row[channel_count * x + (3 == channel_count ? c : 0)];
+
+                radiance[c] = swap ? swap_bytes(value) : value;
+            }
+
+            image.add_sample(width * y + x, radiance);
+        }
+    }
+
+    return image;
+}
@@ -3,13 +3,28 @@
 
 #include <tuple>
 #include <filesystem>
+#include <optional>
 
 #include <geometry/types/vector.h>
+#include <graphics/bitmap_texture.h>
+#include <graphics/hdr_image.h>
 
-void serialize_as_ppm(const std::filesystem::path &file_path, int image_width, int image_height, const std::vector<int> &pixel);
+// ascii (P3) ppm; false, if the file can't be written
+bool serialize_as_ppm(const std::filesystem::path &file_path, int image_width, int image_height, const std::vector<int> &pixel);
 
 std::pair<std::vector<v3>, std::vector<std::array<int, 3>>> parse_wavefront(std::string file_path);
 
 std::string read_text_file(const std::filesystem::path& file);
 
+// reads ascii (P3) and binary (P6) ppm files with a maximal value up to 255; empty, if the file can't be read
+std::optional<bitmap_texture> load_ppm(const std::filesystem::path& file_path);
+
+// portable float maps, little endian with the bottom row first: colour images are written with their resolved
+// colours, single channels, e.g. depth of aov_buffers, as grey maps; false, if the file can't be written
+bool serialize_as_pfm(const std::filesystem::path& file_path, const hdr_image& image);
+bool serialize_as_pfm(const std::filesystem::path& file_path, int image_width, int image_height, const std::vector<float>& channel);
+
+// colour and grey maps, grey in all three channels, each pixel with one sample; empty, if the file can't be read
+std::optional<hdr_image> load_pfm(const std::filesystem::path& file_path);
+
 #endif /* file_io_hpp */
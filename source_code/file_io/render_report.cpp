@@ -0,0 +1,106 @@
+#include <iomanip>
+#include <sstream>
+
+#include "render_report.h"
+
+namespace
+{
+    std::string json_string(const std::string& s)
+    {
+        std::ostringstream result;
+
+        result << '"';
+
+        for (unsigned char c : s)
+        {
+            if ('"' == c || '\\' == c)
+            {
+                result << '\\' << c;
+            }
+            else if (c < 0x20)
+            {
+                result << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec;
+            }
+            else
+            {
+                result << c;
+            }
+        }
+
+        result << '"';
+
+        return result.str();
+    }
+
+    // null for counters the kernel didn't grant
+    std::string json_per_ray(const std::optional<long long>& count, double rays)
+    {
+        if (!count.has_value() || rays <= 0)
+        {
+            return "null";
+        }
+
+        std::ostringstream result;
+        result << *count / rays;
+
+        return result.str();
+    }
+}
+
+void write_json(std::ostream& os, const render_report& report)
+{
+    os << "{\n"
+        << "  \"scene\": " << json_string(report.scene) << ",\n"
+        << "  \"output\": " << json_string(report.output) << ",\n"
+        << "  \"renderer\": " << json_string(report.renderer) << ",\n"
+        << "  \"screen_width\": " << report.screen_width << ",\n"
+        << "  \"screen_height\": " << report.screen_height << ",\n"
+        << "  \"threads\": " << report.threads << ",\n"
+        << "  \"tile_size\": " << report.tile_size << ",\n"
+        << "  \"surfaces\": " << report.surfaces << ",\n"
+        << "  \"triangles\": " << report.triangles << ",\n";
+
+    os << "  \"seconds\": {";
+
+    for (int i = 0; i < report.phase_seconds.size(); i++)
+    {
+        os << (0 < i ? ", " : " ") << json_string(report.phase_seconds[i].first) << ": " << report.phase_seconds[i].second;
+    }
+
+    os << " },\n"
+        << "  \"samples_per_pixel\": " << report.samples_per_pixel << ",\n"
+        << "  \"rays_per_second\": " << report.rays_per_second;
+
+    if (report.statistics.has_value())
+    {
+        const intersection_statistics& s = *report.statistics;
+
+        os << ",\n  \"statistics\": {"
+            << " \"clipping_steps\": " << s.clipping_steps
+            << ", \"newton_starts\": " << s.newton_starts
+            << ", \"newton_iterations\": " << s.newton_iterations
+            << ", \"newton_roots\": " << s.newton_roots
+            << ", \"newton_fallbacks\": " << s.newton_fallbacks
+            << ", \"float_solves\": " << s.float_solves
+            << ", \"double_resolves\": " << s.double_resolves
+            << ", \"seeded_windows\": " << s.seeded_windows
+            << ", \"bounds_tests\": " << s.bounds_tests
+            << ", \"box_rejections\": " << s.box_rejections
+            << ", \"sphere_rejections\": " << s.sphere_rejections
+            << " }";
+    }
+
+    if (report.hardware_counters.has_value())
+    {
+        const hardware_counter_values& h = *report.hardware_counters;
+
+        os << ",\n  \"hardware_counters_per_ray\": {"
+            << " \"cycles\": " << json_per_ray(h.cycles, report.rays)
+            << ", \"instructions\": " << json_per_ray(h.instructions, report.rays)
+            << ", \"cache_misses\": " << json_per_ray(h.cache_misses, report.rays)
+            << ", \"branch_misses\": " << json_per_ray(h.branch_misses, report.rays)
+            << " }";
+    }
+
+    os << "\n}\n";
+}
@@ -0,0 +1,39 @@
+#ifndef render_report_h
+#define render_report_h
+
+#include <optional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <geometry/algorithms/intersection_statistics.h>
+#include <raytracing/hardware_counters.h>
+
+// what was rendered how and how long it took, written as json for comparing builds
+struct render_report
+{
+	std::string scene;
+	std::string output;
+	std::string renderer;
+	int screen_width = 0;
+	int screen_height = 0;
+	int threads = 0;
+	int tile_size = 0;
+	int surfaces = 0;
+	int triangles = 0;
+	// wall clock time of the phases in the order they ran, e.g. load, preprocess, render, write
+	std::vector<std::pair<std::string, double>> phase_seconds;
+	double samples_per_pixel = 1;
+	// camera rays of the render phase and how many per second
+	double rays = 0;
+	double rays_per_second = 0;
+	// empty for renderers without counters
+	std::optional<intersection_statistics> statistics;
+	// of the render phase, if asked for
+	std::optional<hardware_counter_values> hardware_counters;
+};
+
+void write_json(std::ostream& os, const render_report& report);
+
+#endif
@@ -0,0 +1,409 @@
+#include <sstream>
+
+#include "scene_description.h"
+#include "scene_file.h"
+#include "file_io.h"
+
+namespace
+{
+    std::string remove_comments(const std::string& text)
+    {
+        std::istringstream lines(text);
+        std::string result;
+        std::string line;
+
+        while (std::getline(lines, line))
+        {
+            result += line.substr(0, line.find('#')) + "\n";
+        }
+
+        return result;
+    }
+
+    template<class T> bool read_values(std::istream& stream, T& value)
+    {
+        return bool(stream >> value);
+    }
+
+    template<class T, class... Ts> bool read_values(std::istream& stream, T& value, Ts&... values)
+    {
+        return bool(stream >> value) && read_values(stream, values...);
+    }
+
+    bool read_color(std::istream& stream, color& c)
+    {
+        return read_values(stream, c[0], c[1], c[2]);
+    }
+
+    std::filesystem::path resolve(const std::filesystem::path& directory, const std::string& file_name)
+    {
+        std::filesystem::path path(file_name);
+
+        return path.is_absolute() ? path : directory / path;
+    }
+
+    // the screen geometries of the renderers are built without rotation
+    bool rotates_camera(const scene_descriptor& scene)
+    {
+        return 0 != scene.rotation_angle_e1 || 0 != scene.rotation_angle_e2 || 0 != scene.rotation_angle_e3;
+    }
+}
+
+std::optional<scene_description> parse_scene_description(const std::string& text, const std::filesystem::path& directory, std::string& error)
+{
+    scene_description description;
+
+    multiple_surfaces_scene_descriptor& scene = description.scene;
+
+    scene.screen_width = 512;
+    scene.screen_height = 512;
+    scene.origin = v3{ 0, 0, -5 };
+    scene.rotation_angle_e1 = scene.rotation_angle_e2 = scene.rotation_angle_e3 = 0;
+    scene.field_of_view = 30;
+    scene.light = v3{ -1, 2, -5 };
+    scene.epsilon = 1E-8;
+
+    // the materials of the patches of the description, the surfaces of a scene file keep theirs
+    std::vector<std::optional<material>> patch_materials;
+    int first_patch = 0;
+
+    std::istringstream stream(remove_comments(text));
+    std::string keyword;
+
+    auto fail = [&](const std::string& message) {
+        error = keyword + ": " + message;
+        return std::optional<scene_description>{};
+    };
+
+    while (stream >> keyword)
+    {
+        bool valid = true;
+
+        if ("screen" == keyword)
+        {
+            valid = read_values(stream, scene.screen_width, scene.screen_height) && 0 < scene.screen_width && 0 < scene.screen_height;
+        }
+        else if ("camera" == keyword)
+        {
+            valid = read_values(stream, scene.origin[0], scene.origin[1], scene.origin[2]);
+        }
+        else if ("rotation" == keyword)
+        {
+            valid = read_values(stream, scene.rotation_angle_e1, scene.rotation_angle_e2, scene.rotation_angle_e3);
+
+            if (valid && rotates_camera(scene))
+            {
+                return fail("the renderers don't rotate the camera, only 0 0 0 is accepted");
+            }
+        }
+        else if ("field_of_view" == keyword)
+        {
+            valid = read_values(stream, scene.field_of_view) && 0 < scene.field_of_view && scene.field_of_view < 180;
+        }
+        else if ("light" == keyword)
+        {
+            valid = read_values(stream, scene.light[0], scene.light[1], scene.light[2]);
+        }
+        else if ("epsilon" == keyword)
+        {
+            valid = read_values(stream, scene.epsilon) && 0 < scene.epsilon;
+        }
+        else if ("max_depth" == keyword)
+        {
+            valid = read_values(stream, scene.max_depth) && 0 <= scene.max_depth;
+        }
+        else if ("solver" == keyword)
+        {
+            std::string solver;
+            valid = read_values(stream, solver);
+
+            if ("clipping" == solver) scene.solver = intersection_solver::clipping;
+            else if ("hybrid" == solver) scene.solver = intersection_solver::hybrid;
+            else if ("float_first" == solver) scene.solver = intersection_solver::float_first;
+            else valid = false;
+        }
+        else if ("renderer" == keyword)
+        {
+            std::string renderer;
+            valid = read_values(stream, renderer);
+
+            if ("exact" == renderer) description.renderer = scene_renderer::exact;
+            else if ("tessellated" == renderer) description.renderer = scene_renderer::tessellated;
+            else valid = false;
+        }
+        else if ("pixel_tolerance" == keyword)
+        {
+            valid = read_values(stream, description.pixel_tolerance) && 0 < description.pixel_tolerance;
+        }
+        else if ("threads" == keyword)
+        {
+            valid = read_values(stream, description.threads) && 0 <= description.threads;
+        }
+        else if ("tile_size" == keyword)
+        {
+            valid = read_values(stream, description.tile_size) && 0 < description.tile_size;
+        }
+        else if ("output" == keyword)
+        {
+            std::string file_name;
+            valid = read_values(stream, file_name);
+            description.output = resolve(directory, file_name);
+        }
+        else if ("hdr_output" == keyword)
+        {
+            std::string file_name;
+            valid = read_values(stream, file_name);
+            description.hdr_output = resolve(directory, file_name);
+        }
+        else if ("exposure" == keyword)
+        {
+            valid = read_values(stream, description.mapping.exposure) && 0 < description.mapping.exposure;
+        }
+        else if ("tone_map" == keyword)
+        {
+            std::string op;
+            valid = read_values(stream, op);
+
+            if ("linear" == op) description.mapping.op = tone_operator::linear;
+            else if ("reinhard" == op) description.mapping.op = tone_operator::reinhard;
+            else valid = false;
+        }
+        else if ("aov" == keyword)
+        {
+            std::string channel;
+            valid = read_values(stream, channel);
+
+            if ("depth" == channel) description.aovs.depth = true;
+            else if ("normal" == channel) description.aovs.normal = true;
+            else if ("uv" == channel) description.aovs.uv = true;
+            else if ("object_id" == channel) description.aovs.object_id = true;
+            else if ("cost" == channel) description.aovs.cost = true;
+            else valid = false;
+        }
+        else if ("supersample" == keyword)
+        {
+            supersampling_settings settings;
+            valid = read_values(stream, settings.strata, settings.max_samples) && 0 < settings.strata && 0 < settings.max_samples;
+
+            // the noise threshold is optional
+            double threshold;
+            auto position = stream.tellg();
+            if (stream >> threshold)
+            {
+                settings.noise_threshold = threshold;
+            }
+            else
+            {
+                stream.clear();
+                stream.seekg(position);
+            }
+
+            description.supersampling = settings;
+        }
+        else if ("scene" == keyword)
+        {
+            std::string file_name;
+            if (!read_values(stream, file_name))
+            {
+                return fail("file name expected");
+            }
+
+            if (!scene.surfaces.empty())
+            {
+                return fail("must precede the patches");
+            }
+
+            auto loaded = load_scene(resolve(directory, file_name));
+            if (!loaded.has_value())
+            {
+                return fail("can't read " + file_name);
+            }
+
+            if (rotates_camera(*loaded))
+            {
+                return fail(file_name + " rotates the camera, which the renderers don't support");
+            }
+
+            scene = *loaded;
+            first_patch = scene.surfaces.size();
+        }
+        else if ("model" == keyword)
+        {
+            std::string file_name;
+            if (!read_values(stream, file_name) || !std::filesystem::exists(resolve(directory, file_name)))
+            {
+                return fail("can't read " + file_name);
+            }
+
+            auto [points, facettes] = parse_wavefront(resolve(directory, file_name).string());
+
+            int offset = description.model_points.size();
+
+            for (auto facette : facettes)
+            {
+                for (int& index : facette)
+                {
+                    if (index < 0 || points.size() <= index)
+                    {
+                        return fail("facette with invalid point in " + file_name);
+                    }
+
+                    index += offset;
+                }
+
+                description.model_facettes.push_back(facette);
+            }
+
+            description.model_points.insert(description.model_points.end(), points.begin(), points.end());
+        }
+        else if ("patch" == keyword)
+        {
+            int rows, columns;
+            if (!read_values(stream, rows, columns) || rows < 2 || columns < 2)
+            {
+                return fail("at least 2 x 2 control points expected");
+            }
+
+            varmesh<4> mesh(rows, columns);
+
+            for (int i = 0; i < rows; i++)
+            {
+                for (int j = 0; j < columns; j++)
+                {
+                    v4& p = mesh[i][j];
+
+                    if (!read_values(stream, p[0], p[1], p[2], p[3]) || p[3] <= 0)
+                    {
+                        return fail("control point with positive weight expected");
+                    }
+                }
+            }
+
+            scene_object object{ mesh, [](double, double) { return std::vector<int>{ 255, 255, 255 }; } };
+
+            scene.surfaces.push_back(object);
+            patch_materials.push_back({});
+        }
+        else if ("color" == keyword || "checker" == keyword || "reflectivity" == keyword || "transparency" == keyword || "refractive_index" == keyword)
+        {
+            if (patch_materials.empty())
+            {
+                return fail("must follow a patch");
+            }
+
+            scene_object& object = scene.surfaces.back();
+
+            if ("color" == keyword)
+            {
+                color c;
+                valid = read_color(stream, c);
+                patch_materials.back() = constant_material(c);
+            }
+            else if ("checker" == keyword)
+            {
+                color even, odd;
+                valid = read_color(stream, even) && read_color(stream, odd);
+
+                material checker = checker_material(even, odd);
+
+                // the frequency is optional
+                double frequency;
+                auto position = stream.tellg();
+                if (stream >> frequency)
+                {
+                    checker.frequency = frequency;
+                }
+                else
+                {
+                    stream.clear();
+                    stream.seekg(position);
+                }
+
+                patch_materials.back() = checker;
+            }
+            else if ("reflectivity" == keyword)
+            {
+                valid = read_values(stream, object.reflectivity) && 0 <= object.reflectivity && object.reflectivity <= 1;
+            }
+            else if ("transparency" == keyword)
+            {
+                valid = read_values(stream, object.transparency) && 0 <= object.transparency && object.transparency <= 1;
+            }
+            else
+            {
+                valid = read_values(stream, object.refractive_index) && 0 < object.refractive_index;
+            }
+        }
+        else
+        {
+            return fail("unknown keyword");
+        }
+
+        if (!valid)
+        {
+            return fail("invalid value");
+        }
+    }
+
+    if (scene.surfaces.empty() && description.model_facettes.empty())
+    {
+        keyword = "scene";
+        return fail("neither patches nor models");
+    }
+
+    if (!description.model_facettes.empty() && scene_renderer::exact == description.renderer)
+    {
+        keyword = "model";
+        return fail("triangles need the tessellated renderer");
+    }
+
+    if (!supports_float_output(description))
+    {
+        keyword = "hdr_output";
+        return fail("float images, aovs, supersampling and tone mapping need the exact renderer without max_depth");
+    }
+
+    bool has_patch_material = false;
+    for (const auto& m : patch_materials)
+    {
+        has_patch_material = has_patch_material || m.has_value();
+    }
+
+    // surfaces beyond the material table use their white mesh colour
+    if (has_patch_material)
+    {
+        scene.materials.materials.resize(first_patch, constant_material(color{ {255, 255, 255} }));
+
+        for (const auto& m : patch_materials)
+        {
+            scene.materials.materials.push_back(m.value_or(constant_material(color{ {255, 255, 255} })));
+        }
+    }
+
+    return description;
+}
+
+bool needs_float_output(const scene_description& description)
+{
+    const aov_selection& aovs = description.aovs;
+
+    bool identity = 1 == description.mapping.exposure && tone_operator::linear == description.mapping.op;
+
+    return !identity || description.supersampling.has_value() || !description.hdr_output.empty() || aovs.depth || aovs.normal || aovs.uv || aovs.object_id || aovs.cost;
+}
+
+bool supports_float_output(const scene_description& description)
+{
+    return !needs_float_output(description) || (scene_renderer::exact == description.renderer && 0 == description.scene.max_depth);
+}
+
+std::optional<scene_description> load_scene_description(const std::filesystem::path& file_path, std::string& error)
+{
+    if (!std::filesystem::exists(file_path))
+    {
+        error = "can't read " + file_path.string();
+        return {};
+    }
+
+    return parse_scene_description(read_text_file(file_path), file_path.parent_path(), error);
+}
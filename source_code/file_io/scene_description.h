@@ -0,0 +1,64 @@
+#ifndef scene_description_h
+#define scene_description_h
+
+#include <array>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <raytracing/scene_descriptor.h>
+#include <raytracing/aov_buffers.h>
+#include <raytracing/raytrace_supersampled_scene.h>
+#include <graphics/hdr_image.h>
+
+// the patches are traced exactly, while triangle models need the tessellated renderer
+enum class scene_renderer { exact, tessellated };
+
+// a scene with the settings to render it, see parse_scene_description
+struct scene_description
+{
+	multiple_surfaces_scene_descriptor scene;
+	// triangles of the wavefront models
+	std::vector<v3> model_points;
+	std::vector<std::array<int, 3>> model_facettes;
+
+	scene_renderer renderer = scene_renderer::exact;
+	// tessellation error of the patches for the tessellated renderer
+	double pixel_tolerance = 0.5;
+	// 0 uses all hardware threads
+	int threads = 0;
+	int tile_size = 16;
+	std::filesystem::path output = "image.ppm";
+	// the float image, if not empty
+	std::filesystem::path hdr_output;
+	// the 8 bit image is tone mapped from a float image, if the mapping isn't the identity or there is a float output
+	tone_mapping mapping;
+	// written next to the output as <stem>.<channel>.pfm, normal and uv as colour maps
+	aov_selection aovs;
+	// adaptive supersampling, if set
+	std::optional<supersampling_settings> supersampling;
+};
+
+// a float image, aovs, supersampling or a tone mapping other than the identity are asked for
+bool needs_float_output(const scene_description& description);
+// float images and aovs are only traced by the exact renderer without secondary rays
+bool supports_float_output(const scene_description& description);
+
+// text with one keyword and its values per statement, # comments the rest of a line:
+//   screen <width> <height>, camera <x> <y> <z>, rotation 0 0 0 (the renderers don't rotate the camera),
+//   field_of_view <degrees>, light <x> <y> <z>,
+//   epsilon <e>, max_depth <n>, solver clipping|hybrid|float_first, renderer exact|tessellated, pixel_tolerance <p>,
+//   threads <n>, tile_size <n>, output <file>, hdr_output <file>, exposure <factor>, tone_map linear|reinhard,
+//   aov depth|normal|uv|object_id|cost, once per channel, supersample <strata> <max samples> [noise threshold],
+//   scene <binary scene file>: its camera, surfaces and materials, see load_scene,
+//   model <wavefront file>: its triangles,
+//   patch <rows> <columns> followed by rows x columns control points <x> <y> <z> <w>, row by row,
+//   and for the last patch: color <r> <g> <b>, checker <r> <g> <b> <r> <g> <b> [frequency], reflectivity <r>,
+//   transparency <t>, refractive_index <n>
+// relative file names are relative to directory; empty with a message in error, if the text is malformed
+std::optional<scene_description> parse_scene_description(const std::string& text, const std::filesystem::path& directory, std::string& error);
+
+std::optional<scene_description> load_scene_description(const std::filesystem::path& file_path, std::string& error);
+
+#endif
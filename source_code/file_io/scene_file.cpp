@@ -0,0 +1,369 @@
+#include <cstdint>
+#include <fstream>
+
+#include "scene_file.h"
+
+namespace
+{
+    const std::uint32_t scene_file_magic = 0x53525a42;
+    const std::uint32_t scene_file_version = 1;
+
+    const std::int32_t maximal_screen_size = 32768;
+    const std::int32_t maximal_grid_resolution = 4096;
+    // kind, two colours, frequency and texture index
+    const std::uint64_t material_size = 8 * sizeof(std::int32_t) + sizeof(double);
+
+    template<class T> void write_value(std::ostream& stream, const T& value)
+    {
+        stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<class T> bool read_value(std::istream& stream, T& value)
+    {
+        return bool(stream.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    // count elements of element_size bytes are left in the stream; the counts of a file are checked, before anything
+    // is allocated for them
+    bool fits(std::istream& stream, std::uint64_t count, std::uint64_t element_size)
+    {
+        auto position = stream.tellg();
+        stream.seekg(0, std::ios::end);
+        auto end = stream.tellg();
+        stream.seekg(position);
+
+        return 0 <= position && count * element_size <= std::uint64_t(end - position);
+    }
+
+    void write_color(std::ostream& stream, const color& c)
+    {
+        for (int channel : c)
+        {
+            write_value<std::int32_t>(stream, channel);
+        }
+    }
+
+    bool read_color(std::istream& stream, color& c)
+    {
+        for (int& channel : c)
+        {
+            std::int32_t value;
+            if (!read_value(stream, value))
+            {
+                return false;
+            }
+            channel = value;
+        }
+
+        return true;
+    }
+
+    void write_bitmap(std::ostream& stream, const bitmap_texture& bitmap)
+    {
+        write_value<std::int32_t>(stream, bitmap.width);
+        write_value<std::int32_t>(stream, bitmap.height);
+
+        for (const auto& texel : bitmap.texels)
+        {
+            write_color(stream, texel);
+        }
+    }
+
+    std::optional<bitmap_texture> read_bitmap(std::istream& stream)
+    {
+        std::int32_t width, height;
+        if (!read_value(stream, width) || !read_value(stream, height) || width <= 0 || height <= 0
+            || !fits(stream, std::uint64_t(width) * height, 3 * sizeof(std::int32_t)))
+        {
+            return {};
+        }
+
+        bitmap_texture bitmap{ width, height, std::vector<color>(width * height) };
+
+        for (auto& texel : bitmap.texels)
+        {
+            if (!read_color(stream, texel))
+            {
+                return {};
+            }
+        }
+
+        return bitmap;
+    }
+
+    // the finest level holds the whole texture, the others are filtered again when loading
+    bitmap_texture finest_level(const mipmapped_texture& mipmap)
+    {
+        bitmap_texture bitmap{ mipmap.width(0), mipmap.height(0), {} };
+
+        for (int y = 0; y < bitmap.height; y++)
+        {
+            for (int x = 0; x < bitmap.width; x++)
+            {
+                bitmap.texels.push_back(mipmap.texel(0, x, y));
+            }
+        }
+
+        return bitmap;
+    }
+}
+
+bool save_scene(const std::filesystem::path& file_path, const multiple_surfaces_scene_descriptor& scene)
+{
+    std::ofstream stream(file_path, std::ofstream::binary | std::ofstream::trunc);
+
+    if (!stream.is_open())
+    {
+        return false;
+    }
+
+    write_value(stream, scene_file_magic);
+    write_value(stream, scene_file_version);
+
+    write_value<std::int32_t>(stream, scene.screen_width);
+    write_value<std::int32_t>(stream, scene.screen_height);
+    write_value(stream, scene.origin);
+    write_value(stream, scene.rotation_angle_e1);
+    write_value(stream, scene.rotation_angle_e2);
+    write_value(stream, scene.rotation_angle_e3);
+    write_value(stream, scene.field_of_view);
+    write_value(stream, scene.light);
+
+    write_value(stream, scene.epsilon);
+    write_value<std::int32_t>(stream, scene.max_depth);
+    write_value<std::int32_t>(stream, static_cast<std::int32_t>(scene.solver));
+
+    write_value<std::uint32_t>(stream, scene.surfaces.size());
+
+    for (const auto& surface : scene.surfaces)
+    {
+        write_value<std::uint32_t>(stream, surface.mesh.row_size());
+        write_value<std::uint32_t>(stream, surface.mesh.col_size());
+
+        for (int i = 0; i < surface.mesh.row_size(); i++)
+        {
+            for (int j = 0; j < surface.mesh.col_size(); j++)
+            {
+                write_value(stream, surface.mesh.element(i, j));
+            }
+        }
+
+        write_value(stream, surface.reflectivity);
+        write_value(stream, surface.transparency);
+        write_value(stream, surface.refractive_index);
+
+        write_value<std::int32_t>(stream, surface.trim.grid_resolution());
+        write_value<std::uint32_t>(stream, surface.trim.trim_loops().size());
+
+        for (const auto& loop : surface.trim.trim_loops())
+        {
+            write_value<std::uint32_t>(stream, loop.size());
+
+            for (const auto& point : loop)
+            {
+                write_value(stream, point);
+            }
+        }
+    }
+
+    write_value<std::uint32_t>(stream, scene.materials.materials.size());
+
+    for (const auto& m : scene.materials.materials)
+    {
+        write_value<std::int32_t>(stream, static_cast<std::int32_t>(m.kind));
+        write_color(stream, m.first);
+        write_color(stream, m.second);
+        write_value(stream, m.frequency);
+        write_value<std::int32_t>(stream, m.bitmap);
+    }
+
+    write_value<std::uint32_t>(stream, scene.materials.bitmaps.size());
+
+    for (const auto& bitmap : scene.materials.bitmaps)
+    {
+        write_bitmap(stream, bitmap);
+    }
+
+    write_value<std::uint32_t>(stream, scene.materials.mipmaps.size());
+
+    for (const auto& mipmap : scene.materials.mipmaps)
+    {
+        write_bitmap(stream, finest_level(mipmap));
+    }
+
+    return bool(stream);
+}
+
+std::optional<multiple_surfaces_scene_descriptor> load_scene(const std::filesystem::path& file_path)
+{
+    std::ifstream stream(file_path, std::ifstream::binary);
+
+    std::uint32_t magic, version;
+    if (!read_value(stream, magic) || !read_value(stream, version) || scene_file_magic != magic || scene_file_version != version)
+    {
+        return {};
+    }
+
+    multiple_surfaces_scene_descriptor scene{};
+
+    std::int32_t width, height, max_depth, solver;
+    if (!read_value(stream, width) || !read_value(stream, height)
+        || !read_value(stream, scene.origin)
+        || !read_value(stream, scene.rotation_angle_e1) || !read_value(stream, scene.rotation_angle_e2) || !read_value(stream, scene.rotation_angle_e3)
+        || !read_value(stream, scene.field_of_view) || !read_value(stream, scene.light)
+        || !read_value(stream, scene.epsilon) || !read_value(stream, max_depth) || !read_value(stream, solver))
+    {
+        return {};
+    }
+
+    // larger screens than 32768 x 32768 and unknown solvers are malformed
+    if (width <= 0 || height <= 0 || maximal_screen_size < width || maximal_screen_size < height || max_depth < 0
+        || solver < 0 || static_cast<std::int32_t>(intersection_solver::float_first) < solver)
+    {
+        return {};
+    }
+
+    scene.screen_width = width;
+    scene.screen_height = height;
+    scene.max_depth = max_depth;
+    scene.solver = static_cast<intersection_solver>(solver);
+
+    std::uint32_t surface_count;
+    if (!read_value(stream, surface_count))
+    {
+        return {};
+    }
+
+    for (std::uint32_t s = 0; s < surface_count; s++)
+    {
+        std::uint32_t rows, cols;
+        if (!read_value(stream, rows) || !read_value(stream, cols) || 0 == rows || 0 == cols
+            || !fits(stream, std::uint64_t(rows) * cols, sizeof(v4)))
+        {
+            return {};
+        }
+
+        scene_object surface{ varmesh<4>(rows, cols), [](double, double) { return std::vector<int>{ 255, 255, 255 }; } };
+
+        for (int i = 0; i < rows; i++)
+        {
+            for (int j = 0; j < cols; j++)
+            {
+                if (!read_value(stream, surface.mesh.element(i, j)))
+                {
+                    return {};
+                }
+            }
+        }
+
+        std::int32_t grid_resolution;
+        std::uint32_t loop_count;
+        if (!read_value(stream, surface.reflectivity) || !read_value(stream, surface.transparency) || !read_value(stream, surface.refractive_index)
+            || !read_value(stream, grid_resolution) || !read_value(stream, loop_count)
+            || (0 < loop_count && (grid_resolution <= 0 || maximal_grid_resolution < grid_resolution)) || !fits(stream, loop_count, sizeof(std::uint32_t)))
+        {
+            return {};
+        }
+
+        std::vector<std::vector<v2>> loops(loop_count);
+
+        for (auto& loop : loops)
+        {
+            std::uint32_t point_count;
+            if (!read_value(stream, point_count) || !fits(stream, point_count, sizeof(v2)))
+            {
+                return {};
+            }
+
+            loop.resize(point_count);
+
+            for (auto& point : loop)
+            {
+                if (!read_value(stream, point))
+                {
+                    return {};
+                }
+            }
+        }
+
+        if (!loops.empty())
+        {
+            surface.trim = trim_region(loops, grid_resolution);
+        }
+
+        scene.surfaces.push_back(surface);
+    }
+
+    std::uint32_t material_count;
+    if (!read_value(stream, material_count) || !fits(stream, material_count, material_size))
+    {
+        return {};
+    }
+
+    scene.materials.materials.resize(material_count);
+
+    for (auto& m : scene.materials.materials)
+    {
+        std::int32_t kind, bitmap;
+        if (!read_value(stream, kind) || !read_color(stream, m.first) || !read_color(stream, m.second) || !read_value(stream, m.frequency) || !read_value(stream, bitmap))
+        {
+            return {};
+        }
+
+        if (kind < 0 || static_cast<std::int32_t>(material_kind::mipmap) < kind)
+        {
+            return {};
+        }
+
+        m.kind = static_cast<material_kind>(kind);
+        m.bitmap = bitmap;
+    }
+
+    std::uint32_t bitmap_count;
+    if (!read_value(stream, bitmap_count) || !fits(stream, bitmap_count, 2 * sizeof(std::int32_t)))
+    {
+        return {};
+    }
+
+    for (std::uint32_t i = 0; i < bitmap_count; i++)
+    {
+        auto bitmap = read_bitmap(stream);
+        if (!bitmap.has_value())
+        {
+            return {};
+        }
+
+        scene.materials.bitmaps.push_back(*bitmap);
+    }
+
+    std::uint32_t mipmap_count;
+    if (!read_value(stream, mipmap_count) || !fits(stream, mipmap_count, 2 * sizeof(std::int32_t)))
+    {
+        return {};
+    }
+
+    for (std::uint32_t i = 0; i < mipmap_count; i++)
+    {
+        auto bitmap = read_bitmap(stream);
+        if (!bitmap.has_value())
+        {
+            return {};
+        }
+
+        scene.materials.mipmaps.emplace_back(*bitmap);
+    }
+
+    // the textures of the materials are indexed without checks when sampling
+    for (const auto& m : scene.materials.materials)
+    {
+        bool valid_bitmap = material_kind::bitmap != m.kind || (0 <= m.bitmap && m.bitmap < int(scene.materials.bitmaps.size()));
+        bool valid_mipmap = material_kind::mipmap != m.kind || (0 <= m.bitmap && m.bitmap < int(scene.materials.mipmaps.size()));
+
+        if (!valid_bitmap || !valid_mipmap)
+        {
+            return {};
+        }
+    }
+
+    return scene;
+}
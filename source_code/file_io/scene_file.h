@@ -0,0 +1,17 @@
+#ifndef scene_file_h
+#define scene_file_h
+
+#include <filesystem>
+#include <optional>
+
+#include <raytracing/scene_descriptor.h>
+
+// binary scene files in the byte order of the machine: camera, light, surfaces with their trim loops, solver settings
+// and materials with their textures; the colour functions of the surfaces can't be stored, loaded surfaces without
+// material are white
+bool save_scene(const std::filesystem::path& file_path, const multiple_surfaces_scene_descriptor& scene);
+
+// empty, if the file can't be read or isn't a scene file of this version
+std::optional<multiple_surfaces_scene_descriptor> load_scene(const std::filesystem::path& file_path);
+
+#endif
@@ -0,0 +1,426 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include "bezier_patch_bvh.h"
+#include "intersection.h"
+
+#include <geometry/algorithms/render_trace.h>
+#include <geometry/linear_algebra/formulas.h>
+#include <geometry/types/bezier_surface.h>
+
+bounding_box bounding_box_of_mesh(const varmesh<4>& m)
+{
+    v3 lower = remove_dimension(m.element(0, 0));
+    v3 upper = lower;
+
+    for (int i = 0; i < m.row_size(); i++)
+    {
+        for (int j = 0; j < m.col_size(); j++)
+        {
+            v3 p = remove_dimension(m.element(i, j));
+
+            for (int k = 0; k < 3; k++)
+            {
+                lower[k] = std::min(lower[k], p[k]);
+                upper[k] = std::max(upper[k], p[k]);
+            }
+        }
+    }
+
+    // widened slightly, such that rounding in the slab test can't reject a line the convex hull test accepts
+    double padding = 1E-9 * (1 + std::max(l_inf(lower), l_inf(upper)));
+
+    for (int k = 0; k < 3; k++)
+    {
+        lower[k] -= padding;
+        upper[k] += padding;
+    }
+
+    return bounding_box{ lower, upper };
+}
+
+bounding_box merge_bounding_boxes(const bounding_box& a, const bounding_box& b)
+{
+    bounding_box result;
+
+    for (int k = 0; k < 3; k++)
+    {
+        result.lower[k] = std::min(a.lower[k], b.lower[k]);
+        result.upper[k] = std::max(a.upper[k], b.upper[k]);
+    }
+
+    return result;
+}
+
+bool intersects_bounding_box(const v3& origin, const v3& direction, const bounding_box& box, double t_entry, double& entry)
+{
+    double t_exit = std::numeric_limits<double>::max();
+
+    for (int k = 0; k < 3; k++)
+    {
+        if (0 == direction[k])
+        {
+            if (origin[k] < box.lower[k] || origin[k] > box.upper[k])
+            {
+                return false;
+            }
+            continue;
+        }
+
+        double t0 = (box.lower[k] - origin[k]) / direction[k];
+        double t1 = (box.upper[k] - origin[k]) / direction[k];
+
+        if (t0 > t1)
+        {
+            std::swap(t0, t1);
+        }
+
+        t_entry = std::max(t_entry, t0);
+        t_exit = std::min(t_exit, t1);
+
+        if (t_entry > t_exit)
+        {
+            return false;
+        }
+    }
+
+    entry = t_entry;
+
+    return true;
+}
+
+bool line_intersects_bounding_box(const v3& origin, const v3& direction, const bounding_box& box, double& entry)
+{
+    return intersects_bounding_box(origin, direction, box, -std::numeric_limits<double>::max(), entry);
+}
+
+bool ray_intersects_bounding_box(const v3& origin, const v3& direction, const bounding_box& box, double& entry)
+{
+    return intersects_bounding_box(origin, direction, box, 0, entry);
+}
+
+double relative_flatness_of_mesh(const varmesh<4>& m)
+{
+    size_t last_row = m.row_size() - 1;
+    size_t last_col = m.col_size() - 1;
+
+    v3 p00 = remove_dimension(m.element(0, 0));
+    v3 p01 = remove_dimension(m.element(0, last_col));
+    v3 p10 = remove_dimension(m.element(last_row, 0));
+    v3 p11 = remove_dimension(m.element(last_row, last_col));
+
+    v3 normale = cross_product(p11 - p00, p10 - p01);
+    double normale_length = length(normale);
+
+    bounding_box box = bounding_box_of_mesh(m);
+    double diagonal = length(box.upper - box.lower);
+
+    if (0 == normale_length || 0 == diagonal)
+    {
+        return std::numeric_limits<double>::max();
+    }
+
+    normale = (1. / normale_length) * normale;
+
+    v3 bary = remove_dimension(barycentre_of_mesh(m));
+
+    double max_distance = 0;
+
+    for (int i = 0; i < m.row_size(); i++)
+    {
+        for (int j = 0; j < m.col_size(); j++)
+        {
+            max_distance = std::max(max_distance, std::abs(normale * (remove_dimension(m.element(i, j)) - bary)));
+        }
+    }
+
+    return max_distance / diagonal;
+}
+
+bezier_patch_bvh::bezier_patch_bvh(const varmesh<4>& m, int max_depth, double flatness_tolerance)
+{
+    nodes.push_back(patch_bvh_node{ bounding_box{}, -1, -1 });
+
+    build(0, m, v2{ 0, 1 }, v2{ 0, 1 }, 0, std::min(max_depth, maximal_depth), flatness_tolerance);
+}
+
+void bezier_patch_bvh::build(int index, const varmesh<4>& m, const v2& u, const v2& v, int depth, int max_depth, double flatness_tolerance)
+{
+    if (depth >= max_depth || relative_flatness_of_mesh(m) <= flatness_tolerance)
+    {
+        nodes[index].bounds = bounding_box_of_mesh(m);
+        nodes[index].leaf = int(leaves.size());
+        leaves.push_back(patch_bvh_leaf{ m, u, v });
+        return;
+    }
+
+    int first_child = int(nodes.size());
+    nodes[index].first_child = first_child;
+    nodes.resize(nodes.size() + 4, patch_bvh_node{ bounding_box{}, -1, -1 });
+
+    double u_half = 0.5 * (u[0] + u[1]);
+    double v_half = 0.5 * (v[0] + v[1]);
+
+    auto div_m = subdivide_bezier_surface_by_row(m, 0.5);
+
+    auto lm = subdivide_bezier_surface_by_column(div_m.first, 0.5);
+    build(first_child, lm.first, v2{ u[0], u_half }, v2{ v[0], v_half }, depth + 1, max_depth, flatness_tolerance);
+    build(first_child + 1, lm.second, v2{ u[0], u_half }, v2{ v_half, v[1] }, depth + 1, max_depth, flatness_tolerance);
+
+    lm = subdivide_bezier_surface_by_column(div_m.second, 0.5);
+    build(first_child + 2, lm.first, v2{ u_half, u[1] }, v2{ v[0], v_half }, depth + 1, max_depth, flatness_tolerance);
+    build(first_child + 3, lm.second, v2{ u_half, u[1] }, v2{ v_half, v[1] }, depth + 1, max_depth, flatness_tolerance);
+
+    bounding_box bounds = nodes[first_child].bounds;
+    for (int c = 1; c < 4; c++)
+    {
+        bounds = merge_bounding_boxes(bounds, nodes[first_child + c].bounds);
+    }
+    nodes[index].bounds = bounds;
+}
+
+void bezier_patch_bvh::refit(const varmesh<4>& m)
+{
+    refit(0, m);
+}
+
+void bezier_patch_bvh::refit(int index, const varmesh<4>& m)
+{
+    if (-1 != nodes[index].leaf)
+    {
+        nodes[index].bounds = bounding_box_of_mesh(m);
+        leaves[nodes[index].leaf].mesh = m;
+        return;
+    }
+
+    int first_child = nodes[index].first_child;
+
+    auto div_m = subdivide_bezier_surface_by_row(m, 0.5);
+
+    auto lm = subdivide_bezier_surface_by_column(div_m.first, 0.5);
+    refit(first_child, lm.first);
+    refit(first_child + 1, lm.second);
+
+    lm = subdivide_bezier_surface_by_column(div_m.second, 0.5);
+    refit(first_child + 2, lm.first);
+    refit(first_child + 3, lm.second);
+
+    bounding_box bounds = nodes[first_child].bounds;
+    for (int c = 1; c < 4; c++)
+    {
+        bounds = merge_bounding_boxes(bounds, nodes[first_child + c].bounds);
+    }
+    nodes[index].bounds = bounds;
+}
+
+template<class visitor> void bezier_patch_bvh::visit_intersected_leaves(const v3& origin, const v3& direction, std::vector<v2>& projection_coordinates, visitor visit) const
+{
+    RENDER_TRACE_DETAIL_SPAN("patch bvh traversal");
+
+    double entry;
+
+    if (!line_intersects_bounding_box(origin, direction, nodes[0].bounds, entry))
+    {
+        return;
+    }
+
+    auto [vertical_plane, horizontal_plane] = planes_of_ray(origin, direction);
+
+    // every inner node replaces itself by at most four children
+    std::array<int, 3 * maximal_depth + 1> stack;
+    int stack_size = 0;
+
+    stack[stack_size++] = 0;
+
+    while (0 < stack_size)
+    {
+        const patch_bvh_node& node = nodes[stack[--stack_size]];
+
+        if (-1 != node.leaf)
+        {
+            if (intersects_convex_hull(horizontal_plane, vertical_plane, leaves[node.leaf].mesh, projection_coordinates) && !visit(node.leaf))
+            {
+                return;
+            }
+            continue;
+        }
+
+        std::array<std::pair<double, int>, 4> hit_children;
+        int hit_count = 0;
+
+        for (int c = 0; c < 4; c++)
+        {
+            if (line_intersects_bounding_box(origin, direction, nodes[node.first_child + c].bounds, entry))
+            {
+                hit_children[hit_count++] = std::make_pair(entry, node.first_child + c);
+            }
+        }
+
+        // the farthest child is pushed first, such that the nearest is visited next; insertion sort of at most four
+        for (int i = 1; i < hit_count; i++)
+        {
+            auto child = hit_children[i];
+            int j = i;
+
+            for (; 0 < j && hit_children[j - 1].first < child.first; j--)
+            {
+                hit_children[j] = hit_children[j - 1];
+            }
+            hit_children[j] = child;
+        }
+
+        for (int i = 0; i < hit_count; i++)
+        {
+            stack[stack_size++] = hit_children[i].second;
+        }
+    }
+}
+
+void bezier_patch_bvh::intersected_leaves(const v3& origin, const v3& direction, std::vector<int>& result, std::vector<v2>& projection_coordinates) const
+{
+    result.clear();
+
+    visit_intersected_leaves(origin, direction, projection_coordinates, [&result](int leaf) { result.push_back(leaf); return true; });
+}
+
+bool bezier_patch_bvh::intersects_leaf(const v3& origin, const v3& direction, std::vector<v2>& projection_coordinates) const
+{
+    bool intersected = false;
+
+    visit_intersected_leaves(origin, direction, projection_coordinates, [&intersected](int) { intersected = true; return false; });
+
+    return intersected;
+}
+
+surface_bvh::surface_bvh(const std::vector<bounding_box>& surface_bounds) : leaf_of_surface(surface_bounds.size(), -1)
+{
+    if (surface_bounds.empty())
+    {
+        return;
+    }
+
+    std::vector<std::pair<v3, int>> centres;
+
+    for (int i = 0; i < surface_bounds.size(); i++)
+    {
+        centres.push_back(std::make_pair(0.5 * (surface_bounds[i].lower + surface_bounds[i].upper), i));
+    }
+
+    nodes.push_back(surface_bvh_node{ bounding_box{}, -1, -1, -1 });
+
+    build(0, centres.begin(), centres.end(), surface_bounds);
+}
+
+void surface_bvh::build(int index, std::vector<std::pair<v3, int>>::iterator begin, std::vector<std::pair<v3, int>>::iterator end, const std::vector<bounding_box>& surface_bounds)
+{
+    if (1 == end - begin)
+    {
+        nodes[index].bounds = surface_bounds[begin->second];
+        nodes[index].surface = begin->second;
+        leaf_of_surface[begin->second] = index;
+        return;
+    }
+
+    v3 lower = begin->first;
+    v3 upper = begin->first;
+
+    for (auto centre = begin; centre != end; centre++)
+    {
+        for (int k = 0; k < 3; k++)
+        {
+            lower[k] = std::min(lower[k], centre->first[k]);
+            upper[k] = std::max(upper[k], centre->first[k]);
+        }
+    }
+
+    v3 extent = upper - lower;
+    int axis = 0;
+    for (int k = 1; k < 3; k++)
+    {
+        if (extent[axis] < extent[k])
+        {
+            axis = k;
+        }
+    }
+
+    auto middle = begin + (end - begin) / 2;
+    std::nth_element(begin, middle, end, [axis](const auto& a, const auto& b) { return a.first[axis] < b.first[axis]; });
+
+    int first_child = int(nodes.size());
+    nodes[index].first_child = first_child;
+    nodes.push_back(surface_bvh_node{ bounding_box{}, index, -1, -1 });
+    nodes.push_back(surface_bvh_node{ bounding_box{}, index, -1, -1 });
+
+    build(first_child, begin, middle, surface_bounds);
+    build(first_child + 1, middle, end, surface_bounds);
+
+    nodes[index].bounds = merge_bounding_boxes(nodes[first_child].bounds, nodes[first_child + 1].bounds);
+}
+
+void surface_bvh::refit(int surface, const bounding_box& bounds)
+{
+    int index = leaf_of_surface[surface];
+
+    nodes[index].bounds = bounds;
+
+    for (index = nodes[index].parent; -1 != index; index = nodes[index].parent)
+    {
+        int first_child = nodes[index].first_child;
+        nodes[index].bounds = merge_bounding_boxes(nodes[first_child].bounds, nodes[first_child + 1].bounds);
+    }
+}
+
+void surface_bvh::intersected_surfaces(const v3& origin, const v3& direction, std::vector<std::pair<double, int>>& result, std::vector<std::pair<double, int>>& stack) const
+{
+    RENDER_TRACE_DETAIL_SPAN("surface bvh traversal");
+
+    result.clear();
+    stack.clear();
+
+    double entry;
+
+    if (nodes.empty() || !ray_intersects_bounding_box(origin, direction, nodes[0].bounds, entry))
+    {
+        return;
+    }
+
+    stack.push_back(std::make_pair(entry, 0));
+
+    while (!stack.empty())
+    {
+        auto [node_entry, index] = stack.back();
+        stack.pop_back();
+
+        const surface_bvh_node& node = nodes[index];
+
+        if (-1 != node.surface)
+        {
+            result.push_back(std::make_pair(node_entry, node.surface));
+            continue;
+        }
+
+        double entries[2];
+        bool hits[2];
+
+        for (int c = 0; c < 2; c++)
+        {
+            hits[c] = ray_intersects_bounding_box(origin, direction, nodes[node.first_child + c].bounds, entries[c]);
+        }
+
+        // the nearer child is pushed last, such that it is visited next
+        int nearer = (hits[0] && hits[1] && entries[1] < entries[0]) ? 1 : 0;
+
+        for (int c : { 1 - nearer, nearer })
+        {
+            if (hits[c])
+            {
+                stack.push_back(std::make_pair(entries[c], node.first_child + c));
+            }
+        }
+    }
+
+    // leaves are reached depth first, overlapping siblings can still be out of order
+    std::stable_sort(result.begin(), result.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+}
@@ -0,0 +1,115 @@
+#ifndef bezier_patch_bvh_h
+#define bezier_patch_bvh_h
+
+#include <vector>
+
+#include <geometry/types/vector.h>
+#include <geometry/types/varmesh.h>
+
+struct bounding_box
+{
+    v3 lower;
+    v3 upper;
+};
+
+bounding_box bounding_box_of_mesh(const varmesh<4>& m);
+bounding_box merge_bounding_boxes(const bounding_box& a, const bounding_box& b);
+
+// tests the whole line through origin, like intersects_convex_hull; entry is the line parameter where the box is entered
+bool line_intersects_bounding_box(const v3& origin, const v3& direction, const bounding_box& box, double& entry);
+// only the half line in front of origin, entry is clamped to 0
+bool ray_intersects_bounding_box(const v3& origin, const v3& direction, const bounding_box& box, double& entry);
+
+// largest distance of a control point to the plane through the barycentre spanned by the corner diagonals,
+// relative to the diagonal of the bounding box
+double relative_flatness_of_mesh(const varmesh<4>& m);
+
+struct patch_bvh_node
+{
+    bounding_box bounds;
+    // the four children are stored consecutively, -1 for leaves
+    int first_child;
+    // index into the leaves, -1 for inner nodes
+    int leaf;
+};
+
+struct patch_bvh_leaf
+{
+    varmesh<4> mesh;
+    // parameter window of the leaf in the domain of the patch
+    v2 u;
+    v2 v;
+};
+
+// adaptive subdivision tree of a rational bezier patch: a node is split into four by halving both parameters
+// until it is flat up to flatness_tolerance or max_depth is reached
+class bezier_patch_bvh
+{
+public:
+    bezier_patch_bvh(const varmesh<4>& m, int max_depth = 6, double flatness_tolerance = 1E-3);
+
+    // recomputes leaves and bounds for moved control points of a patch with the same degree, keeping the topology
+    void refit(const varmesh<4>& m);
+
+    // leaves whose convex hull is intersected by the line, in front to back order of their bounding boxes; result and
+    // projection_coordinates are buffers of the caller, reused from ray to ray
+    void intersected_leaves(const v3& origin, const v3& direction, std::vector<int>& result, std::vector<v2>& projection_coordinates) const;
+
+    // true, if the convex hull of any leaf is intersected by the line; conservative test whether the patch can be hit
+    bool intersects_leaf(const v3& origin, const v3& direction, std::vector<v2>& projection_coordinates) const;
+
+    const patch_bvh_leaf& leaf(int index) const { return leaves[index]; }
+    const patch_bvh_node& node(int index) const { return nodes[index]; }
+    const bounding_box& bounds() const { return nodes[0].bounds; }
+
+    size_t leaf_count() const { return leaves.size(); }
+    size_t node_count() const { return nodes.size(); }
+
+    static const int maximal_depth = 16;
+
+private:
+    void build(int index, const varmesh<4>& m, const v2& u, const v2& v, int depth, int max_depth, double flatness_tolerance);
+    void refit(int index, const varmesh<4>& m);
+
+    // calls visit for every leaf with intersected convex hull, until it returns false
+    template<class visitor> void visit_intersected_leaves(const v3& origin, const v3& direction, std::vector<v2>& projection_coordinates, visitor visit) const;
+
+    std::vector<patch_bvh_node> nodes;
+    std::vector<patch_bvh_leaf> leaves;
+};
+
+struct surface_bvh_node
+{
+    bounding_box bounds;
+    int parent;
+    // the two children are stored consecutively, -1 for leaves
+    int first_child;
+    // index of the surface, -1 for inner nodes
+    int surface;
+};
+
+// binary tree over the bounding boxes of the surfaces of a scene, split at the median of the longest axis
+class surface_bvh
+{
+public:
+    surface_bvh() = default;
+    surface_bvh(const std::vector<bounding_box>& surface_bounds);
+
+    // replaces the bounds of one surface and refits the nodes on the path to the root
+    void refit(int surface, const bounding_box& bounds);
+
+    // surfaces whose bounds are intersected by the ray in front of origin, as pairs of entry and surface index, front to
+    // back; result and stack are buffers of the caller, reused from ray to ray
+    void intersected_surfaces(const v3& origin, const v3& direction, std::vector<std::pair<double, int>>& result, std::vector<std::pair<double, int>>& stack) const;
+
+    const surface_bvh_node& node(int index) const { return nodes[index]; }
+    size_t node_count() const { return nodes.size(); }
+
+private:
+    void build(int index, std::vector<std::pair<v3, int>>::iterator begin, std::vector<std::pair<v3, int>>::iterator end, const std::vector<bounding_box>& surface_bounds);
+
+    std::vector<surface_bvh_node> nodes;
+    std::vector<int> leaf_of_surface;
+};
+
+#endif
@@ -1,6 +1,8 @@
 #include "bilinear_patch_intersection.h"
 
 #include <math.h>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 class ostream;
@@ -609,4 +611,120 @@ std::vector<v2> bilinear_patch_roots(const varmesh<2>& mesh, double epsilon)
    // }
 
     return intersections;
-}
\ No newline at end of file
+}
+
+namespace
+{
+    double cross(const v2& a, const v2& b)
+    {
+        return a[0] * b[1] - a[1] * b[0];
+    }
+
+    // roots of a t^2 + b t + c in [-epsilon, 1 + epsilon], using the cancellation free form of the quadratic formula
+    int quadratic_roots_in_unit_interval(double a, double b, double c, double epsilon, std::array<double, 2>& t)
+    {
+        double scale = std::max({ std::abs(a), std::abs(b), std::abs(c) });
+
+        if (scale == 0)
+        {
+            return 0;
+        }
+
+        std::array<double, 2> candidates;
+        int count = 0;
+
+        if (std::abs(a) <= 1E-12 * scale)
+        {
+            if (std::abs(b) <= 1E-12 * scale)
+            {
+                return 0;
+            }
+
+            candidates[count++] = -c / b;
+        }
+        else
+        {
+            double d = b * b - 4 * a * c;
+
+            if (d < 0)
+            {
+                // a double root can become slightly negative by rounding
+                if (d < -1E-12 * b * b)
+                {
+                    return 0;
+                }
+                d = 0;
+            }
+
+            double q = -0.5 * (b + std::copysign(std::sqrt(d), b));
+
+            if (q == 0)
+            {
+                candidates[count++] = 0;
+            }
+            else
+            {
+                candidates[count++] = c / q;
+
+                if (0 < d)
+                {
+                    candidates[count++] = q / a;
+                }
+            }
+        }
+
+        int found = 0;
+
+        for (int i = 0; i < count; i++)
+        {
+            if (-epsilon <= candidates[i] && candidates[i] <= 1 + epsilon)
+            {
+                t[found++] = std::clamp(candidates[i], 0., 1.);
+            }
+        }
+
+        return found;
+    }
+}
+
+int bilinear_patch_roots_analytic(const varmesh<2>& mesh, double epsilon, std::array<v2, 2>& roots)
+{
+    // S(u, v) = a + u b + v c + u v d, the columns are the u direction
+    const v2& p00 = mesh.element(0, 0);
+    v2 b = mesh.element(0, 1) - p00;
+    v2 c = mesh.element(1, 0) - p00;
+    v2 d = mesh.element(1, 1) - mesh.element(0, 1) - c;
+
+    // S(u, v) = (a + v c) + u (b + v d) vanishes, if both are parallel
+    std::array<double, 2> vs;
+    int v_count = quadratic_roots_in_unit_interval(cross(c, d), cross(p00, d) + cross(c, b), cross(p00, b), epsilon, vs);
+
+    int count = 0;
+
+    for (int i = 0; i < v_count; i++)
+    {
+        double v = vs[i];
+
+        v2 edge_origin = p00 + v * c;
+        v2 edge = b + v * d;
+
+        double edge_length2 = edge * edge;
+
+        if (edge_length2 < 1E-24 * (edge_origin * edge_origin))
+        {
+            // the u edge degenerates to a point, which isn't the origin
+            continue;
+        }
+
+        double u = 0 == edge_length2 ? 0.5 : -(edge_origin * edge) / edge_length2;
+
+        if (u < -epsilon || 1 + epsilon < u)
+        {
+            continue;
+        }
+
+        roots[count++] = v2{ {std::clamp(u, 0., 1.), v} };
+    }
+
+    return count;
+}
@@ -5,4 +5,9 @@
 
 std::vector<v2> bilinear_patch_roots(const varmesh<2>& mesh, double epsilon);
 
+// closed form roots (u, v) of the projected bilinear patch, without allocations: the v of a root makes the two u edges
+// of the patch at v parallel (a quadratic in v), u follows from the projection of the origin onto the u edge at v;
+// roots outside [0, 1]^2 by more than epsilon are dropped, the others are clamped; returns the number of roots
+int bilinear_patch_roots_analytic(const varmesh<2>& mesh, double epsilon, std::array<v2, 2>& roots);
+
 #endif
\ No newline at end of file
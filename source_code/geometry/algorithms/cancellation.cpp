@@ -0,0 +1,29 @@
+#include "cancellation.h"
+
+cancellation_token::cancellation_token(std::chrono::steady_clock::time_point deadline) : has_deadline(true), deadline(deadline)
+{
+}
+
+bool cancellation_token::is_cancelled() const
+{
+    if (cancelled.load(std::memory_order_relaxed))
+    {
+        return true;
+    }
+
+    if (has_deadline && deadline <= std::chrono::steady_clock::now())
+    {
+        cancelled.store(true, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    return false;
+}
+
+const cancellation_token*& thread_cancellation_token()
+{
+    thread_local const cancellation_token* token = nullptr;
+
+    return token;
+}
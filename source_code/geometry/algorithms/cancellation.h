@@ -0,0 +1,56 @@
+#ifndef cancellation_h
+#define cancellation_h
+
+#include <atomic>
+#include <chrono>
+
+// cooperative cancellation of a render; cancel may be called from any thread, the tracers poll the token between
+// tiles and the clipping loops poll the token of their thread, see thread_cancellation_token
+class cancellation_token
+{
+public:
+    cancellation_token() = default;
+    // cancelled by itself, once the deadline has passed
+    explicit cancellation_token(std::chrono::steady_clock::time_point deadline);
+
+    void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+    bool is_cancelled() const;
+
+private:
+    mutable std::atomic<bool> cancelled{ false };
+    bool has_deadline = false;
+    std::chrono::steady_clock::time_point deadline;
+};
+
+// the token polled by the clipping loops of the calling thread, nullptr if they run to the end
+const cancellation_token*& thread_cancellation_token();
+
+inline bool thread_cancellation_requested()
+{
+    const cancellation_token* token = thread_cancellation_token();
+
+    return nullptr != token && token->is_cancelled();
+}
+
+// sets the token of the calling thread for its lifetime
+class scoped_cancellation_token
+{
+public:
+    scoped_cancellation_token(const cancellation_token* token) : previous(thread_cancellation_token())
+    {
+        thread_cancellation_token() = token;
+    }
+
+    ~scoped_cancellation_token()
+    {
+        thread_cancellation_token() = previous;
+    }
+
+    scoped_cancellation_token(const scoped_cancellation_token&) = delete;
+    scoped_cancellation_token& operator=(const scoped_cancellation_token&) = delete;
+
+private:
+    const cancellation_token* previous;
+};
+
+#endif
@@ -116,7 +116,32 @@ bool is_origin_in_convex_hull_atan2(std::vector<v2> points)
     return true;
 }
 
+bool intersects_convex_hull(const v4 &horizontal_plane, const v4 &vertical_plane, const varmesh<4> &m, std::vector<v2> &projection_coordinates)
+{
+    projection_coordinates.clear();
+
+    for (int i = 0; i < m.row_size(); i++)
+    {
+        for (int j = 0; j < m.col_size(); j++)
+        {
+            v4 point_with_added_dim = add_dimension(remove_dimension(m.element(i, j)));
+            v2 projection_coordinated_point{{horizontal_plane * point_with_added_dim, vertical_plane * point_with_added_dim}};
+            projection_coordinates.push_back(projection_coordinated_point);
+
+            if (projection_coordinated_point == v2{{0, 0}})
+                return true;
+        }
+    }
+
+    return is_origin_in_convex_hull_in_place(projection_coordinates);
+}
+
 bool is_origin_in_convex_hull(std::vector<v2> points)
+{
+    return is_origin_in_convex_hull_in_place(points);
+}
+
+bool is_origin_in_convex_hull_in_place(std::span<v2> points)
 {
     std::sort(points.begin(), points.end(), compare_polar);
     
@@ -153,7 +178,7 @@ bool intersects_e1_halfline(const v2& p, const v2 q)
     return 0 <= intersection && 0 <= ratio && 1 >= ratio;
 }
 
-bool origin_inside_polygon(const std::vector<v2> &polygon)
+bool origin_inside_polygon(std::span<const v2> polygon)
 {
     int intersections = 0;
     
@@ -254,49 +279,3 @@ bool circle_overlaps_polygon(double radius, const std::vector<v<2>> &polygon)
     return origin_inside_polygon(polygon);
 }
 
-std::vector<v3> get_points(const varmesh<4> &m)
-{
-    std::vector<v3> result;
-
-    for (int i = 0; i < m.row_size(); i++)
-    {
-        for (int j = 0; j < m.col_size(); j++)
-        {
-            result.push_back(remove_dimension(m.element(i, j)));
-        }
-    }
-
-    return result;
-}
-
-std::vector<int> intersects_mesh(const v3& origin, const v3& ray, const std::vector<varmesh<4>>& meshes_hierarchy)
-{
-    std::vector<int> intersected_meshes;
-
-    std::deque<size_t> mesh_index_to_intersect;
-    mesh_index_to_intersect.push_back(0);
-
-    while (!mesh_index_to_intersect.empty())
-    {
-        size_t index = mesh_index_to_intersect.front();
-        mesh_index_to_intersect.pop_front();
-        if (intersects_convex_hull(origin, ray, get_points(meshes_hierarchy[index])))
-        {
-            size_t new_index = 4 * index + 1;
-            if (new_index < meshes_hierarchy.size())
-            {
-                for (int i = 0; i < 4; i++)
-                {
-                    mesh_index_to_intersect.push_back(new_index + i);
-                }
-            }
-            else
-            {
-                intersected_meshes.push_back(index);
-            }
-        }
-    }
-
-    return intersected_meshes;
-}
-
@@ -3,6 +3,7 @@
 
 #include <deque>
 #include <numbers>
+#include <span>
 #include <vector>
 
 #include <geometry/linear_algebra/formulas.h>
@@ -14,17 +15,17 @@ double intersection_with_triangle(const v3 &origin, const v3 &direction, const v
 bool intersects_convex_hull(const v3 &origin, const v3 &dir, const std::vector<v3> &points);
 bool is_origin_in_convex_hull_atan2(std::vector<v2> points);
 bool is_origin_in_convex_hull(std::vector<v2> points);
+// allocation free variants: the planes are those of the ray, the scratch vector is reused and the points are sorted in place
+bool intersects_convex_hull(const v4 &horizontal_plane, const v4 &vertical_plane, const varmesh<4> &m, std::vector<v2> &projection_coordinates);
+bool is_origin_in_convex_hull_in_place(std::span<v2> points);
 
 bool intersects_e1_halfline(const v2& p, const v2 q);
-bool origin_inside_polygon(const std::vector<v2> &polygon);
+bool origin_inside_polygon(std::span<const v2> polygon);
 bool inside_polygon(const v2& point, const std::vector<v2> &polygon);
 v2 closest_point_to_origin_of_segment(const v2& p, const v2& q);
 bool origin_circle_overlaps_segment(const v2& p, const v2& q, double radius2);
 bool circle_overlaps_polygon(double radius, const std::vector<v<2>> &polygon);
 
-
-std::vector<int> intersects_mesh(const v3& origin, const v3& ray, const std::vector<varmesh<4>>& meshes_hierarchy);
-
 template<size_t N> double bezier_max_deviation_to_quasi_interpolation(const std::vector<v<N>> &points)
 {
     double z_coeff = bezier_z_coefficient(points.size() - 1);
@@ -61,12 +62,12 @@ template<typename C> double bezier_max_deviation_to_quasi_interpolation_vec(cons
     return max_abs * z_coeff;
 }
 
-template<size_t N> double bezier_max_deviation_to_quasi_interpolation(const varmesh<N> &m)
+template<size_t N, class T> double bezier_max_deviation_to_quasi_interpolation(const varmesh<N, T> &m)
 {
     double max_dev_rows = 0;
     for (int i = 0; i < m.row_size(); i++)
     {
-        auto cur_row = row_ref_const<N>(m, i);
+        auto cur_row = row_ref_const<N, T>(m, i);
         double crl = bezier_max_deviation_to_quasi_interpolation_vec(cur_row);
         if (max_dev_rows < crl)
         {
@@ -78,7 +79,7 @@ template<size_t N> double bezier_max_deviation_to_quasi_interpolation(const varm
     
     for (int i = 0; i < m.col_size(); i++)
     {
-        auto cur_col = col_ref_const<N>(m, i);
+        auto cur_col = col_ref_const<N, T>(m, i);
         double ccl = bezier_max_deviation_to_quasi_interpolation_vec(cur_col);
         if (max_dev_cols < ccl)
         {
@@ -0,0 +1,40 @@
+#include "intersection_statistics.h"
+
+intersection_statistics& operator+=(intersection_statistics& total, const intersection_statistics& s)
+{
+    total.clipping_steps += s.clipping_steps;
+    total.newton_starts += s.newton_starts;
+    total.newton_iterations += s.newton_iterations;
+    total.newton_roots += s.newton_roots;
+    total.newton_fallbacks += s.newton_fallbacks;
+    total.float_solves += s.float_solves;
+    total.double_resolves += s.double_resolves;
+    total.seeded_windows += s.seeded_windows;
+    total.bounds_tests += s.bounds_tests;
+    total.box_rejections += s.box_rejections;
+    total.sphere_rejections += s.sphere_rejections;
+
+    return total;
+}
+
+std::ostream& operator<<(std::ostream& os, const intersection_statistics& s)
+{
+    return os << "clipping steps: " << s.clipping_steps
+        << ", newton starts: " << s.newton_starts
+        << ", newton iterations: " << s.newton_iterations
+        << ", newton roots: " << s.newton_roots
+        << ", newton fallbacks: " << s.newton_fallbacks
+        << ", float solves: " << s.float_solves
+        << ", double resolves: " << s.double_resolves
+        << ", seeded windows: " << s.seeded_windows
+        << ", bounds tests: " << s.bounds_tests
+        << ", box rejections: " << s.box_rejections
+        << ", sphere rejections: " << s.sphere_rejections;
+}
+
+intersection_statistics& thread_intersection_statistics()
+{
+    thread_local intersection_statistics statistics;
+
+    return statistics;
+}
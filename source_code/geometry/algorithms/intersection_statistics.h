@@ -0,0 +1,36 @@
+#ifndef intersection_statistics_h
+#define intersection_statistics_h
+
+#include <ostream>
+
+// counters of the root finders; each thread counts into its own instance, see thread_intersection_statistics
+struct intersection_statistics
+{
+    // windows taken from the queue of the clipping loops
+    long long clipping_steps = 0;
+    // windows handed over to newton, because they passed the isolation test
+    long long newton_starts = 0;
+    long long newton_iterations = 0;
+    long long newton_roots = 0;
+    // newton left the window or didn't converge, clipping continued
+    long long newton_fallbacks = 0;
+    // intersections solved in float by the float_first solver
+    long long float_solves = 0;
+    // float results, that were ambiguous and solved again in double
+    long long double_resolves = 0;
+    // parameter windows solved by the hybrid tracer, each seeded by a triangle hit
+    long long seeded_windows = 0;
+    // patches tested against their precomputed bounds before projection, and those rejected by the box or else the sphere
+    long long bounds_tests = 0;
+    long long box_rejections = 0;
+    long long sphere_rejections = 0;
+};
+
+intersection_statistics& operator+=(intersection_statistics& total, const intersection_statistics& s);
+
+std::ostream& operator<<(std::ostream& os, const intersection_statistics& s);
+
+// counters of the calling thread
+intersection_statistics& thread_intersection_statistics();
+
+#endif
@@ -0,0 +1,127 @@
+#include "patch_bounds.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <geometry/algorithms/bezier_patch_bvh.h>
+#include <geometry/algorithms/intersection_statistics.h>
+
+patch_bounds::patch_bounds(const std::vector<varmesh<4>>& meshes) : count(meshes.size())
+{
+    block empty;
+
+    for (int k = 0; k < 3; k++)
+    {
+        empty.lower[k].fill(std::numeric_limits<double>::max());
+        empty.upper[k].fill(-std::numeric_limits<double>::max());
+        empty.centre[k].fill(0);
+    }
+    empty.radius2.fill(-1);
+
+    blocks.resize((meshes.size() + block_width - 1) / block_width, empty);
+
+    for (int i = 0; i < meshes.size(); i++)
+    {
+        update(i, meshes[i]);
+    }
+}
+
+void patch_bounds::update(int patch, const varmesh<4>& m)
+{
+    block& b = blocks[patch / block_width];
+    int lane = patch % block_width;
+
+    bounding_box box = bounding_box_of_mesh(m);
+
+    // roots are accepted up to the tolerance of the solvers, slightly outside the hull
+    double padding = 1E-9 * (1 + length(box.upper - box.lower));
+
+    v3 centre = 0.5 * (box.lower + box.upper);
+
+    double radius2 = 0;
+    for (int i = 0; i < m.row_size(); i++)
+    {
+        for (int j = 0; j < m.col_size(); j++)
+        {
+            radius2 = std::max(radius2, length2(remove_dimension(m.element(i, j)) - centre));
+        }
+    }
+
+    for (int k = 0; k < 3; k++)
+    {
+        b.lower[k][lane] = box.lower[k] - padding;
+        b.upper[k][lane] = box.upper[k] + padding;
+        b.centre[k][lane] = centre[k];
+    }
+
+    double radius = std::sqrt(radius2) + padding;
+    b.radius2[lane] = radius * radius;
+}
+
+void patch_bounds::candidates(const v3& origin, const v3& direction, std::vector<int>& result) const
+{
+    // a huge instead of an infinite inverse keeps the slabs of axis parallel rays free of nan
+    v3 inverse;
+    for (int k = 0; k < 3; k++)
+    {
+        inverse[k] = 0 == direction[k] ? std::numeric_limits<double>::max() : 1 / direction[k];
+    }
+
+    double direction2 = direction * direction;
+
+    intersection_statistics& statistics = thread_intersection_statistics();
+
+    for (int index = 0; index < blocks.size(); index++)
+    {
+        const block& b = blocks[index];
+
+        std::array<double, block_width> t_entry, t_exit, distance2;
+        t_entry.fill(0);
+        t_exit.fill(std::numeric_limits<double>::max());
+
+        for (int k = 0; k < 3; k++)
+        {
+            for (int lane = 0; lane < block_width; lane++)
+            {
+                double t0 = (b.lower[k][lane] - origin[k]) * inverse[k];
+                double t1 = (b.upper[k][lane] - origin[k]) * inverse[k];
+
+                t_entry[lane] = std::max(t_entry[lane], std::min(t0, t1));
+                t_exit[lane] = std::min(t_exit[lane], std::max(t0, t1));
+            }
+        }
+
+        // squared distance of the centre to the half line
+        for (int lane = 0; lane < block_width; lane++)
+        {
+            double cx = b.centre[0][lane] - origin[0];
+            double cy = b.centre[1][lane] - origin[1];
+            double cz = b.centre[2][lane] - origin[2];
+
+            double along = std::max(0., cx * direction[0] + cy * direction[1] + cz * direction[2]);
+
+            distance2[lane] = cx * cx + cy * cy + cz * cz - along * along / direction2;
+        }
+
+        int lanes = std::min<int>(block_width, count - index * block_width);
+
+        for (int lane = 0; lane < lanes; lane++)
+        {
+            statistics.bounds_tests++;
+
+            if (t_exit[lane] < t_entry[lane])
+            {
+                statistics.box_rejections++;
+            }
+            else if (b.radius2[lane] < distance2[lane])
+            {
+                statistics.sphere_rejections++;
+            }
+            else
+            {
+                result.push_back(index * block_width + lane);
+            }
+        }
+    }
+}
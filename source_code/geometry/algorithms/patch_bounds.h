@@ -0,0 +1,43 @@
+#ifndef patch_bounds_h
+#define patch_bounds_h
+
+#include <array>
+#include <vector>
+
+#include <geometry/types/vector.h>
+#include <geometry/types/varmesh.h>
+
+// bounding boxes and bounding spheres of the control points of patches, stored coordinate by coordinate in blocks of
+// block_width patches, so that the tests of one ray against a block vectorize
+class patch_bounds
+{
+public:
+    static const int block_width = 8;
+
+    patch_bounds() = default;
+    patch_bounds(const std::vector<varmesh<4>>& meshes);
+
+    // recomputes the bounds of one patch
+    void update(int patch, const varmesh<4>& m);
+
+    // appends the patches, whose box and sphere are both hit by the ray in front of origin; counts the tests and
+    // rejections into the statistics of the thread
+    void candidates(const v3& origin, const v3& direction, std::vector<int>& result) const;
+
+    size_t size() const { return count; }
+
+private:
+    struct block
+    {
+        alignas(64) std::array<double, block_width> lower[3];
+        alignas(64) std::array<double, block_width> upper[3];
+        alignas(64) std::array<double, block_width> centre[3];
+        // negative for unused lanes
+        alignas(64) std::array<double, block_width> radius2;
+    };
+
+    std::vector<block> blocks;
+    size_t count = 0;
+};
+
+#endif
@@ -3,9 +3,13 @@
 #include <geometry/types/bezier_curve.h>
 #include <geometry/types/bezier_surface.h>
 #include <geometry/algorithms/bilinear_patch_intersection.h>
+#include <geometry/algorithms/cancellation.h>
+#include <geometry/algorithms/scratch_arena.h>
+#include <geometry/algorithms/render_trace.h>
 
 #include <iostream>
 #include <algorithm>
+#include <limits>
 
 std::vector<double> crossing(double a, double b)
 {
@@ -70,7 +74,7 @@ v2 new_window(double e00, double e01, double e10, double e11)
     return v2{ 1, 0 };
 }
 
-v2 new_window_u(varmesh<2> mesh, int index)
+v2 new_window_u(const varmesh<2>& mesh, int index)
 {
     auto u0_window = new_window(mesh.element(0, 0)[0], mesh.element(0, 1)[0], mesh.element(1, 0)[0], mesh.element(1, 1)[0]);
     auto u1_window = new_window(mesh.element(0, 0)[1], mesh.element(0, 1)[1], mesh.element(1, 0)[1], mesh.element(1, 1)[1]);
@@ -83,7 +87,7 @@ v2 new_window_u(varmesh<2> mesh, int index)
     return v2{ 1, 0 };
 }
 
-v2 new_window_v(varmesh<2> mesh, int index)
+v2 new_window_v(const varmesh<2>& mesh, int index)
 {
     auto v0_window = new_window(mesh.element(0, 0)[0], mesh.element(1, 0)[0], mesh.element(0, 1)[0], mesh.element(1, 1)[0]);
     auto v1_window = new_window(mesh.element(0, 0)[1], mesh.element(1, 0)[1], mesh.element(0, 1)[1], mesh.element(1, 1)[1]);
@@ -96,27 +100,46 @@ v2 new_window_v(varmesh<2> mesh, int index)
     return v2{ 1, 0 };
 }
 
-std::vector<v2> bilinear_patch_roots_clipping(varmesh<2> mesh, double epsilon)
+// clipping steps between two polls of the cancellation token of the thread, which may read the clock
+const int cancellation_poll_interval = 16;
+
+std::vector<v2> bilinear_patch_roots_clipping(const varmesh<2>& mesh, double epsilon)
 {
+    RENDER_TRACE_DETAIL_SPAN("clipping");
+
     std::vector<v2> roots;
 
     int iteration = 0;
 
-    std::deque<std::pair<v2, v2>> q;
+    scratch_scope scratch;
+
+    std::pmr::deque<std::pair<v2, v2>> q(scratch.resource());
+
+    varmesh<2> cm(mesh, scratch.resource());
 
     q.push_back({ {0, 1}, {0, 1} });
 
+    auto& statistics = thread_intersection_statistics();
+
     while (!q.empty())
     {
         if (iteration > 1000)
         {
             break;
         }
+        statistics.clipping_steps++;
+
+        // the roots found so far, the caller discards the result of a cancelled render
+        if (0 == statistics.clipping_steps % cancellation_poll_interval && thread_cancellation_requested())
+        {
+            break;
+        }
+
         auto cw = q.front();
 
         q.pop_front();
 
-        auto cm{ mesh };
+        cm = mesh;
         bezier_clip_surface(cm, cw.first, cw.second);
 
         auto nw_u = new_window_u(cm, 0);
@@ -270,10 +293,17 @@ std::vector<double> get_intersections_quasi(const v2 &origin, const v2 &directio
     return bezier_quasi_interpolation_clipping(projected_points, epsilon);
 }
 
-std::vector<std::vector<bool>> does_increased_mesh_contain_origin(const varmesh<2>& mesh, double offset)
+std::pmr::vector<bool> does_increased_mesh_contain_origin(const varmesh<2, float>& mesh, double offset, std::pmr::memory_resource* resource)
 {
-    std::vector<std::vector<bool>> overlaps(mesh.row_size() - 1, std::vector<bool>(mesh.col_size() - 1, false));
-    std::vector<std::vector<double>> dist2_to_origin(mesh.row_size(), std::vector<double>(mesh.col_size(), 0));
+    return does_increased_mesh_contain_origin(mesh_cast<double>(mesh, resource), offset, resource);
+}
+
+std::pmr::vector<bool> does_increased_mesh_contain_origin(const varmesh<2>& mesh, double offset, std::pmr::memory_resource* resource)
+{
+    size_t cells = mesh.col_size() - 1;
+
+    std::pmr::vector<bool> overlaps((mesh.row_size() - 1) * cells, false, resource);
+    std::pmr::vector<double> dist2_to_origin(mesh.row_size() * mesh.col_size(), 0, resource);
 
     double offset2 = offset * offset;
 
@@ -281,7 +311,7 @@ std::vector<std::vector<bool>> does_increased_mesh_contain_origin(const varmesh<
     {
         for (int j = 0; j < mesh.col_size(); j++)
         {
-            dist2_to_origin[i][j] = length2(mesh.element(i, j));
+            dist2_to_origin[i * mesh.col_size() + j] = length2(mesh.element(i, j));
         }
     }
 
@@ -289,7 +319,7 @@ std::vector<std::vector<bool>> does_increased_mesh_contain_origin(const varmesh<
     {
         for (int j = 0; j < mesh.col_size() - 1; j++)
         {
-            bool cur_overlaps = dist2_to_origin[i][j] <= offset2 || dist2_to_origin[i][j + 1] <= offset2;
+            bool cur_overlaps = dist2_to_origin[i * mesh.col_size() + j] <= offset2 || dist2_to_origin[i * mesh.col_size() + j + 1] <= offset2;
 
             if (!cur_overlaps)
             {
@@ -320,11 +350,11 @@ std::vector<std::vector<bool>> does_increased_mesh_contain_origin(const varmesh<
             {
                 if (0 < i)
                 {
-                    overlaps[i - 1][j] = true;
+                    overlaps[(i - 1) * cells + j] = true;
                 }
                 if (i < mesh.row_size() - 1)
                 {
-                    overlaps[i][j] = true;
+                    overlaps[i * cells + j] = true;
                 }
             }
         }
@@ -333,7 +363,7 @@ std::vector<std::vector<bool>> does_increased_mesh_contain_origin(const varmesh<
     {
         for (int j = 0; j < mesh.col_size(); j++)
         {
-            bool cur_overlaps = dist2_to_origin[i][j] <= offset2 || dist2_to_origin[i + 1][j] <= offset2;
+            bool cur_overlaps = dist2_to_origin[i * mesh.col_size() + j] <= offset2 || dist2_to_origin[(i + 1) * mesh.col_size() + j] <= offset2;
 
             if (!cur_overlaps)
             {
@@ -363,11 +393,11 @@ std::vector<std::vector<bool>> does_increased_mesh_contain_origin(const varmesh<
             {
                 if (0 < j)
                 {
-                    overlaps[i][j - 1] = true;
+                    overlaps[i * cells + j - 1] = true;
                 }
                 if (j < mesh.col_size() - 1)
                 {
-                    overlaps[i][j] = true;
+                    overlaps[i * cells + j] = true;
                 }
             }
         }
@@ -377,18 +407,14 @@ std::vector<std::vector<bool>> does_increased_mesh_contain_origin(const varmesh<
     {
         for (int j = 0; j < mesh.col_size() - 1; j++)
         {
-            bool cur_overlap = overlaps[i][j];
+            bool cur_overlap = overlaps[i * cells + j];
             if (!cur_overlap)
             {
-                std::vector<v2> quad(4, v2{ {0, 0} });
-                quad[0] = (mesh.element(i, j));
-                quad[1] = (mesh.element(i, j + 1));
-                quad[2] = (mesh.element(i + 1, j + 1));
-                quad[3] = (mesh.element(i + 1, j));
+                std::array<v2, 4> quad{ mesh.element(i, j), mesh.element(i, j + 1), mesh.element(i + 1, j + 1), mesh.element(i + 1, j) };
 
                 cur_overlap = origin_inside_polygon(quad);
 
-                overlaps[i][j] = cur_overlap;
+                overlaps[i * cells + j] = cur_overlap;
             }
         }
     }
@@ -401,25 +427,143 @@ int signum(double d)
     return d > 0 ? 1 : (d < 0 ? -1 : 0);
 }
 
-std::vector<v2> bezier_quasi_interpolation_clipping(const varmesh<2> &points, double epsilon)
+double cross_product_2d(const v2& p, const v2& q)
 {
-    if (points.col_size() == 2 && points.row_size() == 2)
+    return p[0] * q[1] - p[1] * q[0];
+}
+
+bool is_root_isolating(const varmesh<2>& m, double minimal_sine)
+{
+    int orientation = 0;
+
+    for (int i = 0; i < m.row_size(); i++)
+    {
+        for (int j = 0; j < m.col_size() - 1; j++)
+        {
+            v2 du = m.element(i, j + 1) - m.element(i, j);
+            double du_length = length(du);
+
+            for (int k = 0; k < m.row_size() - 1; k++)
+            {
+                for (int l = 0; l < m.col_size(); l++)
+                {
+                    v2 dv = m.element(k + 1, l) - m.element(k, l);
+
+                    double cross = cross_product_2d(du, dv);
+
+                    if (std::fabs(cross) <= minimal_sine * du_length * length(dv))
+                    {
+                        return false;
+                    }
+
+                    if (orientation != 0 && orientation != signum(cross))
+                    {
+                        return false;
+                    }
+
+                    orientation = signum(cross);
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+std::optional<v2> newton_root_of_patch(const varmesh<2>& m, double tolerance, int max_iterations)
+{
+    auto& statistics = thread_intersection_statistics();
+
+    scratch_scope scratch;
+
+    v2 uv{ {0.5, 0.5} };
+
+    for (int iteration = 0; iteration < max_iterations; iteration++)
     {
-        return bilinear_patch_roots_clipping(points, epsilon); // 
+        statistics.newton_iterations++;
+
+        auto derivatives = evaluate_bezier_surface_with_derivatives(m, uv[0], uv[1], scratch.resource());
+
+        const v2& value = derivatives[0];
+        const v2& du = derivatives[1];
+        const v2& dv = derivatives[2];
+
+        double determinant = cross_product_2d(du, dv);
+
+        if (0 == determinant)
+        {
+            return {};
+        }
+
+        v2 step{ {cross_product_2d(dv, value) / determinant, cross_product_2d(value, du) / determinant} };
+
+        uv = uv + step;
+
+        if (uv[0] < -tolerance || uv[0] > 1 + tolerance || uv[1] < -tolerance || uv[1] > 1 + tolerance)
+        {
+            return {};
+        }
+
+        if (l_inf(step) < tolerance)
+        {
+            return v2{ {std::clamp(uv[0], 0., 1.), std::clamp(uv[1], 0., 1.)} };
+        }
     }
+
+    return {};
+}
+
+// the clipping loop for both scalar types; with 0 < max_steps it gives up (empty optional), if it takes more steps
+// or if the windows get smaller than epsilon while the deviation doesn't
+template<class T> std::optional<std::vector<v2>> quasi_interpolation_clipping(const varmesh<2, T>& points, double epsilon, intersection_solver solver, int max_steps)
+{
+    RENDER_TRACE_DETAIL_SPAN("clipping");
+
     std::vector<v2> intersections;
+
+    // the work queue and the meshes of the steps live in the scratch arena of the thread
+    scratch_scope scratch;
     
-    std::deque<std::pair<v2, v2>> q;
+    std::pmr::deque<std::pair<v2, v2>> q(scratch.resource());
     
     q.push_back(std::make_pair(v2{{0, 1}}, v2{{0, 1}}));
     
-    varmesh<2> clipped_mesh(points.row_size(), points.col_size());
+    varmesh<2, T> clipped_mesh(points.row_size(), points.col_size(), scratch.resource());
+    std::pmr::vector<v2> hull_points(scratch.resource());
 
     int iteration_count = 0;
+
+    auto& statistics = thread_intersection_statistics();
+
+    // the control points carry the rounding error of the float projection, the meshes are increased by it
+    double rounding_error = 0;
+
+    if constexpr (std::is_same_v<T, float>)
+    {
+        for (int i = 0; i < points.row_size(); i++)
+        {
+            for (int j = 0; j < points.col_size(); j++)
+            {
+                const auto& p = points.element(i, j);
+                rounding_error = std::max(rounding_error, 8 * std::numeric_limits<float>::epsilon() * length(v2{ {p[0], p[1]} }));
+            }
+        }
+    }
     
     while(!q.empty())
     {
         iteration_count++;
+        statistics.clipping_steps++;
+
+        if (0 < max_steps && max_steps < iteration_count)
+        {
+            return std::nullopt;
+        }
+
+        if (0 == statistics.clipping_steps % cancellation_poll_interval && thread_cancellation_requested())
+        {
+            break;
+        }
 
         auto windows = q.front();
         q.pop_front();
@@ -427,15 +571,60 @@ std::vector<v2> bezier_quasi_interpolation_clipping(const varmesh<2> &points, do
         clipped_mesh = points;
         
         bezier_clip_surface(clipped_mesh, windows.first, windows.second);
+
+        double window_diff_u = windows.first[1] - windows.first[0];
+        double window_diff_v = windows.second[1] - windows.second[0];
+
+        // newton runs in double only
+        if constexpr (std::is_same_v<T, double>)
+        {
+            if (intersection_solver::hybrid == solver && is_root_isolating(clipped_mesh, newton_minimal_sine))
+            {
+                hull_points.clear();
+
+                for (int i = 0; i < clipped_mesh.row_size(); i++)
+                {
+                    for (int j = 0; j < clipped_mesh.col_size(); j++)
+                    {
+                        hull_points.push_back(clipped_mesh.element(i, j));
+                    }
+                }
+
+                // the patch lies in the convex hull of its control points
+                if (!is_origin_in_convex_hull_in_place(hull_points))
+                {
+                    continue;
+                }
+
+                statistics.newton_starts++;
+
+                auto root = newton_root_of_patch(clipped_mesh, epsilon / std::max(window_diff_u, window_diff_v), newton_max_iterations);
+
+                if (root.has_value())
+                {
+                    statistics.newton_roots++;
+
+                    double u = windows.first[0] + (*root)[0] * window_diff_u;
+                    double v = windows.second[0] + (*root)[1] * window_diff_v;
+                    intersections.push_back(v2{ {u, v} });
+                    continue;
+                }
+
+                statistics.newton_fallbacks++;
+            }
+        }
         
         double max_deviation = bezier_max_deviation_to_quasi_interpolation(clipped_mesh);
         
         double max_deviation2 = max_deviation * max_deviation;
         
-        auto quasi = bezier_surface_quasi_interpolation(clipped_mesh);
-        
-        double window_diff_u = windows.first[1] - windows.first[0];
-        double window_diff_v = windows.second[1] - windows.second[0];
+        auto quasi = bezier_surface_quasi_interpolation(clipped_mesh, scratch.resource());
+
+        if (0 < max_steps && max_deviation >= epsilon && window_diff_u < epsilon && window_diff_v < epsilon)
+        {
+            // the windows can't shrink the rounding noise of the control points any further
+            return std::nullopt;
+        }
 
         if (max_deviation < epsilon && window_diff_u < epsilon && window_diff_v < epsilon)
         {
@@ -445,13 +634,13 @@ std::vector<v2> bezier_quasi_interpolation_clipping(const varmesh<2> &points, do
         }
         else
         {             
-            auto does_contain_origin = does_increased_mesh_contain_origin(quasi, max_deviation);
+            auto does_contain_origin = does_increased_mesh_contain_origin(quasi, max_deviation + rounding_error, scratch.resource());
 
             for (int i = 0; i < points.row_size() - 1; i++)
             {
                 for (int j = 0; j < points.col_size() - 1; j++)
                 {
-                    if (does_contain_origin[i][j])
+                    if (does_contain_origin[i * (points.col_size() - 1) + j])
                     {
                         double diffu = (windows.first[1] - windows.first[0]) / (points.col_size() - 1);
                         v2 sub_intervall_u{ {diffu * j + windows.first[0], diffu * (j + 1) + windows.first[0]} };
@@ -467,13 +656,105 @@ std::vector<v2> bezier_quasi_interpolation_clipping(const varmesh<2> &points, do
     return intersections;
 }
 
-std::vector<v2> get_intersections_quasi(const v3& origin, const v3& direction, const varmesh<4>& m, double epsilon)
+
+std::vector<v2> bezier_quasi_interpolation_clipping(const varmesh<2> &points, double epsilon, intersection_solver solver)
+{
+    if (points.col_size() == 2 && points.row_size() == 2)
+    {
+        // bilinear patches are solved in closed form by every solver
+        std::array<v2, 2> roots;
+
+        int count = bilinear_patch_roots_analytic(points, epsilon, roots);
+
+        return std::vector<v2>(roots.begin(), roots.begin() + count);
+    }
+
+    return *quasi_interpolation_clipping(points, epsilon, solver, 0);
+}
+
+std::optional<std::vector<v2>> bezier_quasi_interpolation_clipping(const varmesh<2, float>& points, double epsilon, int max_steps)
+{
+    return quasi_interpolation_clipping(points, epsilon, intersection_solver::clipping, max_steps);
+}
+
+bool are_float_roots_ambiguous(const varmesh<2>& m, const std::vector<v2>& roots, double epsilon)
+{
+    scratch_scope scratch;
+
+    for (int i = 0; i < roots.size(); i++)
+    {
+        for (int j = i + 1; j < roots.size(); j++)
+        {
+            double distance = length(roots[i] - roots[j]);
+
+            // one root found in neighbouring windows lies within a few windows
+            if (4 * epsilon < distance && distance < float_close_roots_distance)
+            {
+                return true;
+            }
+        }
+
+        auto derivatives = evaluate_bezier_surface_with_derivatives(m, roots[i][0], roots[i][1], scratch.resource());
+        const v2& du = derivatives[1];
+        const v2& dv = derivatives[2];
+
+        double lengths = length(du) * length(dv);
+
+        if (lengths == 0 || std::abs(du[0] * dv[1] - du[1] * dv[0]) < float_minimal_sine * lengths)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::vector<v2> get_intersections_quasi(const v3& origin, const v3& direction, const varmesh<4>& m, double epsilon, intersection_solver solver)
 {
-    v4 horizontal_plane = horizontal_plane_of_ray(origin, direction);
-    v4 vertical_plane = vertical_plane_of_ray(origin, direction);
+    auto [vertical_plane, horizontal_plane] = planes_of_ray(origin, direction);
+
+    auto& statistics = thread_intersection_statistics();
 
-    auto pm = project_mesh(m, vertical_plane, horizontal_plane);
+    // the projected meshes live in the scratch arena of the thread, only the roots are returned
+    scratch_scope scratch;
+
+    // the mesh projected in double, only when the float roots are checked or the patch is solved in double
+    std::optional<varmesh<2>> pm;
+
+    // bilinear patches are solved in double directly
+    if (intersection_solver::float_first == solver && (m.row_size() != 2 || m.col_size() != 2))
+    {
+        statistics.float_solves++;
+
+        double float_epsilon = std::max(epsilon, float_clipping_epsilon);
+
+        auto roots = bezier_quasi_interpolation_clipping(project_mesh<float>(m, vertical_plane, horizontal_plane, scratch.resource()), float_epsilon, float_clipping_max_steps);
+
+        if (roots.has_value() && roots->empty())
+        {
+            return *roots;
+        }
+
+        if (roots.has_value())
+        {
+            pm.emplace(project_mesh(m, vertical_plane, horizontal_plane, scratch.resource()));
+
+            if (!are_float_roots_ambiguous(*pm, *roots, float_epsilon))
+            {
+                return *roots;
+            }
+        }
+
+        statistics.double_resolves++;
+
+        solver = intersection_solver::clipping;
+    }
+
+    if (!pm.has_value())
+    {
+        pm.emplace(project_mesh(m, vertical_plane, horizontal_plane, scratch.resource()));
+    }
 
-    return bezier_quasi_interpolation_clipping(pm, epsilon);
+    return bezier_quasi_interpolation_clipping(*pm, epsilon, solver);
 }
 
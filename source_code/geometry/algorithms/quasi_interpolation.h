@@ -1,18 +1,56 @@
 #ifndef quasi_interpolation_hpp
 #define quasi_interpolation_hpp
 
-#include "intersection.h"
+#include <optional>
 
-std::vector<v2> bilinear_patch_roots_clipping(varmesh<2> mesh, double epsilon);
+#include "intersection.h"
+#include "intersection_statistics.h"
+
+// clipping subdivides until the windows are smaller than epsilon; hybrid hands windows, that provably contain at most
+// one root, over to newton and only falls back to clipping, if newton leaves the window; float_first clips in float
+// and solves again in double, if the float result is ambiguous
+enum class intersection_solver { clipping, hybrid, float_first };
+
+// minimal sine of the angle between the u and v differences of the control points for handing a window over to newton
+const double newton_minimal_sine = 0.05;
+const int newton_max_iterations = 16;
+
+// the float clipping stops at this window size (or the epsilon of the scene, if larger) and gives up after max steps
+const double float_clipping_epsilon = 1E-4;
+const int float_clipping_max_steps = 1024;
+// float roots closer than this are ambiguous, unless they are duplicates of one root found in neighbouring windows
+const double float_close_roots_distance = 1E-2;
+// minimal sine of the angle between the derivatives of the projected patch at a float root; below it the ray is
+// near tangent and the root is ill conditioned in float
+const double float_minimal_sine = 1E-3;
+
+std::vector<v2> bilinear_patch_roots_clipping(const varmesh<2>& mesh, double epsilon);
 std::vector<v2> bilinear_patch_roots(const varmesh<2>& mesh, double epsilon);
 
-std::vector<std::vector<bool>> does_increased_mesh_contain_origin(const varmesh<2>& mesh, double offset);
+// per cell of the control polygon, row by row, whether it contains the origin, when increased by offset
+std::pmr::vector<bool> does_increased_mesh_contain_origin(const varmesh<2>& mesh, double offset, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+std::pmr::vector<bool> does_increased_mesh_contain_origin(const varmesh<2, float>& mesh, double offset, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+
+// true, if every u difference of the control points forms a positively (or every one a negatively) oriented pair
+// with every v difference, with a sine of at least minimal_sine; the jacobian doesn't vanish on the patch then and
+// the patch is injective, so it has at most one root
+bool is_root_isolating(const varmesh<2>& m, double minimal_sine);
+
+// newton iteration on the patch starting at its centre; empty, if it leaves [0, 1]^2 or doesn't converge to tolerance
+std::optional<v2> newton_root_of_patch(const varmesh<2>& m, double tolerance, int max_iterations);
+
+std::vector<v2> bezier_quasi_interpolation_clipping(const varmesh<2> &points, double epsilon, intersection_solver solver = intersection_solver::clipping);
 
+// clipping in float with at most max_steps steps; empty, if the steps don't suffice or the rounding noise of the
+// control points doesn't allow windows of size epsilon
+std::optional<std::vector<v2>> bezier_quasi_interpolation_clipping(const varmesh<2, float>& points, double epsilon, int max_steps);
 
-std::vector<v2> bezier_quasi_interpolation_clipping(const varmesh<2> &points, double epsilon);
+// true, if the roots of m found in float can't be trusted: distinct roots close to each other or a near tangent root
+bool are_float_roots_ambiguous(const varmesh<2>& m, const std::vector<v2>& roots, double epsilon);
 
 
-std::vector<v2> get_intersections_quasi(const v3& origin, const v3& direction, const varmesh<4>& m, double epsilon);
+std::vector<v2> get_intersections_quasi(const v3& origin, const v3& direction, const varmesh<4>& m, double epsilon, intersection_solver solver = intersection_solver::clipping);
 
 
 #endif
\ No newline at end of file
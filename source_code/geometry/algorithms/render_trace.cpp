@@ -0,0 +1,119 @@
+#include "render_trace.h"
+
+#ifdef RENDER_TRACING
+
+#include <algorithm>
+#include <iomanip>
+#include <mutex>
+
+namespace
+{
+    struct trace_registry
+    {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<thread_trace>> buffers;
+        int thread_count = 0;
+    };
+
+    trace_registry& registry()
+    {
+        static trace_registry r;
+
+        return r;
+    }
+
+    std::shared_ptr<thread_trace> register_thread()
+    {
+        std::lock_guard<std::mutex> guard(registry().mutex);
+
+        auto& buffers = registry().buffers;
+
+        // only the registry holds the buffers of finished threads
+        auto finished = std::find_if(buffers.begin(), buffers.end(), [](const auto& buffer) { return 1 == buffer.use_count(); });
+
+        if (finished != buffers.end())
+        {
+            return *finished;
+        }
+
+        auto buffer = std::make_shared<thread_trace>();
+
+        buffer->thread_index = ++registry().thread_count;
+        registry().buffers.push_back(buffer);
+
+        return buffer;
+    }
+
+    void write_events(std::ostream& os, const trace_ring_buffer& buffer, int thread_index, const char*& separator)
+    {
+        // the oldest event first, the ring may have been overwritten
+        size_t count = std::min(buffer.count, buffer.capacity);
+
+        for (size_t i = buffer.count - count; i < buffer.count; i++)
+        {
+            const trace_event& event = buffer.events[i % buffer.capacity];
+
+            os << separator << "  { \"name\": \"" << event.name << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << thread_index
+                << ", \"ts\": " << event.begin_ns / 1000. << ", \"dur\": " << (event.end_ns - event.begin_ns) / 1000. << " }";
+        }
+    }
+}
+
+thread_trace& thread_trace_buffers()
+{
+    // the registry keeps the buffers, when the thread ends before the frame is written
+    thread_local std::shared_ptr<thread_trace> buffer = register_thread();
+
+    return *buffer;
+}
+
+void write_chrome_trace(std::ostream& os)
+{
+    std::lock_guard<std::mutex> guard(registry().mutex);
+
+    auto flags = os.flags();
+    auto precision = os.precision();
+
+    // microseconds with nanosecond resolution
+    os << std::fixed << std::setprecision(3);
+
+    os << "{ \"traceEvents\": [";
+
+    const char* separator = "\n";
+
+    for (const auto& buffer : registry().buffers)
+    {
+        os << separator << "  { \"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << buffer->thread_index
+            << ", \"args\": { \"name\": \"render thread " << buffer->thread_index << "\" } }";
+
+        separator = ",\n";
+
+        write_events(os, buffer->spans, buffer->thread_index, separator);
+        write_events(os, buffer->details, buffer->thread_index, separator);
+    }
+
+    os << "\n], \"displayTimeUnit\": \"ms\" }\n";
+
+    os.flags(flags);
+    os.precision(precision);
+}
+
+void clear_trace_events()
+{
+    std::lock_guard<std::mutex> guard(registry().mutex);
+
+    auto& buffers = registry().buffers;
+
+    // only the registry holds the buffers of finished threads
+    buffers.erase(std::remove_if(buffers.begin(), buffers.end(), [](const auto& buffer) { return 1 == buffer.use_count(); }), buffers.end());
+
+    for (auto& buffer : buffers)
+    {
+        buffer->spans.count = 0;
+        buffer->spans.events.clear();
+        buffer->details.count = 0;
+        buffer->details.events.clear();
+    }
+}
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef render_trace_h
+#define render_trace_h
+
+// spans of the render threads (tiles, bvh traversal, clipping, shading) for chrome://tracing or perfetto; built with
+// RENDER_TRACING only (cmake -DRENDER_TRACING=ON), otherwise RENDER_TRACE_SPAN expands to nothing
+#ifdef RENDER_TRACING
+
+#include <chrono>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+struct trace_event
+{
+    // a string literal
+    const char* name;
+    long long begin_ns;
+    long long end_ns;
+};
+
+// the last capacity events of one thread, grown up to capacity as they are recorded; only its thread writes, so
+// recording takes no lock
+struct trace_ring_buffer
+{
+    trace_ring_buffer(size_t capacity) : capacity(capacity)
+    {
+    }
+
+    size_t capacity;
+    size_t count = 0;
+    std::vector<trace_event> events;
+
+    void record(const char* name, long long begin_ns, long long end_ns)
+    {
+        if (events.size() < capacity)
+        {
+            events.push_back(trace_event{ name, begin_ns, end_ns });
+        }
+        else
+        {
+            events[count % capacity] = trace_event{ name, begin_ns, end_ns };
+        }
+        count++;
+    }
+};
+
+// nanoseconds since the start of the process
+inline long long trace_clock_ns()
+{
+    static const auto epoch = std::chrono::steady_clock::now();
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+// the spans of one thread; the tiles and rows have a ring of their own, so the many bvh traversal, clipping and
+// shading spans of a frame can't overwrite them
+struct thread_trace
+{
+    static constexpr size_t span_capacity = 1 << 16;
+    static constexpr size_t detail_capacity = 1 << 18;
+
+    int thread_index;
+    trace_ring_buffer spans{ span_capacity };
+    trace_ring_buffer details{ detail_capacity };
+};
+
+// the buffers of the calling thread, registered on their first use; a thread takes over the buffers of a finished
+// thread, so the passes of a render, each with new threads, share the buffers and thread indices
+thread_trace& thread_trace_buffers();
+
+// records the lifetime of the span in the buffers of its thread
+class trace_span
+{
+public:
+    trace_span(const char* name, bool detail = false) : name(name), detail(detail), begin_ns(trace_clock_ns())
+    {
+    }
+
+    ~trace_span()
+    {
+        thread_trace& trace = thread_trace_buffers();
+
+        (detail ? trace.details : trace.spans).record(name, begin_ns, trace_clock_ns());
+    }
+
+    trace_span(const trace_span&) = delete;
+    trace_span& operator=(const trace_span&) = delete;
+
+private:
+    const char* name;
+    bool detail;
+    long long begin_ns;
+};
+
+// the events of all threads as chrome trace json, once per frame after the render threads were joined
+void write_chrome_trace(std::ostream& os);
+
+// drops the recorded events and the buffers of finished threads; only between frames, while no thread records, as
+// the buffers of the live threads are reset without synchronization
+void clear_trace_events();
+
+#define RENDER_TRACE_CONCATENATE_(a, b) a##b
+#define RENDER_TRACE_CONCATENATE(a, b) RENDER_TRACE_CONCATENATE_(a, b)
+// tiles and rows
+#define RENDER_TRACE_SPAN(name) trace_span RENDER_TRACE_CONCATENATE(render_trace_span_, __LINE__)(name)
+// the steps of a ray
+#define RENDER_TRACE_DETAIL_SPAN(name) trace_span RENDER_TRACE_CONCATENATE(render_trace_span_, __LINE__)(name, true)
+
+#else
+
+#define RENDER_TRACE_SPAN(name)
+#define RENDER_TRACE_DETAIL_SPAN(name)
+
+#endif
+
+#endif
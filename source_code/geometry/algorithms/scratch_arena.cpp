@@ -0,0 +1,72 @@
+#include "scratch_arena.h"
+
+namespace
+{
+    int& thread_scratch_depth()
+    {
+        thread_local int depth = 0;
+
+        return depth;
+    }
+}
+
+void* scratch_arena::counting_resource::do_allocate(size_t bytes, size_t alignment)
+{
+    allocated += bytes;
+
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void scratch_arena::counting_resource::do_deallocate(void* p, size_t bytes, size_t alignment)
+{
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
+
+bool scratch_arena::counting_resource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+scratch_arena::scratch_arena(size_t initial_size) : buffer(initial_size)
+{
+    monotonic.emplace(buffer.data(), buffer.size(), &heap);
+}
+
+void scratch_arena::rewind()
+{
+    if (0 == heap.allocated)
+    {
+        monotonic->release();
+
+        return;
+    }
+
+    // the heap blocks grow geometrically, so this is at least the high water mark
+    size_t size = buffer.size() + heap.allocated;
+
+    monotonic.reset();
+    heap.allocated = 0;
+
+    buffer.assign(size, std::byte{ 0 });
+    monotonic.emplace(buffer.data(), buffer.size(), &heap);
+}
+
+scratch_arena& thread_scratch_arena()
+{
+    thread_local scratch_arena arena;
+
+    return arena;
+}
+
+scratch_scope::scratch_scope() : arena(thread_scratch_arena())
+{
+    thread_scratch_depth()++;
+}
+
+scratch_scope::~scratch_scope()
+{
+    if (0 == --thread_scratch_depth())
+    {
+        arena.rewind();
+    }
+}
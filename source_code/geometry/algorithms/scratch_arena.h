@@ -0,0 +1,68 @@
+#ifndef scratch_arena_h
+#define scratch_arena_h
+
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+
+// monotonic memory of one thread for the temporaries of the root finders (work queues, clipped and quasi
+// interpolating meshes, cell flags); it is rewound, when the outermost scratch_scope of the thread ends, so nothing
+// allocated from it may outlive the scope. Allocations beyond the buffer go to the heap, until the buffer is grown to
+// the high water mark at the next rewind, so the clipping steps stop calling malloc after the first rays; the roots
+// returned to the callers are still allocated on the heap
+class scratch_arena
+{
+public:
+    scratch_arena(size_t initial_size = 256 * 1024);
+
+    scratch_arena(const scratch_arena&) = delete;
+    scratch_arena& operator=(const scratch_arena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &*monotonic; }
+
+    // frees everything allocated since the last rewind
+    void rewind();
+
+    size_t capacity() const { return buffer.size(); }
+    // bytes taken from the heap since the last rewind
+    size_t overflow() const { return heap.allocated; }
+
+private:
+    // the heap behind the buffer, counting what it hands out
+    class counting_resource : public std::pmr::memory_resource
+    {
+    public:
+        size_t allocated = 0;
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+    };
+
+    std::vector<std::byte> buffer;
+    counting_resource heap;
+    std::optional<std::pmr::monotonic_buffer_resource> monotonic;
+};
+
+scratch_arena& thread_scratch_arena();
+
+// the scratch memory of the calling thread for the lifetime of the scope; scopes nest, the arena is rewound, when the
+// outermost ends
+class scratch_scope
+{
+public:
+    scratch_scope();
+    ~scratch_scope();
+
+    scratch_scope(const scratch_scope&) = delete;
+    scratch_scope& operator=(const scratch_scope&) = delete;
+
+    std::pmr::memory_resource* resource() const { return arena.resource(); }
+
+private:
+    scratch_arena& arena;
+};
+
+#endif
@@ -0,0 +1,46 @@
+#include "surface_curvature.h"
+
+#include <geometry/types/bezier_surface.h>
+#include <geometry/linear_algebra/formulas.h>
+
+surface_differentials evaluate_rational_bezier_surface_differentials(const varmesh<4>& m, double u, double v)
+{
+    auto [h, h_u, h_v, h_uu, h_uv, h_vv] = evaluate_bezier_surface_with_derivatives(m, u, v);
+
+    double w = h[3];
+    double w_u = h_u[3];
+    double w_v = h_v[3];
+
+    surface_differentials result;
+
+    result.point = remove_dimension(h);
+    result.du = (1. / w) * (remove_last_component(h_u) - w_u * result.point);
+    result.dv = (1. / w) * (remove_last_component(h_v) - w_v * result.point);
+    result.duu = (1. / w) * (remove_last_component(h_uu) - (2 * w_u) * result.du - h_uu[3] * result.point);
+    result.duv = (1. / w) * (remove_last_component(h_uv) - w_u * result.dv - w_v * result.du - h_uv[3] * result.point);
+    result.dvv = (1. / w) * (remove_last_component(h_vv) - (2 * w_v) * result.dv - h_vv[3] * result.point);
+
+    return result;
+}
+
+surface_curvature curvature_of_surface(const surface_differentials& differentials)
+{
+    v3 n = normalize(cross_product(differentials.du, differentials.dv));
+
+    double e = differentials.du * differentials.du;
+    double f = differentials.du * differentials.dv;
+    double g = differentials.dv * differentials.dv;
+
+    double l = differentials.duu * n;
+    double m = differentials.duv * n;
+    double nn = differentials.dvv * n;
+
+    double first_form = e * g - f * f;
+
+    if (0 >= first_form)
+    {
+        return surface_curvature{ n, 0, 0 };
+    }
+
+    return surface_curvature{ n, (l * nn - m * m) / first_form, (e * nn - 2 * f * m + g * l) / (2 * first_form) };
+}
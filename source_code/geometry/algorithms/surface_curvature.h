@@ -0,0 +1,30 @@
+#ifndef geometry_algorithms_surface_curvature_h
+#define geometry_algorithms_surface_curvature_h
+
+#include <geometry/types/vector.h>
+#include <geometry/types/varmesh.h>
+
+struct surface_differentials
+{
+    v3 point;
+    v3 du;
+    v3 dv;
+    v3 duu;
+    v3 duv;
+    v3 dvv;
+};
+
+struct surface_curvature
+{
+    v3 normale;
+    double gaussian;
+    double mean;
+};
+
+// exact derivatives of the rational surface, i.e. after the division by the weight
+surface_differentials evaluate_rational_bezier_surface_differentials(const varmesh<4>& m, double u, double v);
+
+// the sign of the mean curvature refers to the orientation du x dv
+surface_curvature curvature_of_surface(const surface_differentials& differentials);
+
+#endif // geometry_algorithms_surface_curvature_h
@@ -0,0 +1,140 @@
+#include "tessellation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <geometry/types/bezier_surface.h>
+#include <geometry/algorithms/intersection.h>
+#include <geometry/linear_algebra/formulas.h>
+
+namespace
+{
+    void emit_leaf(const varmesh<4>& patch, const v2& u, const v2& v, double error, const trim_region* trim, patch_tessellation& result)
+    {
+        if (trim != nullptr)
+        {
+            v2 centre{ (u[0] + u[1]) / 2, (v[0] + v[1]) / 2 };
+
+            // the whole leaf is decided by its centre, the triangles approximate the trim boundary by the leaf size
+            if (!trim->contains(centre))
+            {
+                return;
+            }
+        }
+
+        int first = result.points.size();
+
+        // evaluated on the whole patch, so leaves of the same depth share their corner points exactly
+        for (double corner_v : { v[0], v[1] })
+        {
+            for (double corner_u : { u[0], u[1] })
+            {
+                auto derivatives = evaluate_bezier_surface_with_derivatives(patch, corner_u, corner_v);
+
+                // from the derivatives of the homogeneous surface like in the exact tracers, so both shade alike
+                result.points.push_back(remove_dimension(derivatives[0]));
+                result.normals.push_back(cross_product(remove_last_component(derivatives[1]), remove_last_component(derivatives[2])));
+                result.uvs.push_back(v2{ corner_u, corner_v });
+            }
+        }
+
+        // oriented like cross_product(su, sv)
+        result.facettes.push_back({ first, first + 1, first + 3 });
+        result.facettes.push_back({ first, first + 3, first + 2 });
+
+        int leaf = result.leaf_errors.size();
+        result.facette_leaves.push_back(leaf);
+        result.facette_leaves.push_back(leaf);
+        result.leaf_u.push_back(u);
+        result.leaf_v.push_back(v);
+        result.leaf_errors.push_back(error);
+    }
+
+    void tessellate(const varmesh<4>& patch, const varmesh<4>& leaf, const v2& u, const v2& v, int depth, const tessellation_settings& settings, const trim_region* trim, patch_tessellation& result)
+    {
+        double error = tessellation_error(remove_dimension(leaf));
+
+        if (depth >= settings.max_depth || error <= tessellation_tolerance(leaf, settings))
+        {
+            emit_leaf(patch, u, v, error, trim, result);
+
+            return;
+        }
+
+        double u_middle = (u[0] + u[1]) / 2;
+        double v_middle = (v[0] + v[1]) / 2;
+
+        auto [left, right] = subdivide_bezier_surface_by_row(leaf, 0.5);
+
+        auto [left_top, left_bottom] = subdivide_bezier_surface_by_column(left, 0.5);
+        auto [right_top, right_bottom] = subdivide_bezier_surface_by_column(right, 0.5);
+
+        tessellate(patch, left_top, v2{ u[0], u_middle }, v2{ v[0], v_middle }, depth + 1, settings, trim, result);
+        tessellate(patch, right_top, v2{ u_middle, u[1] }, v2{ v[0], v_middle }, depth + 1, settings, trim, result);
+        tessellate(patch, left_bottom, v2{ u[0], u_middle }, v2{ v_middle, v[1] }, depth + 1, settings, trim, result);
+        tessellate(patch, right_bottom, v2{ u_middle, u[1] }, v2{ v_middle, v[1] }, depth + 1, settings, trim, result);
+    }
+}
+
+double tessellation_error(const varmesh<3>& m)
+{
+    int r = m.row_size() - 1;
+    int c = m.col_size() - 1;
+
+    const v3& p00 = m.element(0, 0);
+    const v3& p10 = m.element(0, c);
+    const v3& p01 = m.element(r, 0);
+    const v3& p11 = m.element(r, c);
+
+    // the piecewise bilinear net and the bilinear patch through the corners differ the most at the control points
+    double net_deviation = 0;
+
+    for (int i = 0; i <= r; i++)
+    {
+        for (int j = 0; j <= c; j++)
+        {
+            double s = double(j) / c;
+            double t = double(i) / r;
+
+            v3 bilinear = (1 - t) * ((1 - s) * p00 + s * p10) + t * ((1 - s) * p01 + s * p11);
+
+            net_deviation = std::max(net_deviation, length(m.element(i, j) - bilinear));
+        }
+    }
+
+    // the bilinear patch and its two triangles differ by a quarter of the twist in the centre
+    double twist = length(p00 - p10 - p01 + p11) / 4;
+
+    // the deviation to the net is bounded per coordinate
+    return std::sqrt(3.) * bezier_max_deviation_to_quasi_interpolation(m) + net_deviation + twist;
+}
+
+double tessellation_tolerance(const varmesh<4>& m, const tessellation_settings& settings)
+{
+    if (settings.pixel_tolerance <= 0)
+    {
+        return settings.chordal_tolerance;
+    }
+
+    double distance = std::numeric_limits<double>::max();
+
+    for (int i = 0; i < m.row_size(); i++)
+    {
+        for (int j = 0; j < m.col_size(); j++)
+        {
+            distance = std::min(distance, length(remove_dimension(m.element(i, j)) - settings.eye));
+        }
+    }
+
+    return std::min(settings.chordal_tolerance, settings.pixel_tolerance * settings.pixel_angle * distance);
+}
+
+patch_tessellation tessellate_patch(const varmesh<4>& m, const tessellation_settings& settings, const trim_region* trim)
+{
+    patch_tessellation result;
+
+    tessellate(m, m, v2{ 0, 1 }, v2{ 0, 1 }, 0, settings, trim, result);
+
+    return result;
+}
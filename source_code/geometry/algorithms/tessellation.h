@@ -0,0 +1,50 @@
+#ifndef tessellation_h
+#define tessellation_h
+
+#include <array>
+#include <vector>
+
+#include <geometry/types/vector.h>
+#include <geometry/types/varmesh.h>
+#include <geometry/algorithms/trim_region.h>
+
+struct tessellation_settings
+{
+    // largest allowed distance of a triangle to the surface
+    double chordal_tolerance = 1E-2;
+    // if positive, the distance is also bounded by this many pixels at the nearest control point seen from eye
+    double pixel_tolerance = 0;
+    v3 eye{ 0, 0, 0 };
+    // angle covered by one pixel, 2 tan(fov / 2) / screen_height
+    double pixel_angle = 0;
+    // every level splits a patch into four
+    int max_depth = 8;
+};
+
+// triangles with normals and uv of the patch at their vertices
+struct patch_tessellation
+{
+    std::vector<v3> points;
+    std::vector<v3> normals;
+    std::vector<v2> uvs;
+    std::vector<std::array<int, 3>> facettes;
+    // per facette the index of its leaf; per leaf the parameter window and the bound of its distance to the surface
+    std::vector<int> facette_leaves;
+    std::vector<v2> leaf_u;
+    std::vector<v2> leaf_v;
+    std::vector<double> leaf_errors;
+};
+
+// upper bound of the distance of the two triangles through the corners of a polynomial patch to the patch:
+// deviation of the surface from its control net plus deviation of the net from the triangles;
+// for rational patches a heuristic computed on the euclidean control points
+double tessellation_error(const varmesh<3>& m);
+
+double tessellation_tolerance(const varmesh<4>& m, const tessellation_settings& settings);
+
+// splits the patch in the middle of both parameters, until tessellation_error is below the tolerance of the
+// sub patch, and emits two triangles per leaf; neighbouring leaves of different depth leave small cracks;
+// triangles whose uv centroid is outside of trim are dropped
+patch_tessellation tessellate_patch(const varmesh<4>& m, const tessellation_settings& settings, const trim_region* trim = nullptr);
+
+#endif
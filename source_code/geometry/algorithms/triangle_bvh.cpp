@@ -0,0 +1,225 @@
+#include "triangle_bvh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include <geometry/linear_algebra/formulas.h>
+
+std::optional<triangle_hit> intersect_triangle(const v3& origin, const v3& direction, const v3& p0, const v3& p1, const v3& p2)
+{
+    v3 e1 = p1 - p0;
+    v3 e2 = p2 - p0;
+
+    v3 pvec = cross_product(direction, e2);
+
+    double det = e1 * pvec;
+
+    if (0 == det)
+    {
+        return {};
+    }
+
+    v3 tvec = origin - p0;
+
+    double b1 = (tvec * pvec) / det;
+
+    if (0 > b1 || 1 < b1)
+    {
+        return {};
+    }
+
+    v3 qvec = cross_product(tvec, e1);
+
+    double b2 = (direction * qvec) / det;
+
+    if (0 > b2 || 1 < b1 + b2)
+    {
+        return {};
+    }
+
+    double t = (e2 * qvec) / det;
+
+    if (t <= 0)
+    {
+        return {};
+    }
+
+    return triangle_hit{ t, -1, b1, b2 };
+}
+
+triangle_bvh::triangle_bvh(const std::vector<v3>& points, const std::vector<std::array<int, 3>>& facettes)
+{
+    if (facettes.empty())
+    {
+        return;
+    }
+
+    order.resize(facettes.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    std::vector<v3> centroids;
+    for (const auto& f : facettes)
+    {
+        centroids.push_back((1. / 3) * (points[f[0]] + points[f[1]] + points[f[2]]));
+    }
+
+    nodes.push_back(triangle_bvh_node{});
+    build(0, 0, facettes.size(), points, facettes, centroids);
+}
+
+void triangle_bvh::build(int index, int begin, int end, const std::vector<v3>& points, const std::vector<std::array<int, 3>>& facettes, std::vector<v3>& centroids)
+{
+    bounding_box bounds{ points[facettes[order[begin]][0]], points[facettes[order[begin]][0]] };
+
+    for (int i = begin; i < end; i++)
+    {
+        for (int p : facettes[order[i]])
+        {
+            bounds = merge_bounding_boxes(bounds, bounding_box{ points[p], points[p] });
+        }
+    }
+
+    nodes[index] = triangle_bvh_node{ bounds, -1, begin, end };
+
+    if (end - begin <= leaf_size)
+    {
+        return;
+    }
+
+    v3 extent = bounds.upper - bounds.lower;
+    int axis = std::max_element(extent.begin(), extent.end()) - extent.begin();
+
+    int middle = (begin + end) / 2;
+
+    std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end, [&](int a, int b) { return centroids[a][axis] < centroids[b][axis]; });
+
+    int first_child = nodes.size();
+    nodes[index].first_child = first_child;
+
+    nodes.push_back(triangle_bvh_node{});
+    nodes.push_back(triangle_bvh_node{});
+
+    build(first_child, begin, middle, points, facettes, centroids);
+    build(first_child + 1, middle, end, points, facettes, centroids);
+}
+
+std::optional<triangle_hit> triangle_bvh::closest_hit(const v3& origin, const v3& direction, const std::vector<v3>& points, const std::vector<std::array<int, 3>>& facettes) const
+{
+    std::optional<triangle_hit> closest;
+
+    double entry;
+
+    if (nodes.empty() || !ray_intersects_bounding_box(origin, direction, nodes[0].bounds, entry))
+    {
+        return closest;
+    }
+
+    std::array<std::pair<double, int>, 64> stack;
+    int stack_size = 0;
+
+    stack[stack_size++] = { entry, 0 };
+
+    while (0 < stack_size)
+    {
+        auto [node_entry, index] = stack[--stack_size];
+
+        if (closest.has_value() && closest->t < node_entry)
+        {
+            continue;
+        }
+
+        const triangle_bvh_node& node = nodes[index];
+
+        if (node.first_child < 0)
+        {
+            for (int i = node.begin; i < node.end; i++)
+            {
+                const auto& f = facettes[order[i]];
+
+                auto hit = intersect_triangle(origin, direction, points[f[0]], points[f[1]], points[f[2]]);
+
+                if (hit.has_value() && (!closest.has_value() || hit->t < closest->t))
+                {
+                    closest = hit;
+                    closest->facette = order[i];
+                }
+            }
+
+            continue;
+        }
+
+        double entries[2];
+        bool hits[2];
+
+        for (int c = 0; c < 2; c++)
+        {
+            hits[c] = ray_intersects_bounding_box(origin, direction, nodes[node.first_child + c].bounds, entries[c]);
+        }
+
+        // the nearer child is pushed last and visited first
+        int nearer = (hits[0] && hits[1] && entries[1] < entries[0]) ? 1 : 0;
+
+        for (int c : { 1 - nearer, nearer })
+        {
+            if (hits[c])
+            {
+                stack[stack_size++] = { entries[c], node.first_child + c };
+            }
+        }
+    }
+
+    return closest;
+}
+
+std::vector<std::pair<double, int>> triangle_bvh::intersected_facettes(const v3& origin, const v3& direction, const std::vector<v3>& points, const std::vector<std::array<int, 3>>& facettes) const
+{
+    std::vector<std::pair<double, int>> result;
+
+    double entry;
+
+    if (nodes.empty() || !ray_intersects_bounding_box(origin, direction, nodes[0].bounds, entry))
+    {
+        return result;
+    }
+
+    std::array<int, 64> stack;
+    int stack_size = 0;
+
+    stack[stack_size++] = 0;
+
+    while (0 < stack_size)
+    {
+        const triangle_bvh_node& node = nodes[stack[--stack_size]];
+
+        if (node.first_child < 0)
+        {
+            for (int i = node.begin; i < node.end; i++)
+            {
+                const auto& f = facettes[order[i]];
+
+                auto hit = intersect_triangle(origin, direction, points[f[0]], points[f[1]], points[f[2]]);
+
+                if (hit.has_value())
+                {
+                    result.push_back({ hit->t, order[i] });
+                }
+            }
+
+            continue;
+        }
+
+        for (int c = 0; c < 2; c++)
+        {
+            if (ray_intersects_bounding_box(origin, direction, nodes[node.first_child + c].bounds, entry))
+            {
+                stack[stack_size++] = node.first_child + c;
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+
+    return result;
+}
@@ -0,0 +1,58 @@
+#ifndef triangle_bvh_h
+#define triangle_bvh_h
+
+#include <array>
+#include <optional>
+#include <vector>
+
+#include <geometry/types/vector.h>
+#include <geometry/algorithms/bezier_patch_bvh.h>
+
+struct triangle_hit
+{
+    double t;
+    int facette;
+    // barycentric coordinates of the second and the third point
+    double b1;
+    double b2;
+};
+
+// moeller trumbore; hits only in front of origin count
+std::optional<triangle_hit> intersect_triangle(const v3& origin, const v3& direction, const v3& p0, const v3& p1, const v3& p2);
+
+struct triangle_bvh_node
+{
+    bounding_box bounds;
+    // the two children are stored consecutively, -1 for leaves
+    int first_child;
+    // range of the leaf in the facette order
+    int begin;
+    int end;
+};
+
+// binary tree over the facettes of a triangle mesh, split at the median of the longest axis of the centroids
+class triangle_bvh
+{
+public:
+    triangle_bvh() = default;
+    triangle_bvh(const std::vector<v3>& points, const std::vector<std::array<int, 3>>& facettes);
+
+    // closest hit in front of origin, front to back traversal
+    std::optional<triangle_hit> closest_hit(const v3& origin, const v3& direction, const std::vector<v3>& points, const std::vector<std::array<int, 3>>& facettes) const;
+
+    // all hits in front of origin as pairs of t and facette, sorted by t
+    std::vector<std::pair<double, int>> intersected_facettes(const v3& origin, const v3& direction, const std::vector<v3>& points, const std::vector<std::array<int, 3>>& facettes) const;
+
+    size_t node_count() const { return nodes.size(); }
+
+    static const int leaf_size = 4;
+
+private:
+    void build(int index, int begin, int end, const std::vector<v3>& points, const std::vector<std::array<int, 3>>& facettes, std::vector<v3>& centroids);
+
+    std::vector<triangle_bvh_node> nodes;
+    // facette indices, ordered such that every leaf holds a range
+    std::vector<int> order;
+};
+
+#endif
@@ -0,0 +1,109 @@
+#include "trim_region.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <geometry/types/bezier_curve.h>
+#include <geometry/algorithms/intersection.h>
+
+std::vector<v2> polyline_of_bezier_loop(const std::vector<std::vector<v2>>& curves, int segments_per_curve)
+{
+	std::vector<v2> polyline;
+
+	for (const auto& curve : curves)
+	{
+		// the end point of a curve is the start point of the next one
+		for (int i = 0; i < segments_per_curve; i++)
+		{
+			polyline.push_back(evaluate_bezier_curve(curve, double(i) / segments_per_curve));
+		}
+	}
+
+	return polyline;
+}
+
+trim_region::trim_region(const std::vector<std::vector<v2>>& loops, int grid_resolution) : loops(loops), resolution(grid_resolution), cells(grid_resolution * grid_resolution, cell_state::outside)
+{
+	double cell_size = 1. / resolution;
+
+	// the cells overlapped by the bounding box of a segment may be crossed by the loop
+	for (const auto& loop : loops)
+	{
+		for (int i = 0; i < loop.size(); i++)
+		{
+			const v2& p = loop[i];
+			const v2& q = loop[(i + 1) % loop.size()];
+
+			int x0 = std::clamp(int(std::floor(std::min(p[0], q[0]) / cell_size)), 0, resolution - 1);
+			int x1 = std::clamp(int(std::floor(std::max(p[0], q[0]) / cell_size)), 0, resolution - 1);
+			int y0 = std::clamp(int(std::floor(std::min(p[1], q[1]) / cell_size)), 0, resolution - 1);
+			int y1 = std::clamp(int(std::floor(std::max(p[1], q[1]) / cell_size)), 0, resolution - 1);
+
+			for (int y = y0; y <= y1; y++)
+			{
+				for (int x = x0; x <= x1; x++)
+				{
+					cell(x, y) = cell_state::boundary;
+				}
+			}
+		}
+	}
+
+	// no loop crosses the other cells, their centre decides for all of their points
+	for (int y = 0; y < resolution; y++)
+	{
+		for (int x = 0; x < resolution; x++)
+		{
+			if (cell_state::boundary != cell(x, y))
+			{
+				cell(x, y) = contains_exactly(v2{ {(x + 0.5) * cell_size, (y + 0.5) * cell_size} }) ? cell_state::inside : cell_state::outside;
+			}
+		}
+	}
+}
+
+bool trim_region::contains_exactly(const v2& uv) const
+{
+	bool inside = false;
+
+	for (const auto& loop : loops)
+	{
+		if (inside_polygon(uv, loop))
+		{
+			inside = !inside;
+		}
+	}
+
+	return inside;
+}
+
+bool trim_region::contains(const v2& uv) const
+{
+	if (loops.empty())
+	{
+		return true;
+	}
+
+	int x = std::clamp(int(uv[0] * resolution), 0, resolution - 1);
+	int y = std::clamp(int(uv[1] * resolution), 0, resolution - 1);
+
+	switch (cells[y * resolution + x])
+	{
+	case cell_state::inside:
+		return true;
+	case cell_state::outside:
+		return false;
+	default:
+		return contains_exactly(uv);
+	}
+}
+
+double trim_region::boundary_cell_fraction() const
+{
+	if (cells.empty())
+	{
+		return 0;
+	}
+
+	return double(std::count(cells.begin(), cells.end(), cell_state::boundary)) / cells.size();
+}
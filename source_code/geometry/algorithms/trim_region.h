@@ -0,0 +1,43 @@
+#ifndef trim_region_h
+#define trim_region_h
+
+#include <vector>
+
+#include <geometry/types/vector.h>
+
+// closed polyline approximating a trim loop given by bezier curves in uv, each curve with segments_per_curve segments
+std::vector<v2> polyline_of_bezier_loop(const std::vector<std::vector<v2>>& curves, int segments_per_curve = 16);
+
+// the part of the parameter domain of a patch inside its trim loops, by the even odd rule, so holes are loops inside
+// the outer loop; without loops the whole domain is inside
+class trim_region
+{
+public:
+	trim_region() = default;
+	trim_region(const std::vector<std::vector<v2>>& loops, int grid_resolution = 64);
+
+	bool is_trimmed() const { return !loops.empty(); }
+
+	// one lookup in the grid, inside_polygon only for the cells crossed by a loop
+	bool contains(const v2& uv) const;
+
+	// the exact test against all loops
+	bool contains_exactly(const v2& uv) const;
+
+	const std::vector<std::vector<v2>>& trim_loops() const { return loops; }
+	int grid_resolution() const { return resolution; }
+
+	// fraction of the grid cells, that need the exact test
+	double boundary_cell_fraction() const;
+
+private:
+	enum class cell_state : unsigned char { outside, inside, boundary };
+
+	cell_state& cell(int x, int y) { return cells[y * resolution + x]; }
+
+	std::vector<std::vector<v2>> loops;
+	int resolution = 0;
+	std::vector<cell_state> cells;
+};
+
+#endif
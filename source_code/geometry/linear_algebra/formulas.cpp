@@ -181,6 +181,30 @@ v4 horizontal_plane_of_ray(const v3& origin, const v3& dir)
     return v4{ {n[0], n[1], n[2], d} };
 }
 
+std::pair<v4, v4> planes_of_ray(const v3& origin, const v3& dir)
+{
+    if (std::abs(dir[2]) >= std::abs(dir[0]) && std::abs(dir[2]) >= std::abs(dir[1]))
+    {
+        return std::make_pair(vertical_plane_of_ray(origin, dir), horizontal_plane_of_ray(origin, dir));
+    }
+
+    int k = std::abs(dir[0]) >= std::abs(dir[1]) ? 0 : 1;
+    int a = (k + 1) % 3;
+    int b = (k + 2) % 3;
+
+    v3 n1{ {0, 0, 0} };
+    n1[a] = dir[k];
+    n1[k] = -dir[a];
+    n1 = normalize(n1);
+
+    v3 n2{ {0, 0, 0} };
+    n2[b] = dir[k];
+    n2[k] = -dir[b];
+    n2 = normalize(n2);
+
+    return std::make_pair(v4{ {n1[0], n1[1], n1[2], -(origin * n1)} }, v4{ {n2[0], n2[1], n2[2], -(origin * n2)} });
+}
+
 v4 distance_plane_of_ray(const v3& origin, const v3& direction)
 {
     return v4{ {direction[0], direction[1], direction[2], -origin * direction} };
@@ -279,21 +303,6 @@ v3 normale_of_mesh(const varmesh<3>& m)
     return cross_product(e01 - origin, e10 - origin);
 }
 
-varmesh<2> project_mesh(const varmesh<4>& m, const v4& plane1, const v4& plane2)
-{
-    varmesh<2> result(m.row_size(), m.col_size());
-
-    for (int i = 0; i < m.row_size(); i++)
-    {
-        for (int j = 0; j < m.col_size(); j++)
-        {
-            result.element(i, j) = v2{ {m.element(i, j) * plane1, m.element(i, j) * plane2} };
-        }
-    }
-
-    return result;
-}
-
 double angle(v3 x, v3 y)
 {
     auto lx = length(x);
@@ -22,6 +22,10 @@ v4 vertical_plane_of_ray(const v3& origin, const v3& dir);
 v4 horizontal_plane_of_ray(const v3& origin, const v3& dir);
 v4 distance_plane_of_ray(const v3& origin, const v3& direction);
 
+// vertical and horizontal plane of a ray; for rays not dominated by e3 the axes are permuted,
+// so that both planes stay well defined for arbitrary (e.g. reflected) directions
+std::pair<v4, v4> planes_of_ray(const v3& origin, const v3& dir);
+
 v3 project_onto_ray(const v3& origin, const v3& dir, const v3& point);
 
 bool angle_less(const v2& p, const v2& q);
@@ -73,7 +77,21 @@ inline bool counter_clockwise_angle_not_greater_180(const v2& p, const v2& q)
     return 0 <= cross_product_scale(p, q);
 }
 
-varmesh<2> project_mesh(const varmesh<4>& m, const v4& plane1, const v4& plane2);
+// the plane distances are evaluated in double, T is the scalar type of the projected mesh
+template<class T = double> varmesh<2, T> project_mesh(const varmesh<4>& m, const v4& plane1, const v4& plane2, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+{
+    varmesh<2, T> result(m.row_size(), m.col_size(), resource);
+
+    for (int i = 0; i < m.row_size(); i++)
+    {
+        for (int j = 0; j < m.col_size(); j++)
+        {
+            result.element(i, j) = v<2, T>{ {T(m.element(i, j) * plane1), T(m.element(i, j) * plane2)} };
+        }
+    }
+
+    return result;
+}
 
 
 v3 normale_of_mesh(const varmesh<3>& m);
@@ -8,14 +8,15 @@
 
 #include <assert.h>
 
-template<std::size_t N> v<N> convex_combination(const v<N>& p, const v<N>& q, double weight)
+template<std::size_t N, class T> v<N, T> convex_combination(const v<N, T>& p, const v<N, T>& q, double weight)
 {
     return (1 - weight) * p + weight * q;
 }
 
-template<std::size_t N> std::vector<v<N>> convex_combine_points(const std::vector<v<N>>& points, double u)
+// the result is allocated like points
+template<std::size_t N, class T, class A> std::vector<v<N, T>, A> convex_combine_points(const std::vector<v<N, T>, A>& points, double u)
 {
-    std::vector<v<N>> result;
+    std::vector<v<N, T>, A> result(points.get_allocator());
 
     for (int i = 0; i < points.size() - 1; i++)
     {
@@ -25,9 +26,9 @@ template<std::size_t N> std::vector<v<N>> convex_combine_points(const std::vecto
     return result;
 }
 
-template <std::size_t N>
-std::vector<v<N>> centred_second_order_differences(const std::vector<v<N>>& points) {
-    std::vector<v<N>> result;
+template<std::size_t N, class T, class A>
+std::vector<v<N, T>, A> centred_second_order_differences(const std::vector<v<N, T>, A>& points) {
+    std::vector<v<N, T>, A> result(points.get_allocator());
 
     for (int i = 1; i < points.size() - 1; i++)
     {
@@ -3,7 +3,7 @@
 
 #include <geometry/types/bezier.h>
 
-template<std::size_t N> v<N> evaluate_polyline(const std::vector<v<N>>& control_points, double u)
+template<std::size_t N, class T> v<N, T> evaluate_polyline(const std::vector<v<N, T>>& control_points, double u)
 {
     int index = floor((control_points.size() - 1) * u);
 
@@ -18,21 +18,25 @@ template<std::size_t N> v<N> evaluate_polyline(const std::vector<v<N>>& control_
     return convex_combination(control_points[index], control_points[index + 1], u);
 }
 
-template<std::size_t N> v<N> evaluate_bezier_curve(const std::vector<v<N>>& control_points, double u)
+// de casteljau in one copy of the control points, allocated like them
+template<std::size_t N, class T, class A> v<N, T> evaluate_bezier_curve(const std::vector<v<N, T>, A>& control_points, double u)
 {
-    std::vector<v<N>> points{ control_points };
+    std::vector<v<N, T>, A> points(control_points, control_points.get_allocator());
 
-    while (1 < points.size())
+    for (size_t n = points.size(); 1 < n; n--)
     {
-        points = convex_combine_points(points, u);
+        for (size_t i = 0; i < n - 1; i++)
+        {
+            points[i] = convex_combination(points[i], points[i + 1], u);
+        }
     }
 
     return points[0];
 }
 
-template<std::size_t N> v<N> evaluate_bezier_curve_derivative(const std::vector<v<N>>& control_points, double u)
+template<std::size_t N, class T> v<N, T> evaluate_bezier_curve_derivative(const std::vector<v<N, T>>& control_points, double u)
 {
-    std::vector<v<N>> diffs;
+    std::vector<v<N, T>> diffs;
 
     for (int i = 0; i < control_points.size() - 1; i++)
     {
@@ -42,10 +46,43 @@ template<std::size_t N> v<N> evaluate_bezier_curve_derivative(const std::vector<
     return evaluate_bezier_curve(diffs, u);
 }
 
+// point, first and second derivative of the curve (including the degree factors)
+template<std::size_t N, class T, class A> std::array<v<N, T>, 3> evaluate_bezier_curve_with_derivatives(const std::vector<v<N, T>, A>& control_points, double u)
+{
+    std::array<v<N, T>, 3> result;
+    result.fill(v<N, T>{ {0} });
+
+    int degree = control_points.size() - 1;
+
+    result[0] = evaluate_bezier_curve(control_points, u);
+
+    if (1 > degree)
+    {
+        return result;
+    }
+
+    std::vector<v<N, T>, A> first_differences(control_points.get_allocator());
+
+    for (int i = 0; i < degree; i++)
+    {
+        first_differences.push_back(control_points[i + 1] - control_points[i]);
+    }
+
+    result[1] = double(degree) * evaluate_bezier_curve(first_differences, u);
+
+    if (2 > degree)
+    {
+        return result;
+    }
+
+    result[2] = double(degree * (degree - 1)) * evaluate_bezier_curve(centred_second_order_differences(control_points), u);
+
+    return result;
+}
 
-template<std::size_t N> std::vector<v<N>> bezier_curve_insert_control_point(const std::vector<v<N>>& control_points)
+template<std::size_t N, class T> std::vector<v<N, T>> bezier_curve_insert_control_point(const std::vector<v<N, T>>& control_points)
 {
-    std::vector<v<N>> result;
+    std::vector<v<N, T>> result;
 
     result.push_back(control_points[0]);
 
@@ -60,9 +97,9 @@ template<std::size_t N> std::vector<v<N>> bezier_curve_insert_control_point(cons
     return result;
 }
 
-template<std::size_t N> std::vector<v<N>> bezier_curve_quasi_interpolation(const std::vector<v<N>>& control_points)
+template<std::size_t N, class T> std::vector<v<N, T>> bezier_curve_quasi_interpolation(const std::vector<v<N, T>>& control_points)
 {
-    std::vector<v<N>> result;
+    std::vector<v<N, T>> result;
 
     result.push_back(control_points[0]);
 
@@ -78,9 +115,9 @@ template<std::size_t N> std::vector<v<N>> bezier_curve_quasi_interpolation(const
 
 
 
-template<std::size_t N> std::pair<std::vector<v<N>>, std::vector<v<N>>> subdivide_bezier_curve(const std::vector<v<N>>& control_points, double u)
+template<std::size_t N, class T> std::pair<std::vector<v<N, T>>, std::vector<v<N, T>>> subdivide_bezier_curve(const std::vector<v<N, T>>& control_points, double u)
 {
-    std::vector<v<N>> left, right, points{ control_points };
+    std::vector<v<N, T>> left, right, points{ control_points };
 
     while (1 <= points.size())
     {
@@ -3,9 +3,9 @@
 
 #include "geometry/types/bezier_curve.h"
 
-template<std::size_t N> v<N> evaluate_polygon_surface(const varmesh<N>& m, double u, double vv)
+template<std::size_t N, class T> v<N, T> evaluate_polygon_surface(const varmesh<N, T>& m, double u, double vv)
 {
-    std::vector<v<N>> colu;
+    std::vector<v<N, T>> colu;
 
     for (int i = 0; i < m.row_size(); i++)
     {
@@ -15,9 +15,9 @@ template<std::size_t N> v<N> evaluate_polygon_surface(const varmesh<N>& m, doubl
     return evaluate_polyline(colu, vv);
 }
 
-template <size_t N> std::vector<v<N>> bezier_curve_on_surface_u(const varmesh<N>& m, double vv)
+template<size_t N, class T> std::vector<v<N, T>> bezier_curve_on_surface_u(const varmesh<N, T>& m, double vv)
 {
-    std::vector<v<N>> result;
+    std::vector<v<N, T>> result;
 
     for (int i = 0; i < m.col_size(); i++)
     {
@@ -27,9 +27,9 @@ template <size_t N> std::vector<v<N>> bezier_curve_on_surface_u(const varmesh<N>
     return result;
 }
 
-template <size_t N> std::vector<v<N>> bezier_curve_on_surface_v(const varmesh<N>& m, double u)
+template<size_t N, class T> std::vector<v<N, T>> bezier_curve_on_surface_v(const varmesh<N, T>& m, double u)
 {
-    std::vector<v<N>> result;
+    std::vector<v<N, T>> result;
 
     for (int i = 0; i < m.row_size(); i++)
     {
@@ -39,25 +39,58 @@ template <size_t N> std::vector<v<N>> bezier_curve_on_surface_v(const varmesh<N>
     return result;
 }
 
-template <size_t N> v<N> evaluate_bezier_surface(const varmesh<N>& m, double u, double vv)
+// the temporary curves are allocated from resource
+template<size_t N, class T> v<N, T> evaluate_bezier_surface(const varmesh<N, T>& m, double u, double vv, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
 {
-    std::vector<v<N>> results;
+    std::pmr::vector<v<N, T>> results(resource);
+    std::pmr::vector<v<N, T>> row(m.col_size(), resource);
 
     for (int i = 0; i < m.row_size(); i++)
     {
-        std::vector<v<N>> row;
         for (int j = 0; j < m.col_size(); j++)
         {
-            row.push_back(m.element(i, j));
+            row[j] = m.element(i, j);
         }
         results.push_back(evaluate_bezier_curve(row, u));
     }
     return evaluate_bezier_curve(results, vv);
 }
 
-template<std::size_t N> varmesh<N> bezier_surface_quasi_interpolation(const varmesh<N>& m)
+// point and partial derivatives S, S_u, S_v, S_uu, S_uv, S_vv of the (polynomial) tensor product surface
+template<size_t N, class T> std::array<v<N, T>, 6> evaluate_bezier_surface_with_derivatives(const varmesh<N, T>& m, double u, double vv, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
 {
-    varmesh<N> diff_r = m;
+    std::pmr::vector<v<N, T>> values(resource), derivatives_u(resource), second_derivatives_u(resource);
+    std::pmr::vector<v<N, T>> row(m.col_size(), resource);
+
+    for (int i = 0; i < m.row_size(); i++)
+    {
+        for (int j = 0; j < m.col_size(); j++)
+        {
+            row[j] = m.element(i, j);
+        }
+
+        auto derivatives = evaluate_bezier_curve_with_derivatives(row, u);
+        values.push_back(derivatives[0]);
+        derivatives_u.push_back(derivatives[1]);
+        second_derivatives_u.push_back(derivatives[2]);
+    }
+
+    auto derivatives_v = evaluate_bezier_curve_with_derivatives(values, vv);
+    auto mixed_derivatives = evaluate_bezier_curve_with_derivatives(derivatives_u, vv);
+
+    return std::array<v<N, T>, 6>{
+        derivatives_v[0],
+        mixed_derivatives[0],
+        derivatives_v[1],
+        evaluate_bezier_curve(second_derivatives_u, vv),
+        mixed_derivatives[1],
+        derivatives_v[2]
+    };
+}
+
+template<std::size_t N, class T> varmesh<N, T> bezier_surface_quasi_interpolation(const varmesh<N, T>& m, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+{
+    varmesh<N, T> diff_r(m, resource);
 
     for (int j = 0; j < m.col_size(); j++)
     {
@@ -67,7 +100,7 @@ template<std::size_t N> varmesh<N> bezier_surface_quasi_interpolation(const varm
         }
     }
 
-    varmesh<N> result = diff_r;
+    varmesh<N, T> result(diff_r, resource);
 
     for (int i = 0; i < m.row_size(); i++)
     {
@@ -80,13 +113,13 @@ template<std::size_t N> varmesh<N> bezier_surface_quasi_interpolation(const varm
     return result;
 }
 
-template <size_t d> varmesh<d> bezier_surface_insert_control_point_row(const varmesh<d>& m)
+template<size_t d, class T> varmesh<d, T> bezier_surface_insert_control_point_row(const varmesh<d, T>& m)
 {
-    varmesh<d> result(m.row_size(), m.col_size() + 1);
+    varmesh<d, T> result(m.row_size(), m.col_size() + 1);
 
     for (int i = 0; i < m.row_size(); i++)
     {
-        std::vector<v<d>> current_row;
+        std::vector<v<d, T>> current_row;
         for (int j = 0; j < m.col_size(); j++)
         {
             current_row.push_back(m.element(i, j));
@@ -101,13 +134,13 @@ template <size_t d> varmesh<d> bezier_surface_insert_control_point_row(const var
     return result;
 }
 
-template <size_t d> varmesh<d> bezier_surface_insert_control_point_column(const varmesh<d>& m)
+template<size_t d, class T> varmesh<d, T> bezier_surface_insert_control_point_column(const varmesh<d, T>& m)
 {
-    varmesh<d> result(m.row_size() + 1, m.col_size());
+    varmesh<d, T> result(m.row_size() + 1, m.col_size());
 
     for (int i = 0; i < m.col_size(); i++)
     {
-        std::vector<v<d>> current_column;
+        std::vector<v<d, T>> current_column;
         for (int j = 0; j < m.row_size(); j++)
         {
             current_column.push_back(m.element(j, i));
@@ -122,31 +155,31 @@ template <size_t d> varmesh<d> bezier_surface_insert_control_point_column(const
     return result;
 }
 
-template <size_t d> void bezier_clip_surface_by_row(varmesh<d>& m, double umin, double umax)
+template<size_t d, class T> void bezier_clip_surface_by_row(varmesh<d, T>& m, double umin, double umax)
 {
     for (int i = 0; i < m.row_size(); i++)
     {
-        auto cur_row = row_ref<d>(m, i);
-        bezier_clip_curve<row_ref<d>>(cur_row, umin, umax);
+        auto cur_row = row_ref<d, T>(m, i);
+        bezier_clip_curve<row_ref<d, T>>(cur_row, umin, umax);
     }
 }
 
-template <size_t d> void bezier_clip_surface_by_col(varmesh<d>& m, double umin, double umax)
+template<size_t d, class T> void bezier_clip_surface_by_col(varmesh<d, T>& m, double umin, double umax)
 {
     for (int i = 0; i < m.col_size(); i++)
     {
-        auto cur_col = col_ref<d>(m, i);
+        auto cur_col = col_ref<d, T>(m, i);
         bezier_clip_curve(cur_col, umin, umax);
     }
 }
 
-template <size_t d> std::pair<varmesh<d>, varmesh<d>> subdivide_bezier_surface_by_row(const varmesh<d>& m, double u)
+template<size_t d, class T> std::pair<varmesh<d, T>, varmesh<d, T>> subdivide_bezier_surface_by_row(const varmesh<d, T>& m, double u)
 {
-    varmesh<d> left(m.row_size(), m.col_size()), right(m.row_size(), m.col_size());
+    varmesh<d, T> left(m.row_size(), m.col_size()), right(m.row_size(), m.col_size());
 
     for (int i = 0; i < m.row_size(); i++)
     {
-        std::vector<std::array<double, d>> current_row(m.col_size());
+        std::vector<v<d, T>> current_row(m.col_size());
         for (int j = 0; j < m.col_size(); j++)
         {
             current_row[j] = m.element(i, j);
@@ -162,13 +195,13 @@ template <size_t d> std::pair<varmesh<d>, varmesh<d>> subdivide_bezier_surface_b
     return std::make_pair(left, right);
 }
 
-template <size_t d> std::pair<varmesh<d>, varmesh<d>> subdivide_bezier_surface_by_column(const varmesh<d>& m, double u)
+template<size_t d, class T> std::pair<varmesh<d, T>, varmesh<d, T>> subdivide_bezier_surface_by_column(const varmesh<d, T>& m, double u)
 {
-    varmesh<d> top(m.row_size(), m.col_size()), bottom(m.row_size(), m.col_size());
+    varmesh<d, T> top(m.row_size(), m.col_size()), bottom(m.row_size(), m.col_size());
 
     for (int i = 0; i < m.col_size(); i++)
     {
-        std::vector<v<d>> current_column(m.row_size());
+        std::vector<v<d, T>> current_column(m.row_size());
         for (int j = 0; j < m.row_size(); j++)
         {
             current_column[j] = m.element(j, i);
@@ -184,7 +217,7 @@ template <size_t d> std::pair<varmesh<d>, varmesh<d>> subdivide_bezier_surface_b
     return std::make_pair(top, bottom);
 }
 
-template<size_t d> void bezier_clip_surface(varmesh<d>& m, const v2& u, const v2& v)
+template<size_t d, class T> void bezier_clip_surface(varmesh<d, T>& m, const v2& u, const v2& v)
 {
     bezier_clip_surface_by_row(m, u[0], u[1]);
     bezier_clip_surface_by_col(m, v[0], v[1]);
@@ -192,34 +225,4 @@ template<size_t d> void bezier_clip_surface(varmesh<d>& m, const v2& u, const v2
 
 varmesh<2> get_bezier_clipped_surface(const varmesh<2>& m, const v2& u, const v2& v);
 
-template<size_t d> std::vector<varmesh<d>> mesh_subdivision_hierarchy(const varmesh<d> m, int steps)
-{
-    std::vector<varmesh<d>> meshes_hierarchy;
-
-    meshes_hierarchy.push_back(m);
-
-    size_t from_index = 0;
-    size_t to_index = 0;
-    for (int s = 0; s < steps; s++)
-    {
-        for (size_t i = from_index; i <= to_index; i++)
-        {
-            auto div_m = subdivide_bezier_surface_by_row(meshes_hierarchy[i], 0.5);
-            auto lm = subdivide_bezier_surface_by_column(div_m.first, 0.5);
-
-            meshes_hierarchy.push_back(lm.first);
-            meshes_hierarchy.push_back(lm.second);
-
-            lm = subdivide_bezier_surface_by_column(div_m.second, 0.5);
-
-            meshes_hierarchy.push_back(lm.first);
-            meshes_hierarchy.push_back(lm.second);
-        }
-        from_index = to_index + 1;
-        to_index = meshes_hierarchy.size() - 1;
-    }
-
-    return meshes_hierarchy;
-}
-
 #endif
\ No newline at end of file
@@ -3,46 +3,61 @@
 
 #include "vector.h"
 
+#include <memory_resource>
 #include <string>
 #include <sstream>
+#include <vector>
 
-template<size_t DIM> class varmesh
+// control points of a tensor product surface, stored row by row
+template<size_t DIM, class T = double> class varmesh
 {
 public:
     class row_index {
     public:
-        row_index(varmesh<DIM>& ref, int row) : referenced{ ref }, referenced_row{ row } {}
-        v<DIM>& operator[](int col)
+        row_index(varmesh<DIM, T>& ref, int row) : referenced{ ref }, referenced_row{ row } {}
+        v<DIM, T>& operator[](int col)
         {
             return referenced.element(referenced_row, col);
         }
     private:
-        varmesh<DIM>& referenced;
+        varmesh<DIM, T>& referenced;
         int referenced_row;
     };
 
     class const_row_index {
     public:
-        const_row_index(const varmesh<DIM>& ref, int row) : referenced{ ref }, referenced_row{ row } {}
-        const v<DIM>& operator[](int col) const
+        const_row_index(const varmesh<DIM, T>& ref, int row) : referenced{ ref }, referenced_row{ row } {}
+        const v<DIM, T>& operator[](int col) const
         {
             return referenced.element(referenced_row, col);
         }
     private:
-        const varmesh<DIM>& referenced;
+        const varmesh<DIM, T>& referenced;
         int referenced_row;
     };
 
-    varmesh(size_t r, size_t c): rows{r}, cols{c}, points{r * c}
+    // the control points are allocated from resource, e.g. the scratch arena of the clipping; copies go to the default
+    // resource, unless given another one
+    varmesh(size_t r, size_t c, std::pmr::memory_resource* resource = std::pmr::get_default_resource()): rows{r}, cols{c}, points{r * c, resource}
     {
     }
 
-    inline v<DIM>& element(size_t r, size_t c)
+    varmesh(const varmesh& m) = default;
+    varmesh(varmesh&& m) = default;
+
+    varmesh(const varmesh& m, std::pmr::memory_resource* resource): rows{m.rows}, cols{m.cols}, points{m.points, resource}
+    {
+    }
+
+    varmesh& operator=(const varmesh& m) = default;
+    varmesh& operator=(varmesh&& m) = default;
+
+    inline v<DIM, T>& element(size_t r, size_t c)
     {
         return points[r * cols + c];
     }
     
-    inline const v<DIM>& element(size_t r, size_t c) const
+    inline const v<DIM, T>& element(size_t r, size_t c) const
     {
         return points[r * cols + c];
     }
@@ -72,9 +87,9 @@ public:
         return points.size();
     }
 
-    std::vector<v<DIM>> get_points() const
+    std::vector<v<DIM, T>> get_points() const
     {
-        return points;
+        return std::vector<v<DIM, T>>(points.begin(), points.end());
     }
 
     std::string to_string() const
@@ -104,14 +119,14 @@ public:
 private:
     size_t rows;
     size_t cols;
-    std::vector<v<DIM>> points;
+    std::pmr::vector<v<DIM, T>> points;
 };
 
 v3 normale_of_varmesh(const varmesh<4>& m, size_t r, size_t c);
 
-template<std::size_t N> varmesh<N - 1> remove_dimension(const varmesh<N>& m)
+template<std::size_t N, class T> varmesh<N - 1, T> remove_dimension(const varmesh<N, T>& m)
 {
-    varmesh<N - 1> result(m.row_size(), m.col_size());
+    varmesh<N - 1, T> result(m.row_size(), m.col_size());
 
     for (size_t i = 0; i < m.row_size(); i++)
     {
@@ -124,9 +139,9 @@ template<std::size_t N> varmesh<N - 1> remove_dimension(const varmesh<N>& m)
     return result;
 }
 
-template <size_t d> v<d> barycentre_of_mesh(const varmesh<d>& m)
+template <size_t d, class T> v<d, T> barycentre_of_mesh(const varmesh<d, T>& m)
 {
-    v<d> origin{ {0} };
+    v<d, T> origin{ {0} };
 
     for (int i = 0; i < m.row_size(); i++)
     {
@@ -141,9 +156,9 @@ template <size_t d> v<d> barycentre_of_mesh(const varmesh<d>& m)
     return origin;
 }
 
-template<size_t N> std::vector<v<N>> row(const varmesh<N>& m, size_t index)
+template<size_t N, class T> std::vector<v<N, T>> row(const varmesh<N, T>& m, size_t index)
 {
-    std::vector<v<N>> result;
+    std::vector<v<N, T>> result;
 
     for (int i = 0; i < m.col_size(); i++)
     {
@@ -153,9 +168,9 @@ template<size_t N> std::vector<v<N>> row(const varmesh<N>& m, size_t index)
     return result;
 }
 
-template<size_t N> std::vector<v<N>> col(const varmesh<N>& m, size_t index)
+template<size_t N, class T> std::vector<v<N, T>> col(const varmesh<N, T>& m, size_t index)
 {
-    std::vector<v<N>> result;
+    std::vector<v<N, T>> result;
 
     for (int i = 0; i < m.row_size(); i++)
     {
@@ -165,9 +180,9 @@ template<size_t N> std::vector<v<N>> col(const varmesh<N>& m, size_t index)
     return result;
 }
 
-template<size_t N> varmesh<N> transpose(const varmesh<N>& m)
+template<size_t N, class T> varmesh<N, T> transpose(const varmesh<N, T>& m)
 {
-    varmesh<N> result(m.col_size(), m.row_size());
+    varmesh<N, T> result(m.col_size(), m.row_size());
 
     for (int i = 0; i < m.col_size(); i++)
     {
@@ -180,16 +195,16 @@ template<size_t N> varmesh<N> transpose(const varmesh<N>& m)
     return result;
 }
 
-template <size_t d>
+template <size_t d, class T = double>
 class col_ref {
-    varmesh<d>& m;
+    varmesh<d, T>& m;
     size_t ci;
 public:
-    col_ref(varmesh<d>& pm, size_t pci) : m{ pm }, ci{ pci }
+    col_ref(varmesh<d, T>& pm, size_t pci) : m{ pm }, ci{ pci }
     {
 
     }
-    v<d>& operator[](const size_t ri)
+    v<d, T>& operator[](const size_t ri)
     {
         return m.element(ri, ci);
     }
@@ -199,16 +214,16 @@ public:
     }
 };
 
-template <size_t d>
+template <size_t d, class T = double>
 class row_ref {
-    varmesh<d>& m;
+    varmesh<d, T>& m;
     size_t ri;
 public:
-    row_ref(varmesh<d>& pm, size_t pri) : m{ pm }, ri{ pri }
+    row_ref(varmesh<d, T>& pm, size_t pri) : m{ pm }, ri{ pri }
     {
 
     }
-    v<d>& operator[](const size_t ci)
+    v<d, T>& operator[](const size_t ci)
     {
         return m.element(ri, ci);
     }
@@ -218,16 +233,16 @@ public:
     }
 };
 
-template <size_t d>
+template <size_t d, class T = double>
 class row_ref_const {
-    const varmesh<d>& m;
+    const varmesh<d, T>& m;
     size_t ri;
 public:
-    row_ref_const(const varmesh<d>& pm, size_t pri) : m{ pm }, ri{ pri }
+    row_ref_const(const varmesh<d, T>& pm, size_t pri) : m{ pm }, ri{ pri }
     {
 
     }
-    const v<d>& operator[](const size_t ci) const
+    const v<d, T>& operator[](const size_t ci) const
     {
         return m.element(ri, ci);
     }
@@ -237,16 +252,16 @@ public:
     }
 };
 
-template <size_t d>
+template <size_t d, class T = double>
 class col_ref_const {
-    const varmesh<d>& m;
+    const varmesh<d, T>& m;
     size_t ci;
 public:
-    col_ref_const(const varmesh<d>& pm, size_t pci) : m{ pm }, ci{ pci }
+    col_ref_const(const varmesh<d, T>& pm, size_t pci) : m{ pm }, ci{ pci }
     {
 
     }
-    const v<d>& operator[](const size_t ri) const
+    const v<d, T>& operator[](const size_t ri) const
     {
         return m.element(ri, ci);
     }
@@ -256,7 +271,7 @@ public:
     }
 };
 
-template<size_t d> varmesh<d> operator+(varmesh<d> mesh, v<d> translate)
+template<size_t d, class T> varmesh<d, T> operator+(varmesh<d, T> mesh, v<d, T> translate)
 {
     for (int i = 0; i < mesh.row_size(); i++)
         for (int j = 0; j < mesh.col_size(); j++)
@@ -265,6 +280,25 @@ template<size_t d> varmesh<d> operator+(varmesh<d> mesh, v<d> translate)
     return mesh;
 }
 
+// the same control points with another scalar type, e.g. for the float fast path of the clipping
+template<class S, size_t d, class T> varmesh<d, S> mesh_cast(const varmesh<d, T>& m, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+{
+    varmesh<d, S> result(m.row_size(), m.col_size(), resource);
+
+    for (int i = 0; i < m.row_size(); i++)
+    {
+        for (int j = 0; j < m.col_size(); j++)
+        {
+            for (int k = 0; k < d; k++)
+            {
+                result.element(i, j)[k] = S(m.element(i, j)[k]);
+            }
+        }
+    }
+
+    return result;
+}
+
 varmesh<4> move(varmesh<4> mesh, v<3> translate);
 
 varmesh<4> scale(varmesh<4> mesh, double scale);
@@ -4,16 +4,19 @@
 #include <array>
 #include <vector>
 #include <cmath>
+#include <concepts>
+#include <type_traits>
 
-template <size_t N> using v = std::array<double, N>;
+// the scalar type defaults to double; float vectors are used by the float fast path of the clipping
+template <size_t N, class T = double> using v = std::array<T, N>;
 typedef v<1> v1;
 typedef v<2> v2;
 typedef v<3> v3;
 typedef v<4> v4;
 
-template<std::size_t N> v<N> operator+(const v<N>& p, const v<N>& q)
+template<std::size_t N, std::floating_point T> v<N, T> operator+(const v<N, T>& p, const v<N, T>& q)
 {
-    v<N> result;
+    v<N, T> result;
     
     for (int i = 0; i < N; i++)
     {
@@ -23,9 +26,9 @@ template<std::size_t N> v<N> operator+(const v<N>& p, const v<N>& q)
     return result;
 }
 
-template<std::size_t N> double operator*(const v<N>& p, const v<N>& q)
+template<std::size_t N, std::floating_point T> T operator*(const v<N, T>& p, const v<N, T>& q)
 {
-    double result = 0;
+    T result = 0;
     
     for (int i = 0; i < N; i++)
     {
@@ -35,9 +38,9 @@ template<std::size_t N> double operator*(const v<N>& p, const v<N>& q)
     return result;
 }
 
-template<std::size_t N> v<N> operator-(const v<N>& p, const v<N>& q)
+template<std::size_t N, std::floating_point T> v<N, T> operator-(const v<N, T>& p, const v<N, T>& q)
 {
-    std::array<double, N> result;
+    v<N, T> result;
     
     for (int i = 0; i < N; i++)
     {
@@ -47,9 +50,9 @@ template<std::size_t N> v<N> operator-(const v<N>& p, const v<N>& q)
     return result;
 }
 
-template<std::size_t N> v<N> operator-(const v<N>& p)
+template<std::size_t N, std::floating_point T> v<N, T> operator-(const v<N, T>& p)
 {
-    std::array<double, N> result;
+    v<N, T> result;
     
     for (int i = 0; i < N; i++)
     {
@@ -59,9 +62,9 @@ template<std::size_t N> v<N> operator-(const v<N>& p)
     return result;
 }
 
-template<std::size_t N> v<N> operator*(double scale, const v<N>& q)
+template<std::size_t N, std::floating_point T> v<N, T> operator*(std::type_identity_t<T> scale, const v<N, T>& q)
 {
-    std::array<double, N> result;
+    v<N, T> result;
     
     for (int i = 0; i < N; i++)
     {
@@ -71,19 +74,19 @@ template<std::size_t N> v<N> operator*(double scale, const v<N>& q)
     return result;
 }
 
-template<std::size_t N> double length2(const v<N>& p)
+template<std::size_t N, std::floating_point T> T length2(const v<N, T>& p)
 {
     return p * p;
 }
 
-template<std::size_t N> double length(const v<N>& p)
+template<std::size_t N, std::floating_point T> T length(const v<N, T>& p)
 {
     return std::sqrt(length2(p));
 }
 
-template<std::size_t N> double l_inf(const v<N>& p)
+template<std::size_t N, std::floating_point T> T l_inf(const v<N, T>& p)
 {
-    double max = std::abs(p[0]);
+    T max = std::abs(p[0]);
     
     for (int i = 1; i < N; i++)
     {
@@ -96,9 +99,9 @@ template<std::size_t N> double l_inf(const v<N>& p)
     return max;
 }
 
-template<std::size_t N> v<N+1> add_dimension(const v<N>& p)
+template<std::size_t N, std::floating_point T> v<N+1, T> add_dimension(const v<N, T>& p)
 {
-    v<N + 1> result;
+    v<N + 1, T> result;
     
     for (int i = 0; i < N; i++)
     {
@@ -110,11 +113,11 @@ template<std::size_t N> v<N+1> add_dimension(const v<N>& p)
     return result;
 }
 
-template<std::size_t N> v<N-1> remove_dimension(const v<N>& p)
+template<std::size_t N, std::floating_point T> v<N-1, T> remove_dimension(const v<N, T>& p)
 {
-    v<N - 1> result;
+    v<N - 1, T> result;
     
-    double scale = (0 == p[N-1] ? 0 : 1./p[N-1]);
+    T scale = (0 == p[N-1] ? 0 : 1./p[N-1]);
     
     for (int i = 0; i < N - 1; i++)
     {
@@ -124,9 +127,9 @@ template<std::size_t N> v<N-1> remove_dimension(const v<N>& p)
     return result;
 }
 
-template<std::size_t N> v<N - 1> remove_last_component(const v<N>& p)
+template<std::size_t N, std::floating_point T> v<N - 1, T> remove_last_component(const v<N, T>& p)
 {
-    v<N - 1> result;
+    v<N - 1, T> result;
 
     for (int i = 0; i < N - 1; i++)
     {
@@ -136,11 +139,11 @@ template<std::size_t N> v<N - 1> remove_last_component(const v<N>& p)
     return result;
 }
 
-template<std::size_t N> v<N> normalize(const v<N>& p)
+template<std::size_t N, std::floating_point T> v<N, T> normalize(const v<N, T>& p)
 {
-    double l = length(p);
+    T l = length(p);
     
-    double scale = (0 == l ? 0 : 1./l);
+    T scale = (0 == l ? 0 : 1./l);
     
     return scale * p;
 }
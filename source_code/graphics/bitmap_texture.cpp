@@ -0,0 +1,35 @@
+#include "bitmap_texture.h"
+
+#include <algorithm>
+#include <cmath>
+
+color sample_bitmap(const bitmap_texture& bitmap, double u, double v)
+{
+	double x = std::clamp(u * bitmap.width - 0.5, 0., bitmap.width - 1.);
+	double y = std::clamp(v * bitmap.height - 0.5, 0., bitmap.height - 1.);
+
+	int x0 = std::min(int(x), bitmap.width - 1);
+	int y0 = std::min(int(y), bitmap.height - 1);
+	int x1 = std::min(x0 + 1, bitmap.width - 1);
+	int y1 = std::min(y0 + 1, bitmap.height - 1);
+
+	double fx = x - x0;
+	double fy = y - y0;
+
+	const color& c00 = bitmap.texels[y0 * bitmap.width + x0];
+	const color& c01 = bitmap.texels[y0 * bitmap.width + x1];
+	const color& c10 = bitmap.texels[y1 * bitmap.width + x0];
+	const color& c11 = bitmap.texels[y1 * bitmap.width + x1];
+
+	color result;
+
+	for (int c = 0; c < 3; c++)
+	{
+		double top = (1 - fx) * c00[c] + fx * c01[c];
+		double bottom = (1 - fx) * c10[c] + fx * c11[c];
+
+		result[c] = int(std::round((1 - fy) * top + fy * bottom));
+	}
+
+	return result;
+}
@@ -0,0 +1,21 @@
+#ifndef bitmap_texture_h
+#define bitmap_texture_h
+
+#include <array>
+#include <vector>
+
+// 8 bit rgb, returned by value, so that shading a hit doesn't allocate
+using color = std::array<int, 3>;
+
+// texels are stored row by row, v selects the row
+struct bitmap_texture
+{
+	int width;
+	int height;
+	std::vector<color> texels;
+};
+
+// bilinear filtering between the centres of the four nearest texels, clamped at the border
+color sample_bitmap(const bitmap_texture& bitmap, double u, double v);
+
+#endif
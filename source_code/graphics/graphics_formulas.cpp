@@ -5,3 +5,36 @@ double shade(const v3& normale, const v3& light_direction)
     return (1 + normalize(normale) * normalize(-light_direction)) / 2;
 }
 
+
+v3 reflect(const v3& direction, const v3& normale)
+{
+    v3 n = normalize(normale);
+
+    return direction - (2 * (direction * n)) * n;
+}
+
+std::optional<v3> refract(const v3& direction, const v3& normale, double refractive_index)
+{
+    // the patch orientation (du x dv) decides, whether the ray enters or leaves the medium
+    v3 n = normalize(normale);
+    v3 d = normalize(direction);
+
+    double cos_incident = -(d * n);
+    double eta = 1. / refractive_index;
+
+    if (0 > cos_incident)
+    {
+        n = -n;
+        cos_incident = -cos_incident;
+        eta = refractive_index;
+    }
+
+    double k = 1 - eta * eta * (1 - cos_incident * cos_incident);
+
+    if (0 > k)
+    {
+        return {};
+    }
+
+    return eta * d + (eta * cos_incident - std::sqrt(k)) * n;
+}
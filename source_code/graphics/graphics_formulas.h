@@ -3,6 +3,12 @@
 
 #include <geometry/types/vector.h>
 
+#include <optional>
+
 double shade(const v3& normale, const v3& light_direction);
 
+v3 reflect(const v3& direction, const v3& normale);
+
+std::optional<v3> refract(const v3& direction, const v3& normale, double refractive_index);
+
 #endif
@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <limits>
+
+#include "hdr_image.h"
+
+hdr_image::hdr_image(int width, int height) : width(width), height(height), weights(size_t(width) * height, 0)
+{
+    for (auto& channel : channels)
+    {
+        channel.assign(weights.size(), 0);
+    }
+}
+
+v3 hdr_image::resolve(int index) const
+{
+    if (weights[index] <= 0)
+    {
+        return v3{ 0, 0, 0 };
+    }
+
+    return v3{ channels[0][index] / weights[index], channels[1][index] / weights[index], channels[2][index] / weights[index] };
+}
+
+std::vector<int> tone_map(const hdr_image& image, const tone_mapping& mapping)
+{
+    size_t size = image.weights.size();
+
+    std::vector<int> pixel(3 * size);
+
+    // branch free loops over the planes, which the compiler vectorizes; a pixel without samples has the sum 0
+    std::vector<float> scale(size);
+
+    const float* weights = image.weights.data();
+    float exposure = float(mapping.exposure);
+
+    for (size_t i = 0; i < size; i++)
+    {
+        scale[i] = exposure / std::max(weights[i], std::numeric_limits<float>::min());
+    }
+
+    for (int c = 0; c < 3; c++)
+    {
+        const float* channel = image.channels[c].data();
+        int* target = pixel.data() + c;
+
+        if (tone_operator::reinhard == mapping.op)
+        {
+            for (size_t i = 0; i < size; i++)
+            {
+                float value = std::max(channel[i] * scale[i], 0.f);
+
+                target[3 * i] = int(255 * (value / (1 + value)) + 0.5f);
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < size; i++)
+            {
+                float value = std::min(std::max(channel[i] * scale[i], 0.f), 1.f);
+
+                target[3 * i] = int(255 * value + 0.5f);
+            }
+        }
+    }
+
+    return pixel;
+}
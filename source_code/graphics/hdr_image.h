@@ -0,0 +1,48 @@
+#ifndef hdr_image_h
+#define hdr_image_h
+
+#include <array>
+#include <vector>
+
+#include <geometry/types/vector.h>
+
+// planar float rgb in units of the 8 bit white, so 1 is 255; each pixel accumulates weighted samples, its colour is
+// the sum of the samples divided by the sum of their weights
+struct hdr_image
+{
+	hdr_image(int width, int height);
+
+	// index is width * y + x
+	void add_sample(int index, const v3& radiance, float weight = 1)
+	{
+		for (int c = 0; c < 3; c++)
+		{
+			channels[c][index] += weight * float(radiance[c]);
+		}
+
+		weights[index] += weight;
+	}
+
+	// the mean of the samples, black without samples
+	v3 resolve(int index) const;
+
+	int width;
+	int height;
+	std::array<std::vector<float>, 3> channels;
+	std::vector<float> weights;
+};
+
+enum class tone_operator { linear, reinhard };
+
+struct tone_mapping
+{
+	// factor applied to the resolved colours before the operator
+	double exposure = 1;
+	// linear clamps at white, reinhard compresses c to c / (1 + c)
+	tone_operator op = tone_operator::linear;
+};
+
+// quantizes the resolved colours to 8 bit in the interleaved layout of the pixel buffers of the tracers
+std::vector<int> tone_map(const hdr_image& image, const tone_mapping& mapping = {});
+
+#endif
@@ -0,0 +1,39 @@
+#include "material.h"
+
+#include <algorithm>
+#include <cmath>
+
+color sample_checker(const color& even, const color& odd, double frequency, double u, double v)
+{
+	int color_index = ((int)std::round(u * frequency) + (int)std::round(v * frequency)) % 2;
+
+	// negative parameters give negative remainders, which count as even
+	return 0 < color_index ? odd : even;
+}
+
+material constant_material(const color& c)
+{
+	return material{ material_kind::constant, c };
+}
+
+material checker_material(const color& even, const color& odd, double frequency)
+{
+	return material{ material_kind::checker, even, odd, frequency };
+}
+
+color material_table::sample(int object, double u, double v, double footprint) const
+{
+	const material& m = materials[object];
+
+	switch (m.kind)
+	{
+	case material_kind::checker:
+		return sample_checker(m.first, m.second, m.frequency, u, v);
+	case material_kind::bitmap:
+		return sample_bitmap(bitmaps[m.bitmap], u, v);
+	case material_kind::mipmap:
+		return mipmaps[m.bitmap].sample(u, v, footprint);
+	default:
+		return m.first;
+	}
+}
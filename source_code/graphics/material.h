@@ -0,0 +1,44 @@
+#ifndef material_h
+#define material_h
+
+#include <vector>
+
+#include <graphics/bitmap_texture.h>
+#include <graphics/mipmapped_texture.h>
+
+// the checker of the test scenes: squares of size 1 / frequency centred on the multiples of 1 / frequency
+color sample_checker(const color& even, const color& odd, double frequency, double u, double v);
+
+enum class material_kind { constant, checker, bitmap, mipmap };
+
+struct material
+{
+	material_kind kind = material_kind::constant;
+	color first{ {255, 255, 255} };
+	// the odd squares of a checker
+	color second{ {0, 0, 0} };
+	double frequency = 10;
+	// index into the bitmaps or the mip maps of the material table
+	int bitmap = -1;
+};
+
+material constant_material(const color& c);
+material checker_material(const color& even, const color& odd, double frequency = 10);
+
+// one material per object id; the textures are shared by the materials
+struct material_table
+{
+	std::vector<material> materials;
+	std::vector<bitmap_texture> bitmaps;
+	std::vector<mipmapped_texture> mipmaps;
+
+	bool has_material(int object) const { return object < materials.size(); }
+
+	// only mip maps filter by the footprint of the pixel, which is expensive to compute
+	bool needs_footprint(int object) const { return has_material(object) && material_kind::mipmap == materials[object].kind; }
+
+	// footprint is the edge length of the pixel in uv
+	color sample(int object, double u, double v, double footprint = 0) const;
+};
+
+#endif
@@ -0,0 +1,133 @@
+#include "mipmapped_texture.h"
+
+#include <algorithm>
+#include <cmath>
+
+mipmapped_texture::level mipmapped_texture::make_level(int width, int height)
+{
+	int tiles_x = (width + tile_size - 1) / tile_size;
+	int tiles_y = (height + tile_size - 1) / tile_size;
+
+	return level{ width, height, tiles_x, std::vector<packed_texel>(tiles_x * tiles_y * tile_size * tile_size, packed_texel{ 0, 0, 0, 0 }) };
+}
+
+size_t mipmapped_texture::texel_index(const level& l, int x, int y)
+{
+	size_t tile = (y / tile_size) * l.tiles_x + x / tile_size;
+
+	return tile * tile_size * tile_size + (y % tile_size) * tile_size + x % tile_size;
+}
+
+mipmapped_texture::mipmapped_texture(const bitmap_texture& bitmap)
+{
+	levels.push_back(make_level(bitmap.width, bitmap.height));
+
+	for (int y = 0; y < bitmap.height; y++)
+	{
+		for (int x = 0; x < bitmap.width; x++)
+		{
+			const color& c = bitmap.texels[y * bitmap.width + x];
+
+			levels[0].texels[texel_index(levels[0], x, y)] = packed_texel{ std::uint8_t(c[0]), std::uint8_t(c[1]), std::uint8_t(c[2]), 0 };
+		}
+	}
+
+	while (1 < levels.back().width || 1 < levels.back().height)
+	{
+		const level& finer = levels.back();
+
+		level coarser = make_level(std::max(1, (finer.width + 1) / 2), std::max(1, (finer.height + 1) / 2));
+
+		for (int y = 0; y < coarser.height; y++)
+		{
+			for (int x = 0; x < coarser.width; x++)
+			{
+				// odd sizes repeat the last row or column of the finer level
+				int x0 = std::min(2 * x, finer.width - 1), x1 = std::min(2 * x + 1, finer.width - 1);
+				int y0 = std::min(2 * y, finer.height - 1), y1 = std::min(2 * y + 1, finer.height - 1);
+
+				packed_texel& t = coarser.texels[texel_index(coarser, x, y)];
+
+				for (int c = 0; c < 3; c++)
+				{
+					int sum = finer.texels[texel_index(finer, x0, y0)][c] + finer.texels[texel_index(finer, x1, y0)][c]
+						+ finer.texels[texel_index(finer, x0, y1)][c] + finer.texels[texel_index(finer, x1, y1)][c];
+
+					t[c] = std::uint8_t((sum + 2) / 4);
+				}
+			}
+		}
+
+		levels.push_back(std::move(coarser));
+	}
+}
+
+color mipmapped_texture::texel(int level, int x, int y) const
+{
+	const packed_texel& t = levels[level].texels[texel_index(levels[level], x, y)];
+
+	return color{ {t[0], t[1], t[2]} };
+}
+
+double mipmapped_texture::level_of_detail(double footprint) const
+{
+	double texels = footprint * std::max(levels[0].width, levels[0].height);
+
+	if (texels <= 1)
+	{
+		return 0;
+	}
+
+	return std::min(std::log2(texels), double(levels.size() - 1));
+}
+
+v3 mipmapped_texture::sample_level(int index, double u, double v) const
+{
+	const level& l = levels[index];
+
+	double x = std::clamp(u * l.width - 0.5, 0., l.width - 1.);
+	double y = std::clamp(v * l.height - 0.5, 0., l.height - 1.);
+
+	int x0 = std::min(int(x), l.width - 1);
+	int y0 = std::min(int(y), l.height - 1);
+	int x1 = std::min(x0 + 1, l.width - 1);
+	int y1 = std::min(y0 + 1, l.height - 1);
+
+	double fx = x - x0;
+	double fy = y - y0;
+
+	const packed_texel& c00 = l.texels[texel_index(l, x0, y0)];
+	const packed_texel& c01 = l.texels[texel_index(l, x1, y0)];
+	const packed_texel& c10 = l.texels[texel_index(l, x0, y1)];
+	const packed_texel& c11 = l.texels[texel_index(l, x1, y1)];
+
+	v3 result;
+
+	for (int c = 0; c < 3; c++)
+	{
+		double top = (1 - fx) * c00[c] + fx * c01[c];
+		double bottom = (1 - fx) * c10[c] + fx * c11[c];
+
+		result[c] = (1 - fy) * top + fy * bottom;
+	}
+
+	return result;
+}
+
+color mipmapped_texture::sample(double u, double v, double footprint) const
+{
+	double lod = level_of_detail(footprint);
+
+	int finer = int(lod);
+	int coarser = std::min(finer + 1, level_count() - 1);
+	double t = lod - finer;
+
+	v3 filtered = sample_level(finer, u, v);
+
+	if (0 < t)
+	{
+		filtered = (1 - t) * filtered + t * sample_level(coarser, u, v);
+	}
+
+	return color{ {int(std::round(filtered[0])), int(std::round(filtered[1])), int(std::round(filtered[2]))} };
+}
@@ -0,0 +1,51 @@
+#ifndef mipmapped_texture_h
+#define mipmapped_texture_h
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <geometry/types/vector.h>
+#include <graphics/bitmap_texture.h>
+
+// image texture with a box filtered mip map chain; the texels of each level are stored in square tiles, so that the
+// four texels of a bilinear lookup usually share a cache line, also for large textures
+class mipmapped_texture
+{
+public:
+	mipmapped_texture(const bitmap_texture& bitmap);
+
+	int level_count() const { return levels.size(); }
+	int width(int level) const { return levels[level].width; }
+	int height(int level) const { return levels[level].height; }
+
+	color texel(int level, int x, int y) const;
+
+	// level of detail for a pixel covering footprint in uv, 0 for footprints up to one texel of the finest level
+	double level_of_detail(double footprint) const;
+
+	// trilinear lookup: bilinear in the two levels around the level of detail of footprint, clamped at the border
+	color sample(double u, double v, double footprint) const;
+
+	static const int tile_size = 8;
+
+private:
+	using packed_texel = std::array<std::uint8_t, 4>;
+
+	struct level
+	{
+		int width;
+		int height;
+		int tiles_x;
+		std::vector<packed_texel> texels;
+	};
+
+	static level make_level(int width, int height);
+	static size_t texel_index(const level& l, int x, int y);
+
+	v3 sample_level(int level, double u, double v) const;
+
+	std::vector<level> levels;
+};
+
+#endif
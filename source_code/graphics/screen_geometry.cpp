@@ -2,6 +2,7 @@
 
 #include <numbers>
 #include <cmath>
+#include <algorithm>
 
 screen_geometry::screen_geometry(int screen_width, int screen_height, double field_of_view, double a1, double a2, double a3) : sw(screen_width), sh(screen_height), fov(field_of_view)
 {
@@ -14,17 +15,29 @@ screen_geometry::screen_geometry(int screen_width, int screen_height, double fie
 }
 
 v3 screen_geometry::get_corresponding_ray(int x, int y)
+{
+    return get_corresponding_ray(x, y, 0.5, 0.5);
+}
+
+v3 screen_geometry::get_corresponding_ray(int x, int y, double dx, double dy)
 {
     double invWidth = 1. / double(sw);
     double invHeight = 1. / double(sh);
 
-    double xx = (2 * ((x + 0.5) * invWidth) - 1) * tan_fov_x;
+    double xx = (2 * ((x + dx) * invWidth) - 1) * tan_fov_x;
 
-    double yy = (1 - 2 * ((y + 0.5) * invHeight)) * tan_fov_y;    
+    double yy = (1 - 2 * ((y + dy) * invHeight)) * tan_fov_y;    
 
     return remove_dimension(rotation * v4{ xx, yy, 1, 1 });
 }
 
+std::pair<v3, v3> screen_geometry::get_ray_differentials(int x, int y)
+{
+    v3 ray = normalize(get_corresponding_ray(x, y));
+
+    return std::make_pair(normalize(get_corresponding_ray(x + 1, y)) - ray, normalize(get_corresponding_ray(x, y + 1)) - ray);
+}
+
 std::tuple<int, int> screen_geometry::get_corresponding_screen_pixel(v3 ray)
 {
     ray = remove_dimension(inverse_rotation * add_dimension(ray));
@@ -36,3 +49,29 @@ std::tuple<int, int> screen_geometry::get_corresponding_screen_pixel(v3 ray)
 
 	return std::tuple<int, int>(x, y);
 }
+
+
+std::vector<screen_tile> screen_tiles_overlapping(int screen_width, int screen_height, int tile_size, int x0, int y0, int x1, int y1)
+{
+    std::vector<screen_tile> tiles;
+
+    x0 = std::max(x0, 0);
+    y0 = std::max(y0, 0);
+    x1 = std::min(x1, screen_width - 1);
+    y1 = std::min(y1, screen_height - 1);
+
+    if (x0 > x1 || y0 > y1)
+    {
+        return tiles;
+    }
+
+    for (int ty = y0 / tile_size; ty <= y1 / tile_size; ty++)
+    {
+        for (int tx = x0 / tile_size; tx <= x1 / tile_size; tx++)
+        {
+            tiles.push_back(screen_tile{ tx * tile_size, ty * tile_size, std::min((tx + 1) * tile_size, screen_width), std::min((ty + 1) * tile_size, screen_height) });
+        }
+    }
+
+    return tiles;
+}
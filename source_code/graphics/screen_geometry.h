@@ -2,15 +2,32 @@
 #define screen_geometry_h
 
 #include <tuple>
+#include <vector>
 
 #include <geometry/types/vector.h>
 #include <geometry/types/matrix.h>
 
+// the pixels [x_begin, x_end) x [y_begin, y_end)
+struct screen_tile
+{
+	int x_begin;
+	int y_begin;
+	int x_end;
+	int y_end;
+};
+
+// tiles of the regular grid with edge length tile_size, that overlap the pixels [x0, x1] x [y0, y1]
+std::vector<screen_tile> screen_tiles_overlapping(int screen_width, int screen_height, int tile_size, int x0, int y0, int x1, int y1);
+
 class screen_geometry
 {
 public:
 	screen_geometry(int screen_width, int screen_height, double field_of_view, double a1, double a2, double a3);
 	v3 get_corresponding_ray(int x, int y);
+	// through the point (dx, dy) of the pixel, the centre is (0.5, 0.5)
+	v3 get_corresponding_ray(int x, int y, double dx, double dy);
+	// differences of the normalized rays of the next pixels in x and in y to the normalized ray of the pixel
+	std::pair<v3, v3> get_ray_differentials(int x, int y);
 	std::tuple<int, int> get_corresponding_screen_pixel(v3 ray);
 private:
 	int sw;
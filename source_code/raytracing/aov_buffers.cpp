@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <limits>
+
+#include "aov_buffers.h"
+
+aov_buffers::aov_buffers(int width, int height, const aov_selection& selection) : width(width), height(height), selection(selection)
+{
+    size_t size = size_t(width) * height;
+
+    if (selection.depth)
+    {
+        depth.assign(size, std::numeric_limits<float>::infinity());
+    }
+
+    if (selection.normal)
+    {
+        for (auto& component : normal)
+        {
+            component.assign(size, 0);
+        }
+    }
+
+    if (selection.uv)
+    {
+        for (auto& component : uv)
+        {
+            component.assign(size, 0);
+        }
+    }
+
+    if (selection.object_id)
+    {
+        object_id.assign(size, -1);
+    }
+
+    if (selection.cost)
+    {
+        cost.assign(size, 0);
+    }
+}
+
+void aov_buffers::store(int index, const std::optional<std::tuple<int, v3, v3, v2>>& intersection, long long steps)
+{
+    if (selection.cost)
+    {
+        cost[index] = int(std::min<long long>(steps, std::numeric_limits<int>::max()));
+    }
+
+    if (!intersection.has_value())
+    {
+        return;
+    }
+
+    const auto& [scene_object, distance_vector, normale, uv_parameter] = *intersection;
+
+    if (selection.depth)
+    {
+        depth[index] = float(length(distance_vector));
+    }
+
+    if (selection.normal && 0 < length2(normale))
+    {
+        v3 n = normalize(normale);
+
+        for (int i = 0; i < 3; i++)
+        {
+            normal[i][index] = float(n[i]);
+        }
+    }
+
+    if (selection.uv)
+    {
+        uv[0][index] = float(uv_parameter[0]);
+        uv[1][index] = float(uv_parameter[1]);
+    }
+
+    if (selection.object_id)
+    {
+        object_id[index] = scene_object;
+    }
+}
+
+long long ray_cost(const intersection_statistics& statistics)
+{
+    return statistics.clipping_steps + statistics.newton_iterations;
+}
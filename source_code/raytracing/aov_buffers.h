@@ -0,0 +1,49 @@
+#ifndef aov_buffers_h
+#define aov_buffers_h
+
+#include <array>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include <geometry/types/vector.h>
+#include <geometry/algorithms/intersection_statistics.h>
+
+// the channels written besides the colour, see aov_buffers
+struct aov_selection
+{
+	bool depth = false;
+	bool normal = false;
+	bool uv = false;
+	bool object_id = false;
+	bool cost = false;
+};
+
+// one planar buffer per selected channel and component, row by row like the pixels; the buffers of channels, that
+// aren't selected, stay empty, and pixels without hit keep the background values
+struct aov_buffers
+{
+	aov_buffers(int width, int height, const aov_selection& selection);
+
+	// index is width * y + x; intersection as returned by get_ray_surface_intersection, steps as counted by ray_cost
+	void store(int index, const std::optional<std::tuple<int, v3, v3, v2>>& intersection, long long steps);
+
+	int width;
+	int height;
+	aov_selection selection;
+
+	// distance from the origin of the camera ray to the hit, infinity in the background
+	std::vector<float> depth;
+	// unit normal of the surface at the hit, facing as the tracers compute it
+	std::array<std::vector<float>, 3> normal;
+	std::array<std::vector<float>, 2> uv;
+	// index of the surface in the scene, -1 in the background
+	std::vector<int> object_id;
+	// clipping steps and newton iterations spent on the ray, including the surfaces it missed
+	std::vector<int> cost;
+};
+
+// the work counted so far for the calling thread, the difference before and after tracing a ray is its cost
+long long ray_cost(const intersection_statistics& statistics);
+
+#endif
@@ -0,0 +1,170 @@
+#include "hardware_counters.h"
+
+#ifdef __linux__
+#include <cstdint>
+#include <cstring>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    void write_per_ray(std::ostream& os, const char* name, const std::optional<long long>& value, double rays)
+    {
+        os << name << " per ray: ";
+
+        if (value.has_value() && 0 < rays)
+        {
+            os << *value / rays;
+        }
+        else
+        {
+            os << "n/a";
+        }
+    }
+
+#ifdef __linux__
+    int open_counter(std::uint64_t config)
+    {
+        perf_event_attr attributes;
+        std::memset(&attributes, 0, sizeof(attributes));
+
+        attributes.size = sizeof(attributes);
+        attributes.type = PERF_TYPE_HARDWARE;
+        attributes.config = config;
+        attributes.disabled = 1;
+        // the render threads are started after the counters are opened
+        attributes.inherit = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        return int(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+    }
+
+    // value, time enabled and time running
+    bool read_counter(int descriptor, std::array<unsigned long long, 3>& values)
+    {
+        std::uint64_t buffer[3];
+
+        if (descriptor < 0 || read(descriptor, buffer, sizeof(buffer)) != sizeof(buffer))
+        {
+            return false;
+        }
+
+        values = { buffer[0], buffer[1], buffer[2] };
+
+        return true;
+    }
+#endif
+}
+
+void write_per_ray(std::ostream& os, const hardware_counter_values& values, double rays)
+{
+    write_per_ray(os, "cycles", values.cycles, rays);
+    os << ", ";
+    write_per_ray(os, "instructions", values.instructions, rays);
+    os << ", ";
+    write_per_ray(os, "cache misses", values.cache_misses, rays);
+    os << ", ";
+    write_per_ray(os, "branch misses", values.branch_misses, rays);
+}
+
+hardware_counters::hardware_counters()
+{
+    descriptors.fill(-1);
+
+#ifdef __linux__
+    const std::uint64_t events[] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES };
+
+    for (int i = 0; i < 4; i++)
+    {
+        descriptors[i] = open_counter(events[i]);
+    }
+#endif
+}
+
+hardware_counters::~hardware_counters()
+{
+#ifdef __linux__
+    for (int descriptor : descriptors)
+    {
+        if (0 <= descriptor)
+        {
+            close(descriptor);
+        }
+    }
+#endif
+}
+
+bool hardware_counters::is_available() const
+{
+    for (int descriptor : descriptors)
+    {
+        if (0 <= descriptor)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void hardware_counters::start()
+{
+#ifdef __linux__
+    for (int i = 0; i < 4; i++)
+    {
+        if (read_counter(descriptors[i], start_values[i]))
+        {
+            ioctl(descriptors[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+hardware_counter_values hardware_counters::stop()
+{
+    hardware_counter_values values;
+
+#ifdef __linux__
+    for (int descriptor : descriptors)
+    {
+        if (0 <= descriptor)
+        {
+            ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+
+    std::optional<long long> counts[4];
+
+    for (int i = 0; i < 4; i++)
+    {
+        std::array<unsigned long long, 3> end_values;
+
+        if (!read_counter(descriptors[i], end_values))
+        {
+            continue;
+        }
+
+        double value = double(end_values[0] - start_values[i][0]);
+        double enabled = double(end_values[1] - start_values[i][1]);
+        double running = double(end_values[2] - start_values[i][2]);
+
+        if (0 < running)
+        {
+            counts[i] = (long long)(value * enabled / running);
+        }
+    }
+
+    values.cycles = counts[0];
+    values.instructions = counts[1];
+    values.cache_misses = counts[2];
+    values.branch_misses = counts[3];
+#endif
+
+    return values;
+}
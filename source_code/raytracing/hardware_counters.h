@@ -0,0 +1,47 @@
+#ifndef hardware_counters_h
+#define hardware_counters_h
+
+#include <array>
+#include <optional>
+#include <ostream>
+
+// counts of the hardware events of a measurement, empty for the events the kernel didn't grant
+struct hardware_counter_values
+{
+    std::optional<long long> cycles;
+    std::optional<long long> instructions;
+    std::optional<long long> cache_misses;
+    std::optional<long long> branch_misses;
+};
+
+// the counts divided by rays, e.g. "cycles per ray: 5210.3, ..., branch misses per ray: n/a"
+void write_per_ray(std::ostream& os, const hardware_counter_values& values, double rays);
+
+// cycles, instructions, cache misses and branch misses of the user space of the calling thread and of the threads it
+// starts while counting, through perf_event_open; read the values after the render threads were joined. Linux only,
+// elsewhere or with perf_event_paranoid above 2 or in containers without the capability the counters are unavailable
+class hardware_counters
+{
+public:
+    hardware_counters();
+    ~hardware_counters();
+
+    hardware_counters(const hardware_counters&) = delete;
+    hardware_counters& operator=(const hardware_counters&) = delete;
+
+    // at least one counter was granted
+    bool is_available() const;
+
+    // enables the counters
+    void start();
+    // disables the counters, the events since start, scaled up, if the kernel multiplexed the counters
+    hardware_counter_values stop();
+
+private:
+    std::array<int, 4> descriptors;
+    // value, time enabled and time running of each counter at start; resetting wouldn't clear the counts, that the
+    // threads of an earlier measurement passed on to the counter, when they ended
+    std::array<std::array<unsigned long long, 3>, 4> start_values{};
+};
+
+#endif
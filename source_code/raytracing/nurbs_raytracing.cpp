@@ -9,6 +9,15 @@ std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_with_fac
     return raytrace_scene_multithreaded<facetted_surface_scene_descriptor>(scene, trace_ray_with_facetted_surface, threadcount);
 }
 
+std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_with_tessellated_surfaces_multithreaded(tessellated_scene_descriptor& scene, int threadcount)
+{
+    auto trace_ray_with_tessellated_surfaces = [](std::vector<int>::iterator pixel, v3 ray, tessellated_scene_descriptor& scene) {
+        trace_ray(pixel, ray, scene);
+    };
+
+    return raytrace_scene_multithreaded<tessellated_scene_descriptor>(scene, trace_ray_with_tessellated_surfaces, threadcount);
+}
+
 std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_with_meshes_hierarchy_multithreaded(varmesh_scene_descriptor& scene, int threadcount)
 {
     subdivided_mesh_scene_descriptor subdivided_scene(scene);
@@ -21,20 +30,248 @@ std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_with_mes
 }
 
 std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_through_quasi_interpolation_multithreaded(varmesh_scene_descriptor& scene, int threadcount)
+{
+    intersection_statistics statistics;
+
+    return raytrace_scene_through_quasi_interpolation_multithreaded(scene, threadcount, statistics);
+}
+
+std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_through_quasi_interpolation_multithreaded(varmesh_scene_descriptor& scene, int threadcount, intersection_statistics& statistics)
 {
     auto trace_ray_through_quasi_interpolation = [](std::vector<int>::iterator pixel, v3 ray, varmesh_scene_descriptor& scene) {
         trace_ray(pixel, ray, scene);
     };
 
-    return raytrace_scene_multithreaded<varmesh_scene_descriptor>(scene, trace_ray_through_quasi_interpolation, threadcount);
+    return raytrace_scene_multithreaded<varmesh_scene_descriptor>(scene, trace_ray_through_quasi_interpolation, threadcount, statistics);
 }
 
 std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_through_quasi_interpolation_multithreaded(multiple_surfaces_scene_descriptor& scene, int threadcount)
+{
+    intersection_statistics statistics;
+
+    return raytrace_scene_through_quasi_interpolation_multithreaded(scene, threadcount, statistics);
+}
+
+std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_through_quasi_interpolation_multithreaded(multiple_surfaces_scene_descriptor& scene, int threadcount, intersection_statistics& statistics)
 {
     auto trace_ray_through_quasi_interpolation = [](std::vector<int>::iterator pixel, v3 ray, multiple_surfaces_scene_descriptor& scene) {
         trace_ray(pixel, ray, scene);
     };
 
-    return raytrace_scene_multithreaded<multiple_surfaces_scene_descriptor>(scene, trace_ray_through_quasi_interpolation, threadcount);
+    return raytrace_scene_multithreaded<multiple_surfaces_scene_descriptor>(scene, trace_ray_through_quasi_interpolation, threadcount, statistics);
+}
+
+std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_through_quasi_interpolation_multithreaded(multiple_surfaces_scene_descriptor& scene, int threadcount, intersection_statistics& statistics, aov_buffers& aovs)
+{
+    std::vector<int> pixel(scene.screen_width * scene.screen_height * 3, 0);
+
+    synciterator iter(scene.screen_width, scene.screen_height);
+
+    trace_multithreaded(threadcount, statistics, [&] { raytrace_scene(pixel, iter, scene, aovs); });
+
+    return std::make_tuple(pixel, scene.screen_width, scene.screen_height);
+}
+
+std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_through_quasi_interpolation_multithreaded(bounded_surfaces_scene_descriptor& scene, int threadcount, intersection_statistics& statistics)
+{
+    auto trace_ray_within_bounds = [](std::vector<int>::iterator pixel, v3 ray, bounded_surfaces_scene_descriptor& scene) {
+        trace_ray(pixel, ray, scene);
+    };
+
+    return raytrace_scene_multithreaded<bounded_surfaces_scene_descriptor>(scene, trace_ray_within_bounds, threadcount, statistics);
+}
+
+std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_through_quasi_interpolation_multithreaded(accelerated_surfaces_scene_descriptor& scene, int threadcount)
+{
+    auto trace_ray_through_quasi_interpolation = [](std::vector<int>::iterator pixel, v3 ray, accelerated_surfaces_scene_descriptor& scene) {
+        trace_ray(pixel, ray, scene);
+    };
+
+    return raytrace_scene_multithreaded<accelerated_surfaces_scene_descriptor>(scene, trace_ray_through_quasi_interpolation, threadcount);
+}
+
+std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_through_quasi_interpolation_multithreaded(hybrid_surfaces_scene_descriptor& scene, int threadcount, intersection_statistics& statistics)
+{
+    auto trace_ray_seeded_by_triangles = [](std::vector<int>::iterator pixel, v3 ray, hybrid_surfaces_scene_descriptor& scene) {
+        trace_ray(pixel, ray, scene);
+    };
+
+    return raytrace_scene_multithreaded<hybrid_surfaces_scene_descriptor>(scene, trace_ray_seeded_by_triangles, threadcount, statistics);
+}
+
+namespace
+{
+    std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_binned_scene_multithreaded(binned_surfaces_scene_descriptor& scene, int threadcount, intersection_statistics& statistics, aov_buffers* aovs)
+    {
+        std::vector<int> pixel(scene.screen_width * scene.screen_height * 3, 0);
+
+        synciterator tile_iterator(1, int(scene.tiles.size()));
+
+        trace_multithreaded(threadcount, statistics, [&] { raytrace_binned_scene(pixel, tile_iterator, scene, aovs); });
+
+        return std::make_tuple(pixel, scene.screen_width, scene.screen_height);
+    }
+}
+
+std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_through_quasi_interpolation_multithreaded(binned_surfaces_scene_descriptor& scene, int threadcount, intersection_statistics& statistics)
+{
+    return raytrace_binned_scene_multithreaded(scene, threadcount, statistics, nullptr);
+}
+
+std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_through_quasi_interpolation_multithreaded(binned_surfaces_scene_descriptor& scene, int threadcount, intersection_statistics& statistics, aov_buffers& aovs)
+{
+    return raytrace_binned_scene_multithreaded(scene, threadcount, statistics, &aovs);
 }
 
+hdr_image raytrace_scene_hdr_multithreaded(multiple_surfaces_scene_descriptor& scene, int threadcount, intersection_statistics& statistics, aov_buffers* aovs)
+{
+    hdr_image image(scene.screen_width, scene.screen_height);
+
+    synciterator iter(scene.screen_width, scene.screen_height);
+
+    trace_multithreaded(threadcount, statistics, [&] { raytrace_scene(image, iter, scene, aovs); });
+
+    return image;
+}
+
+hdr_image raytrace_scene_hdr_multithreaded(binned_surfaces_scene_descriptor& scene, int threadcount, intersection_statistics& statistics, aov_buffers* aovs)
+{
+    hdr_image image(scene.screen_width, scene.screen_height);
+
+    synciterator tile_iterator(1, int(scene.tiles.size()));
+
+    trace_multithreaded(threadcount, statistics, [&] { raytrace_binned_scene(image, tile_iterator, scene, aovs); });
+
+    return image;
+}
+
+hdr_image raytrace_scene_supersampled_multithreaded(binned_surfaces_scene_descriptor& scene, const supersampling_settings& settings, int threadcount, intersection_statistics& statistics, aov_buffers* aovs)
+{
+    hdr_image image(scene.screen_width, scene.screen_height);
+
+    supersampling_state state(scene);
+
+    {
+        synciterator tile_iterator(1, int(scene.tiles.size()));
+
+        trace_multithreaded(threadcount, statistics, [&] { raytrace_centre_samples(image, state, tile_iterator, scene, aovs); });
+    }
+
+    for (int pass = 1; 0 < mark_pixels_to_refine(image, state, settings, pass); pass++)
+    {
+        synciterator tile_iterator(1, int(scene.tiles.size()));
+
+        trace_multithreaded(threadcount, statistics, [&] { raytrace_refinement_pass(image, state, tile_iterator, scene, settings, pass); });
+    }
+
+    return image;
+}
+
+deadline_render raytrace_scene_until_cancelled_multithreaded(binned_surfaces_scene_descriptor& scene, const supersampling_settings& settings, const cancellation_token& token, int threadcount, intersection_statistics& statistics)
+{
+    deadline_render render(scene.screen_width, scene.screen_height);
+
+    supersampling_state state(scene);
+
+    auto order = tiles_by_distance_to_centre(scene);
+
+    {
+        synciterator tile_iterator(1, int(order.size()));
+
+        trace_multithreaded(threadcount, statistics, [&] {
+            scoped_cancellation_token scope(&token);
+
+            raytrace_centre_samples(render, state, tile_iterator, order, scene, token);
+        });
+    }
+
+    for (int pass = 1; !token.is_cancelled(); pass++)
+    {
+        if (0 == mark_pixels_to_refine(render.image, state, settings, pass))
+        {
+            render.complete = true;
+
+            break;
+        }
+
+        auto tiles = tiles_by_refinement_priority(order, scene, render.image, state, settings);
+
+        synciterator tile_iterator(1, int(tiles.size()));
+
+        render.passes = pass;
+
+        trace_multithreaded(threadcount, statistics, [&] {
+            scoped_cancellation_token scope(&token);
+
+            raytrace_refinement_pass(render.image, state, tile_iterator, tiles, scene, settings, pass, token);
+        });
+    }
+
+    return render;
+}
+
+deadline_render raytrace_scene_until_deadline_multithreaded(binned_surfaces_scene_descriptor& scene, const supersampling_settings& settings, std::chrono::steady_clock::time_point deadline, int threadcount, intersection_statistics& statistics)
+{
+    cancellation_token token(deadline);
+
+    return raytrace_scene_until_cancelled_multithreaded(scene, settings, token, threadcount, statistics);
+}
+
+void raytrace_scene_tiles_multithreaded(std::vector<int>& pixel, const std::vector<screen_tile>& tiles, accelerated_surfaces_scene_descriptor& scene, int threadcount)
+{
+    if (tiles.empty())
+    {
+        return;
+    }
+
+    synciterator tile_iterator(1, int(tiles.size()));
+
+    trace_multithreaded(threadcount, [&] { raytrace_scene_tiles(pixel, tile_iterator, tiles, scene); });
+}
+
+std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_surface_analysis_multithreaded(varmesh_scene_descriptor& scene, const surface_analysis_settings& settings, int threadcount)
+{
+    auto trace_ray_surface_analysis_functional = [&settings](std::vector<int>::iterator pixel, v3 ray, varmesh_scene_descriptor& scene) {
+        trace_ray_surface_analysis(pixel, ray, scene, settings);
+    };
+
+    return raytrace_scene_multithreaded<varmesh_scene_descriptor>(scene, trace_ray_surface_analysis_functional, threadcount);
+}
+
+std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_surface_analysis_multithreaded(multiple_surfaces_scene_descriptor& scene, const surface_analysis_settings& settings, int threadcount)
+{
+    auto trace_ray_surface_analysis_functional = [&settings](std::vector<int>::iterator pixel, v3 ray, multiple_surfaces_scene_descriptor& scene) {
+        trace_ray_surface_analysis(pixel, ray, scene, settings);
+    };
+
+    return raytrace_scene_multithreaded<multiple_surfaces_scene_descriptor>(scene, trace_ray_surface_analysis_functional, threadcount);
+}
+
+std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_recursive_multithreaded(const multiple_surfaces_scene_descriptor& scene, int threadcount, bool coherent)
+{
+    intersection_statistics statistics;
+
+    return raytrace_scene_recursive_multithreaded(scene, threadcount, statistics, coherent);
+}
+
+std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_recursive_multithreaded(const multiple_surfaces_scene_descriptor& scene, int threadcount, intersection_statistics& statistics, bool coherent)
+{
+    std::vector<int> pixel(scene.screen_width * scene.screen_height * 3, 0);
+
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    start = std::chrono::system_clock::now();
+
+    synciterator rows(1, scene.screen_height);
+
+    trace_multithreaded(threadcount, statistics, [&] { raytrace_scene_recursive(pixel, rows, scene, coherent); });
+
+    end = std::chrono::system_clock::now();
+
+    std::chrono::duration<double> elapsed_seconds = end - start;
+    std::time_t end_time = std::chrono::system_clock::to_time_t(end);
+
+    std::cout << "\nfinished computation at " << std::ctime(&end_time)
+        << "elapsed time: " << elapsed_seconds.count() << "s\n";
+
+    return std::make_tuple(pixel, scene.screen_width, scene.screen_height);
+}
@@ -2,14 +2,25 @@
 #define NURBS_RAYTRACING_H_
 
 #include <functional>
+#include <mutex>
 
 #include <geometry/linear_algebra/formulas.h>
+#include <geometry/algorithms/intersection_statistics.h>
 
 #include <graphics/screen_geometry.h>
 
 #include "raytrace_facetted_mesh.h"
 #include "raytrace_mesh_through_quasi_interpolation.h"
 #include "raytrace_subdivided_mesh.h"
+#include "raytrace_recursive.h"
+#include "raytrace_surface_analysis.h"
+#include "raytrace_accelerated_scene.h"
+#include "raytrace_tessellated_scene.h"
+#include "raytrace_hybrid_scene.h"
+#include "raytrace_binned_scene.h"
+#include "raytrace_supersampled_scene.h"
+#include "raytrace_deadline_scene.h"
+#include "render_threads.h"
 
 template<class scene_descriptor_type>
 void raytrace_scene(std::vector<int>& pixel, synciterator& iter, scene_descriptor_type& scene, std::function<void(std::vector<int>::iterator, v3, scene_descriptor_type&)> trace_ray_functional)
@@ -27,10 +38,13 @@ void raytrace_scene(std::vector<int>& pixel, synciterator& iter, scene_descripto
         pixelindex *= 3;
 
         trace_ray_functional(pixel.begin() + pixelindex, ray, scene);
+
+        iter.finish();
     }
 }
 
-template<class scene_descriptor_type> std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_multithreaded(scene_descriptor_type& scene, std::function<void(std::vector<int>::iterator, v3, scene_descriptor_type&)> trace_ray_functional, int threadcount)
+// statistics receives the sum of the counters of all threads
+template<class scene_descriptor_type> std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_multithreaded(scene_descriptor_type& scene, std::function<void(std::vector<int>::iterator, v3, scene_descriptor_type&)> trace_ray_functional, int threadcount, intersection_statistics& statistics)
 {
     std::vector<int> pixel(scene.screen_width * scene.screen_height * 3, 0);
 
@@ -39,16 +53,7 @@ template<class scene_descriptor_type> std::tuple<std::vector<int>, unsigned int,
 
     synciterator iter(scene.screen_width, scene.screen_height);
 
-    std::vector<std::thread> threads;
-    for (int i = 0; i < threadcount; i++)
-    {
-        threads.push_back(std::thread([&] { raytrace_scene(pixel, iter, scene, trace_ray_functional); }));
-    }
-
-    for (int i = 0; i < threads.size(); i++)
-    {
-        threads[i].join();
-    }
+    trace_multithreaded(threadcount, statistics, [&] { raytrace_scene(pixel, iter, scene, trace_ray_functional); });
 
     end = std::chrono::system_clock::now();
 
@@ -62,13 +67,60 @@ template<class scene_descriptor_type> std::tuple<std::vector<int>, unsigned int,
     return std::make_tuple(pixel, scene.screen_width, scene.screen_height);
 }
 
+template<class scene_descriptor_type> std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_multithreaded(scene_descriptor_type& scene, std::function<void(std::vector<int>::iterator, v3, scene_descriptor_type&)> trace_ray_functional, int threadcount)
+{
+    intersection_statistics statistics;
+
+    return raytrace_scene_multithreaded(scene, trace_ray_functional, threadcount, statistics);
+}
+
 std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_through_quasi_interpolation_multithreaded(varmesh_scene_descriptor& scene, int threadcount);
+std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_through_quasi_interpolation_multithreaded(varmesh_scene_descriptor& scene, int threadcount, intersection_statistics& statistics);
 
 std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_with_facetted_surface_multithreaded(facetted_surface_scene_descriptor& scene, int threadcount);
 
+std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_with_tessellated_surfaces_multithreaded(tessellated_scene_descriptor& scene, int threadcount);
+
 std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_with_meshes_hierarchy_multithreaded(varmesh_scene_descriptor& scene, int threadcount);
 
 std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_through_quasi_interpolation_multithreaded(multiple_surfaces_scene_descriptor& scene, int threadcount);
+std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_through_quasi_interpolation_multithreaded(multiple_surfaces_scene_descriptor& scene, int threadcount, intersection_statistics& statistics);
+// aovs receive the selected channels of the camera rays, in the same pass as the colours
+std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_through_quasi_interpolation_multithreaded(multiple_surfaces_scene_descriptor& scene, int threadcount, intersection_statistics& statistics, aov_buffers& aovs);
+
+std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_through_quasi_interpolation_multithreaded(bounded_surfaces_scene_descriptor& scene, int threadcount, intersection_statistics& statistics);
+
+std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_through_quasi_interpolation_multithreaded(binned_surfaces_scene_descriptor& scene, int threadcount, intersection_statistics& statistics);
+std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_through_quasi_interpolation_multithreaded(binned_surfaces_scene_descriptor& scene, int threadcount, intersection_statistics& statistics, aov_buffers& aovs);
+
+// the camera rays as samples of a float image, which tone_map quantizes; aovs, if given, receive the selected channels
+hdr_image raytrace_scene_hdr_multithreaded(multiple_surfaces_scene_descriptor& scene, int threadcount, intersection_statistics& statistics, aov_buffers* aovs = nullptr);
+hdr_image raytrace_scene_hdr_multithreaded(binned_surfaces_scene_descriptor& scene, int threadcount, intersection_statistics& statistics, aov_buffers* aovs = nullptr);
+
+// adaptive supersampling, see supersampling_settings; the weights of the image are the samples per pixel, aovs
+// receive the channels of the centre samples
+hdr_image raytrace_scene_supersampled_multithreaded(binned_surfaces_scene_descriptor& scene, const supersampling_settings& settings, int threadcount, intersection_statistics& statistics, aov_buffers* aovs = nullptr);
+
+// the supersampled render with the tiles closest to the centre of the screen first and the noisiest tiles of each
+// refinement pass first, until the token is cancelled; the clipping loops of the threads poll the token, so the render
+// stops within a few clipping steps and returns the tiles and samples finished so far
+deadline_render raytrace_scene_until_cancelled_multithreaded(binned_surfaces_scene_descriptor& scene, const supersampling_settings& settings, const cancellation_token& token, int threadcount, intersection_statistics& statistics);
+deadline_render raytrace_scene_until_deadline_multithreaded(binned_surfaces_scene_descriptor& scene, const supersampling_settings& settings, std::chrono::steady_clock::time_point deadline, int threadcount, intersection_statistics& statistics);
+
+std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_through_quasi_interpolation_multithreaded(accelerated_surfaces_scene_descriptor& scene, int threadcount);
+
+std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_through_quasi_interpolation_multithreaded(hybrid_surfaces_scene_descriptor& scene, int threadcount, intersection_statistics& statistics);
+
+// traces only the given tiles again, e.g. those returned by update_surface, into an image of the whole screen
+void raytrace_scene_tiles_multithreaded(std::vector<int>& pixel, const std::vector<screen_tile>& tiles, accelerated_surfaces_scene_descriptor& scene, int threadcount);
+
+std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_recursive_multithreaded(const multiple_surfaces_scene_descriptor& scene, int threadcount, bool coherent = true);
+
+std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_recursive_multithreaded(const multiple_surfaces_scene_descriptor& scene, int threadcount, intersection_statistics& statistics, bool coherent = true);
+
+std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_surface_analysis_multithreaded(varmesh_scene_descriptor& scene, const surface_analysis_settings& settings, int threadcount);
+
+std::tuple<std::vector<int>, unsigned int, unsigned int> raytrace_scene_surface_analysis_multithreaded(multiple_surfaces_scene_descriptor& scene, const surface_analysis_settings& settings, int threadcount);
 
 
 #endif /* NURBS_RAYTRACING_H_ */
@@ -0,0 +1,140 @@
+#include <algorithm>
+
+#include "ray_queue.h"
+#include "raytrace_mesh_through_quasi_interpolation.h"
+
+int direction_octant(const v3& direction)
+{
+    return (0 > direction[0] ? 1 : 0) | (0 > direction[1] ? 2 : 0) | (0 > direction[2] ? 4 : 0);
+}
+
+std::uint32_t spread_bits(std::uint32_t x)
+{
+    x &= 0x3ff;
+    x = (x | (x << 16)) & 0x030000ff;
+    x = (x | (x << 8)) & 0x0300f00f;
+    x = (x | (x << 4)) & 0x030c30c3;
+    x = (x | (x << 2)) & 0x09249249;
+
+    return x;
+}
+
+std::uint32_t morton_code(std::uint32_t x, std::uint32_t y, std::uint32_t z)
+{
+    return spread_bits(x) | (spread_bits(y) << 1) | (spread_bits(z) << 2);
+}
+
+void ray_queue::push(const traced_ray& ray)
+{
+    queued_rays.push_back(ray);
+}
+
+bool ray_queue::empty() const
+{
+    return queued_rays.empty();
+}
+
+size_t ray_queue::size() const
+{
+    return queued_rays.size();
+}
+
+void ray_queue::clear()
+{
+    queued_rays.clear();
+}
+
+const std::vector<traced_ray>& ray_queue::rays() const
+{
+    return queued_rays;
+}
+
+std::vector<ray_bin> ray_queue::bin_rays(int cell_bits)
+{
+    std::vector<ray_bin> bins;
+
+    if (queued_rays.empty())
+    {
+        return bins;
+    }
+
+    v3 lower = queued_rays[0].origin;
+    v3 upper = queued_rays[0].origin;
+
+    for (const auto& ray : queued_rays)
+    {
+        for (int k = 0; k < 3; k++)
+        {
+            lower[k] = std::min(lower[k], ray.origin[k]);
+            upper[k] = std::max(upper[k], ray.origin[k]);
+        }
+    }
+
+    std::vector<std::pair<std::uint64_t, size_t>> keys;
+
+    for (size_t i = 0; i < queued_rays.size(); i++)
+    {
+        std::uint32_t quantized[3];
+
+        for (int k = 0; k < 3; k++)
+        {
+            double extent = upper[k] - lower[k];
+            double relative = 0 < extent ? (queued_rays[i].origin[k] - lower[k]) / extent : 0;
+            quantized[k] = std::min<std::uint32_t>(1023, std::uint32_t(relative * 1024));
+        }
+
+        std::uint64_t octant = direction_octant(queued_rays[i].direction);
+
+        keys.push_back(std::make_pair((octant << 30) | morton_code(quantized[0], quantized[1], quantized[2]), i));
+    }
+
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<traced_ray> sorted_rays;
+    sorted_rays.reserve(queued_rays.size());
+
+    int cell_shift = 30 - 3 * cell_bits;
+
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        sorted_rays.push_back(queued_rays[keys[i].second]);
+
+        int octant = int(keys[i].first >> 30);
+        std::uint32_t cell = std::uint32_t(keys[i].first & 0x3fffffff) >> cell_shift;
+
+        if (bins.empty() || bins.back().octant != octant || bins.back().cell != cell)
+        {
+            bins.push_back(ray_bin{ octant, cell, i, i });
+        }
+
+        bins.back().end = i + 1;
+    }
+
+    queued_rays = std::move(sorted_rays);
+
+    return bins;
+}
+
+std::vector<std::optional<std::tuple<int, v3, v3, v2>>> trace_ray_bin(std::vector<traced_ray>::const_iterator begin, std::vector<traced_ray>::const_iterator end, const multiple_surfaces_scene_descriptor& scene)
+{
+    std::vector<closest_intersection> closest(end - begin);
+
+    for (int scene_object_index = 0; scene_object_index < scene.surfaces.size(); scene_object_index++)
+    {
+        const scene_object& object = scene.surfaces[scene_object_index];
+
+        for (auto ray = begin; ray != end; ray++)
+        {
+            update_closest_intersection(ray->origin, ray->direction, object, scene_object_index, scene.epsilon, closest[ray - begin], scene.solver);
+        }
+    }
+
+    std::vector<std::optional<std::tuple<int, v3, v3, v2>>> intersections;
+
+    for (const auto& c : closest)
+    {
+        intersections.push_back(get_ray_surface_intersection(c, scene));
+    }
+
+    return intersections;
+}
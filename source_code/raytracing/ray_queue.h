@@ -0,0 +1,56 @@
+#ifndef ray_queue_h
+#define ray_queue_h
+
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include <raytracing/scene_descriptor.h>
+#include <geometry/types/vector.h>
+
+struct traced_ray
+{
+    v3 origin;
+    v3 direction;
+    int pixel;
+    double weight;
+};
+
+// range [begin, end) of the queued rays sharing direction octant and (coarse) Morton cell of the origin
+struct ray_bin
+{
+    int octant;
+    std::uint32_t cell;
+    size_t begin;
+    size_t end;
+};
+
+int direction_octant(const v3& direction);
+
+// interleaves the lowest 10 bits of the three coordinates, which have to be in [0, 1024)
+std::uint32_t morton_code(std::uint32_t x, std::uint32_t y, std::uint32_t z);
+
+class ray_queue
+{
+public:
+    void push(const traced_ray& ray);
+    bool empty() const;
+    size_t size() const;
+    void clear();
+
+    // sorts the rays by octant and Morton code of the origin (relative to the bounding box of all origins)
+    // and splits them into bins of 2^(3 * cell_bits) Morton cells per octant
+    std::vector<ray_bin> bin_rays(int cell_bits = 1);
+
+    const std::vector<traced_ray>& rays() const;
+
+private:
+    std::vector<traced_ray> queued_rays;
+};
+
+// intersects all rays of [begin, end) with the scene, surface by surface, so that the data of a patch
+// is reused by all rays of the bin
+std::vector<std::optional<std::tuple<int, v3, v3, v2>>> trace_ray_bin(std::vector<traced_ray>::const_iterator begin, std::vector<traced_ray>::const_iterator end, const multiple_surfaces_scene_descriptor& scene);
+
+#endif
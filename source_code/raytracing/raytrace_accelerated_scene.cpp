@@ -0,0 +1,161 @@
+#include <algorithm>
+
+#include "raytrace_accelerated_scene.h"
+#include "raytrace_mesh_through_quasi_interpolation.h"
+
+#include <geometry/algorithms/render_trace.h>
+
+std::optional<std::tuple<int, int, int, int>> screen_bounds_of_mesh(const scene_descriptor& scene, const varmesh<4>& m)
+{
+    screen_geometry screen(scene.screen_width, scene.screen_height, scene.field_of_view, 0, 0, 0);
+
+    int x0 = std::numeric_limits<int>::max();
+    int y0 = std::numeric_limits<int>::max();
+    int x1 = std::numeric_limits<int>::min();
+    int y1 = std::numeric_limits<int>::min();
+
+    for (int i = 0; i < m.row_size(); i++)
+    {
+        for (int j = 0; j < m.col_size(); j++)
+        {
+            v3 ray = remove_dimension(m.element(i, j)) - scene.origin;
+
+            if (0 >= ray[2])
+            {
+                return {};
+            }
+
+            auto [x, y] = screen.get_corresponding_screen_pixel(ray);
+
+            x0 = std::min(x0, x);
+            y0 = std::min(y0, y);
+            x1 = std::max(x1, x);
+            y1 = std::max(y1, y);
+        }
+    }
+
+    // the pixel positions are rounded
+    return std::make_tuple(x0 - 1, y0 - 1, x1 + 1, y1 + 1);
+}
+
+std::vector<screen_tile> update_surface(accelerated_surfaces_scene_descriptor& scene, int scene_object_index, const varmesh<4>& mesh, int tile_size)
+{
+    std::vector<std::optional<std::tuple<int, int, int, int>>> affected_bounds;
+
+    affected_bounds.push_back(screen_bounds_of_mesh(scene, scene.surfaces[scene_object_index].mesh));
+    affected_bounds.push_back(screen_bounds_of_mesh(scene, mesh));
+
+    const varmesh<4>& old_mesh = scene.surfaces[scene_object_index].mesh;
+
+    if (old_mesh.row_size() == mesh.row_size() && old_mesh.col_size() == mesh.col_size())
+    {
+        scene.patch_hierarchies[scene_object_index].refit(mesh);
+    }
+    else
+    {
+        scene.patch_hierarchies[scene_object_index] = bezier_patch_bvh(mesh, accelerated_surfaces_scene_descriptor::patch_hierarchy_depth);
+    }
+
+    scene.surfaces[scene_object_index].mesh = mesh;
+    scene.hierarchy.refit(scene_object_index, scene.patch_hierarchies[scene_object_index].bounds());
+
+    if (0 < scene.max_depth)
+    {
+        for (const auto& surface : scene.surfaces)
+        {
+            if (0 < surface.reflectivity || 0 < surface.transparency)
+            {
+                affected_bounds.push_back(screen_bounds_of_mesh(scene, surface.mesh));
+            }
+        }
+    }
+
+    int x0 = std::numeric_limits<int>::max();
+    int y0 = std::numeric_limits<int>::max();
+    int x1 = std::numeric_limits<int>::min();
+    int y1 = std::numeric_limits<int>::min();
+
+    for (const auto& bounds : affected_bounds)
+    {
+        if (!bounds.has_value())
+        {
+            return screen_tiles_overlapping(scene.screen_width, scene.screen_height, tile_size, 0, 0, scene.screen_width - 1, scene.screen_height - 1);
+        }
+
+        auto [bx0, by0, bx1, by1] = *bounds;
+
+        x0 = std::min(x0, bx0);
+        y0 = std::min(y0, by0);
+        x1 = std::max(x1, bx1);
+        y1 = std::max(y1, by1);
+    }
+
+    return screen_tiles_overlapping(scene.screen_width, scene.screen_height, tile_size, x0, y0, x1, y1);
+}
+
+std::optional<std::tuple<int, v3, v3, v2>> get_ray_surface_intersection(v3 ray, accelerated_surfaces_scene_descriptor& scene, double epsilon)
+{
+    return get_ray_surface_intersection(scene.origin, ray, scene, epsilon);
+}
+
+std::optional<std::tuple<int, v3, v3, v2>> get_ray_surface_intersection(v3 origin, v3 ray, accelerated_surfaces_scene_descriptor& scene, double epsilon)
+{
+    closest_intersection closest;
+
+    double ray_length2 = length2(ray);
+
+    // reused by the rays of the thread
+    thread_local std::vector<std::pair<double, int>> candidates, stack;
+    thread_local std::vector<v2> projection_coordinates;
+
+    scene.hierarchy.intersected_surfaces(origin, ray, candidates, stack);
+
+    for (auto [entry, scene_object_index] : candidates)
+    {
+        // the surfaces are sorted by entry into their bounds, no further surface can be closer
+        if (0 <= closest.scene_object && closest.distance2 < entry * entry * ray_length2)
+        {
+            break;
+        }
+
+        if (!scene.patch_hierarchies[scene_object_index].intersects_leaf(origin, ray, projection_coordinates))
+        {
+            continue;
+        }
+
+        update_closest_intersection(origin, ray, scene.surfaces[scene_object_index], scene_object_index, epsilon, closest, scene.solver);
+    }
+
+    return get_ray_surface_intersection(closest, scene);
+}
+
+void trace_ray(std::vector<int>::iterator pixel, v3 ray, accelerated_surfaces_scene_descriptor& scene)
+{
+    shade_pixel(pixel, get_ray_surface_intersection(ray, scene, scene.epsilon), scene);
+}
+
+void raytrace_scene_tiles(std::vector<int>& pixel, synciterator& tile_iterator, const std::vector<screen_tile>& tiles, accelerated_surfaces_scene_descriptor& scene)
+{
+    screen_geometry screen(scene.screen_width, scene.screen_height, scene.field_of_view, 0, 0, 0);
+
+    std::pair<int, int> xy;
+
+    while ((xy = tile_iterator.next()) != std::make_pair(-1, -1))
+    {
+        const screen_tile& tile = tiles[xy.second];
+
+        RENDER_TRACE_SPAN("tile");
+
+        for (int y = tile.y_begin; y < tile.y_end; y++)
+        {
+            for (int x = tile.x_begin; x < tile.x_end; x++)
+            {
+                int pixelindex = 3 * (scene.screen_width * y + x);
+
+                std::fill(pixel.begin() + pixelindex, pixel.begin() + pixelindex + 3, 0);
+
+                trace_ray(pixel.begin() + pixelindex, normalize(screen.get_corresponding_ray(x, y)), scene);
+            }
+        }
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef raytrace_accelerated_scene_h
+#define raytrace_accelerated_scene_h
+
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include <raytracing/scene_descriptor.h>
+#include <raytracing/synciterator.h>
+#include <graphics/screen_geometry.h>
+#include <geometry/types/vector.h>
+#include <geometry/types/varmesh.h>
+
+// pixel bounds (x0, y0, x1, y1) of the projected control points, empty if a control point is not in front of the camera
+std::optional<std::tuple<int, int, int, int>> screen_bounds_of_mesh(const scene_descriptor& scene, const varmesh<4>& m);
+
+// replaces the mesh of a scene object in place and refits the patch tree and the path to the root of the surface tree;
+// returns the tiles, whose rays could be affected: those covering the screen bounds of the old and the new control points
+// and, if secondary rays are traced, of all reflective and transparent surfaces
+std::vector<screen_tile> update_surface(accelerated_surfaces_scene_descriptor& scene, int scene_object_index, const varmesh<4>& mesh, int tile_size = 32);
+
+std::optional<std::tuple<int, v3, v3, v2>> get_ray_surface_intersection(v3 ray, accelerated_surfaces_scene_descriptor& scene, double epsilon);
+std::optional<std::tuple<int, v3, v3, v2>> get_ray_surface_intersection(v3 origin, v3 ray, accelerated_surfaces_scene_descriptor& scene, double epsilon);
+
+void trace_ray(std::vector<int>::iterator pixel, v3 ray, accelerated_surfaces_scene_descriptor& scene);
+
+// each element of tile_iterator indexes a tile, whose pixels are cleared and traced again
+void raytrace_scene_tiles(std::vector<int>& pixel, synciterator& tile_iterator, const std::vector<screen_tile>& tiles, accelerated_surfaces_scene_descriptor& scene);
+
+#endif
@@ -0,0 +1,145 @@
+#include <algorithm>
+
+#include "raytrace_binned_scene.h"
+#include "raytrace_accelerated_scene.h"
+#include "raytrace_mesh_through_quasi_interpolation.h"
+
+#include <geometry/algorithms/render_trace.h>
+
+binned_surfaces_scene_descriptor bin_surfaces_to_tiles(const multiple_surfaces_scene_descriptor& scene, int tile_size)
+{
+    binned_surfaces_scene_descriptor result(scene);
+
+    int columns = (scene.screen_width + tile_size - 1) / tile_size;
+
+    result.tiles = screen_tiles_overlapping(scene.screen_width, scene.screen_height, tile_size, 0, 0, scene.screen_width - 1, scene.screen_height - 1);
+    result.tile_surfaces.resize(result.tiles.size());
+
+    for (int surface = 0; surface < scene.surfaces.size(); surface++)
+    {
+        auto bounds = screen_bounds_of_mesh(scene, scene.surfaces[surface].mesh);
+
+        if (!bounds.has_value())
+        {
+            for (auto& surfaces : result.tile_surfaces)
+            {
+                surfaces.push_back(surface);
+            }
+
+            continue;
+        }
+
+        auto [x0, y0, x1, y1] = *bounds;
+
+        for (const auto& tile : screen_tiles_overlapping(scene.screen_width, scene.screen_height, tile_size, x0, y0, x1, y1))
+        {
+            result.tile_surfaces[(tile.y_begin / tile_size) * columns + tile.x_begin / tile_size].push_back(surface);
+        }
+    }
+
+    return result;
+}
+
+std::optional<std::tuple<int, v3, v3, v2>> get_ray_surface_intersection(v3 ray, int tile, binned_surfaces_scene_descriptor& scene, double epsilon)
+{
+    closest_intersection closest;
+
+    for (int scene_object_index : scene.tile_surfaces[tile])
+    {
+        update_closest_intersection(scene.origin, ray, scene.surfaces[scene_object_index], scene_object_index, epsilon, closest, scene.solver);
+    }
+
+    return get_ray_surface_intersection(closest, scene);
+}
+
+void raytrace_binned_scene(std::vector<int>& pixel, synciterator& tile_iterator, binned_surfaces_scene_descriptor& scene, aov_buffers* aovs)
+{
+    screen_geometry screen(scene.screen_width, scene.screen_height, scene.field_of_view, 0, 0, 0);
+
+    std::pair<int, int> xy;
+
+    while ((xy = tile_iterator.next()) != std::make_pair(-1, -1))
+    {
+        int tile_index = xy.second;
+        const screen_tile& tile = scene.tiles[tile_index];
+
+        RENDER_TRACE_SPAN("tile");
+
+        if (scene.tile_surfaces[tile_index].empty())
+        {
+            tile_iterator.finish();
+            continue;
+        }
+
+        for (int y = tile.y_begin; y < tile.y_end; y++)
+        {
+            for (int x = tile.x_begin; x < tile.x_end; x++)
+            {
+                int pixelindex = 3 * (scene.screen_width * y + x);
+
+                auto ray = normalize(screen.get_corresponding_ray(x, y));
+
+                if (nullptr == aovs)
+                {
+                    shade_pixel(pixel.begin() + pixelindex, get_ray_surface_intersection(ray, tile_index, scene, scene.epsilon), scene);
+                    continue;
+                }
+
+                long long cost = ray_cost(thread_intersection_statistics());
+
+                auto intersection = get_ray_surface_intersection(ray, tile_index, scene, scene.epsilon);
+
+                shade_pixel(pixel.begin() + pixelindex, intersection, scene);
+
+                aovs->store(scene.screen_width * y + x, intersection, ray_cost(thread_intersection_statistics()) - cost);
+            }
+        }
+
+        tile_iterator.finish();
+    }
+}
+
+void raytrace_binned_scene(hdr_image& image, synciterator& tile_iterator, binned_surfaces_scene_descriptor& scene, aov_buffers* aovs)
+{
+    screen_geometry screen(scene.screen_width, scene.screen_height, scene.field_of_view, 0, 0, 0);
+
+    std::pair<int, int> xy;
+
+    while ((xy = tile_iterator.next()) != std::make_pair(-1, -1))
+    {
+        int tile_index = xy.second;
+        const screen_tile& tile = scene.tiles[tile_index];
+
+        RENDER_TRACE_SPAN("tile");
+
+        // the pixels of empty tiles stay without samples, which resolve to black
+        if (scene.tile_surfaces[tile_index].empty())
+        {
+            tile_iterator.finish();
+            continue;
+        }
+
+        for (int y = tile.y_begin; y < tile.y_end; y++)
+        {
+            for (int x = tile.x_begin; x < tile.x_end; x++)
+            {
+                int index = scene.screen_width * y + x;
+
+                auto ray = normalize(screen.get_corresponding_ray(x, y));
+
+                long long cost = ray_cost(thread_intersection_statistics());
+
+                auto intersection = get_ray_surface_intersection(ray, tile_index, scene, scene.epsilon);
+
+                shade_pixel(image, index, intersection, scene);
+
+                if (nullptr != aovs)
+                {
+                    aovs->store(index, intersection, ray_cost(thread_intersection_statistics()) - cost);
+                }
+            }
+        }
+
+        tile_iterator.finish();
+    }
+}
@@ -0,0 +1,26 @@
+#ifndef raytrace_binned_scene_h
+#define raytrace_binned_scene_h
+
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include <raytracing/scene_descriptor.h>
+#include <raytracing/synciterator.h>
+#include <raytracing/aov_buffers.h>
+#include <graphics/hdr_image.h>
+#include <geometry/types/vector.h>
+
+// a surface goes to all tiles overlapping the screen bounds of its control points, or to every tile, if a control
+// point isn't in front of the camera
+binned_surfaces_scene_descriptor bin_surfaces_to_tiles(const multiple_surfaces_scene_descriptor& scene, int tile_size = 16);
+
+// only the surfaces of the tile, in their order in the scene, so the closest hit is the same as without binning
+std::optional<std::tuple<int, v3, v3, v2>> get_ray_surface_intersection(v3 ray, int tile, binned_surfaces_scene_descriptor& scene, double epsilon);
+
+// each element of tile_iterator indexes a tile of the scene, whose camera rays are traced; aovs, if given, receive the
+// selected channels of each ray
+void raytrace_binned_scene(std::vector<int>& pixel, synciterator& tile_iterator, binned_surfaces_scene_descriptor& scene, aov_buffers* aovs = nullptr);
+void raytrace_binned_scene(hdr_image& image, synciterator& tile_iterator, binned_surfaces_scene_descriptor& scene, aov_buffers* aovs = nullptr);
+
+#endif
@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <cmath>
+
+#include "raytrace_deadline_scene.h"
+
+#include <geometry/algorithms/render_trace.h>
+
+namespace
+{
+    // what a refinement pass changes of a pixel
+    struct pixel_samples
+    {
+        float channels[3];
+        float weight;
+        double luminance_sum;
+        double luminance_square_sum;
+    };
+
+    pixel_samples samples_of_pixel(const hdr_image& image, const supersampling_state& state, int index)
+    {
+        return pixel_samples{ { image.channels[0][index], image.channels[1][index], image.channels[2][index] }, image.weights[index], state.luminance_sum[index], state.luminance_square_sum[index] };
+    }
+
+    void restore_pixel(hdr_image& image, supersampling_state& state, int index, const pixel_samples& samples)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            image.channels[c][index] = samples.channels[c];
+        }
+
+        image.weights[index] = samples.weight;
+        state.luminance_sum[index] = samples.luminance_sum;
+        state.luminance_square_sum[index] = samples.luminance_square_sum;
+    }
+}
+
+deadline_render::deadline_render(int width, int height) : image(width, height), coverage(size_t(width) * height, 0)
+{
+}
+
+std::vector<int> tiles_by_distance_to_centre(const binned_surfaces_scene_descriptor& scene)
+{
+    std::vector<std::pair<double, int>> distances;
+
+    for (int i = 0; i < int(scene.tiles.size()); i++)
+    {
+        const screen_tile& tile = scene.tiles[i];
+
+        double dx = 0.5 * (tile.x_begin + tile.x_end - scene.screen_width);
+        double dy = 0.5 * (tile.y_begin + tile.y_end - scene.screen_height);
+
+        distances.push_back({ dx * dx + dy * dy, i });
+    }
+
+    std::sort(distances.begin(), distances.end());
+
+    std::vector<int> order;
+
+    for (const auto& distance : distances)
+    {
+        order.push_back(distance.second);
+    }
+
+    return order;
+}
+
+std::vector<int> tiles_by_refinement_priority(const std::vector<int>& order, const binned_surfaces_scene_descriptor& scene, const hdr_image& image, const supersampling_state& state, const supersampling_settings& settings)
+{
+    std::vector<std::pair<double, int>> priorities;
+
+    for (int tile_index : order)
+    {
+        const screen_tile& tile = scene.tiles[tile_index];
+
+        double priority = 0;
+
+        for (int y = tile.y_begin; y < tile.y_end; y++)
+        {
+            for (int x = tile.x_begin; x < tile.x_end; x++)
+            {
+                int index = scene.screen_width * y + x;
+
+                if (!state.refine[index])
+                {
+                    continue;
+                }
+
+                // a marked pixel counts at least once, after the first pass as often as its noise exceeds the threshold
+                double n = image.weights[index];
+                double mean = state.luminance_sum[index] / n;
+                double variance = std::max(state.luminance_square_sum[index] / n - mean * mean, 0.);
+
+                priority += 0 < settings.noise_threshold ? std::max(1., std::sqrt(variance) / settings.noise_threshold) : 1;
+            }
+        }
+
+        if (0 < priority)
+        {
+            priorities.push_back({ priority, tile_index });
+        }
+    }
+
+    std::stable_sort(priorities.begin(), priorities.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    std::vector<int> tiles;
+
+    for (const auto& priority : priorities)
+    {
+        tiles.push_back(priority.second);
+    }
+
+    return tiles;
+}
+
+void raytrace_centre_samples(deadline_render& render, supersampling_state& state, synciterator& tile_iterator, const std::vector<int>& order, binned_surfaces_scene_descriptor& scene, const cancellation_token& token)
+{
+    screen_geometry screen(scene.screen_width, scene.screen_height, scene.field_of_view, 0, 0, 0);
+
+    std::pair<int, int> xy;
+
+    while (!token.is_cancelled() && (xy = tile_iterator.next()) != std::make_pair(-1, -1))
+    {
+        int tile_index = order[xy.second];
+        const screen_tile& tile = scene.tiles[tile_index];
+
+        RENDER_TRACE_SPAN("tile");
+
+        bool cancelled = false;
+
+        for (int y = tile.y_begin; y < tile.y_end && !cancelled; y++)
+        {
+            for (int x = tile.x_begin; x < tile.x_end; x++)
+            {
+                raytrace_centre_sample(x, y, tile_index, screen, render.image, state, scene);
+            }
+
+            // the clipping loops may have given up on the intersections of the row
+            cancelled = token.is_cancelled();
+        }
+
+        for (int y = tile.y_begin; y < tile.y_end; y++)
+        {
+            for (int x = tile.x_begin; x < tile.x_end; x++)
+            {
+                int index = scene.screen_width * y + x;
+
+                if (cancelled)
+                {
+                    restore_pixel(render.image, state, index, pixel_samples{});
+                    state.centre_surface[index] = -1;
+                    state.centre_luminance[index] = 0;
+                }
+                else
+                {
+                    render.coverage[index] = 1;
+                }
+            }
+        }
+    }
+}
+
+void raytrace_refinement_pass(hdr_image& image, supersampling_state& state, synciterator& tile_iterator, const std::vector<int>& order, binned_surfaces_scene_descriptor& scene, const supersampling_settings& settings, int pass, const cancellation_token& token)
+{
+    screen_geometry screen(scene.screen_width, scene.screen_height, scene.field_of_view, 0, 0, 0);
+
+    std::vector<int> hints;
+
+    std::pair<int, int> xy;
+
+    while (!token.is_cancelled() && (xy = tile_iterator.next()) != std::make_pair(-1, -1))
+    {
+        int tile_index = order[xy.second];
+        const screen_tile& tile = scene.tiles[tile_index];
+
+        RENDER_TRACE_SPAN("refinement tile");
+
+        for (int y = tile.y_begin; y < tile.y_end; y++)
+        {
+            for (int x = tile.x_begin; x < tile.x_end; x++)
+            {
+                int index = scene.screen_width * y + x;
+
+                if (!state.refine[index])
+                {
+                    continue;
+                }
+
+                auto samples = samples_of_pixel(image, state, index);
+
+                raytrace_refinement_samples(x, y, tile_index, screen, image, state, scene, settings, pass, hints);
+
+                if (token.is_cancelled())
+                {
+                    restore_pixel(image, state, index, samples);
+
+                    return;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef raytrace_deadline_scene_h
+#define raytrace_deadline_scene_h
+
+#include <vector>
+
+#include <raytracing/raytrace_supersampled_scene.h>
+#include <geometry/algorithms/cancellation.h>
+
+// the image of a supersampled render, which may have been stopped before all tiles were traced
+struct deadline_render
+{
+	deadline_render(int width, int height);
+
+	hdr_image image;
+	// per pixel 1, if its tile got its centre samples before the render was stopped, else 0
+	std::vector<unsigned char> coverage;
+	// refinement passes, that were started
+	int passes = 0;
+	// all tiles and all refinement passes were traced
+	bool complete = false;
+};
+
+// indices of the tiles of the scene, the tiles closest to the centre of the screen first
+std::vector<int> tiles_by_distance_to_centre(const binned_surfaces_scene_descriptor& scene);
+
+// the tiles of order with pixels marked for refinement, those with the most and noisiest marked pixels first;
+// tiles of the same priority keep their order
+std::vector<int> tiles_by_refinement_priority(const std::vector<int>& order, const binned_surfaces_scene_descriptor& scene, const hdr_image& image, const supersampling_state& state, const supersampling_settings& settings);
+
+// the centre samples of the tiles order[i] for the i of tile_iterator, until the token is cancelled; the pixels of a
+// tile, that was cancelled while it was traced, are reset and stay uncovered
+void raytrace_centre_samples(deadline_render& render, supersampling_state& state, synciterator& tile_iterator, const std::vector<int>& order, binned_surfaces_scene_descriptor& scene, const cancellation_token& token);
+
+// like raytrace_refinement_pass for the tiles order[i]; a pixel, that was cancelled while it was refined, keeps only
+// the samples of the earlier passes
+void raytrace_refinement_pass(hdr_image& image, supersampling_state& state, synciterator& tile_iterator, const std::vector<int>& order, binned_surfaces_scene_descriptor& scene, const supersampling_settings& settings, int pass, const cancellation_token& token);
+
+#endif
@@ -5,7 +5,7 @@
 
 #include "raytrace_facetted_mesh.h"
 
-void trace_ray_facetted_surface(std::vector<int>::iterator pixel, v3 ray, facetted_surface_scene_descriptor scene)
+void trace_ray_facetted_surface(std::vector<int>::iterator pixel, v3 ray, const facetted_surface_scene_descriptor& scene)
 {
     matrix<4, 4> rotation = rotation_in_e2(std::numbers::pi * -51. / 180.) * rotation_in_e3(std::numbers::pi * 5. / 180.) * rotation_in_e1(std::numbers::pi * 21. / 180.);
     v3 ray_rotated = remove_dimension(rotation * add_dimension(ray));
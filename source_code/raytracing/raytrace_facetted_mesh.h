@@ -16,6 +16,6 @@
 #include <raytracing/synciterator.h>
 #include <graphics/graphics_formulas.h>
 
-void trace_ray_facetted_surface(std::vector<int>::iterator pixel, v3 ray, facetted_surface_scene_descriptor scene);
+void trace_ray_facetted_surface(std::vector<int>::iterator pixel, v3 ray, const facetted_surface_scene_descriptor& scene);
 
 #endif
\ No newline at end of file
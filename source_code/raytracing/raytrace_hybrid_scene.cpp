@@ -0,0 +1,77 @@
+#include "raytrace_hybrid_scene.h"
+
+#include <geometry/algorithms/intersection_statistics.h>
+#include <geometry/algorithms/scratch_arena.h>
+
+void update_closest_intersection_in_leaf(const v3& origin, const v3& ray, int leaf, const hybrid_surfaces_scene_descriptor& scene, double epsilon, varmesh<4>& window, closest_intersection& closest)
+{
+    int surface = scene.leaf_surfaces[leaf];
+    const scene_object& object = scene.surfaces[surface];
+
+    auto [u, v] = scene.leaf_window(leaf);
+
+    window = object.mesh;
+    bezier_clip_surface(window, u, v);
+
+    thread_intersection_statistics().seeded_windows++;
+
+    std::vector<v2> intersections = get_intersections_quasi(origin, ray, window, epsilon, scene.solver);
+
+    for (const auto& root : intersections)
+    {
+        v2 uv{ u[0] + root[0] * (u[1] - u[0]), v[0] + root[1] * (v[1] - v[0]) };
+
+        if (object.trim.is_trimmed() && !object.trim.contains(uv))
+        {
+            continue;
+        }
+
+        v3 distvec = remove_dimension(evaluate_bezier_surface(window, root[0], root[1])) - origin;
+
+        if (0 < distvec * ray)
+        {
+            double this_t = distvec * distvec;
+            if (this_t < closest.distance2)
+            {
+                closest.distance2 = this_t;
+                closest.uv = uv;
+                closest.distance_vector = distvec;
+                closest.scene_object = surface;
+            }
+        }
+    }
+}
+
+std::optional<std::tuple<int, v3, v3, v2>> get_ray_surface_intersection(v3 origin, v3 ray, hybrid_surfaces_scene_descriptor& scene, double epsilon)
+{
+    closest_intersection closest;
+
+    double ray_length2 = length2(ray);
+
+    // reused by the rays of the thread, sorted by entry
+    thread_local std::vector<std::pair<double, int>> candidates, stack;
+
+    scene.hierarchy.intersected_surfaces(origin, ray, candidates, stack);
+
+    // the clipped windows of all leaves share one buffer in the scratch arena of the thread
+    scratch_scope scratch;
+    varmesh<4> window(0, 0, scratch.resource());
+
+    for (auto [entry, leaf] : candidates)
+    {
+        // the window of the leaf is inside its box, so none of its hits is nearer than the entry
+        if (0 <= closest.scene_object && closest.distance2 < entry * entry * ray_length2)
+        {
+            break;
+        }
+
+        update_closest_intersection_in_leaf(origin, ray, leaf, scene, epsilon, window, closest);
+    }
+
+    return get_ray_surface_intersection(closest, scene);
+}
+
+void trace_ray(std::vector<int>::iterator pixel, v3 ray, hybrid_surfaces_scene_descriptor& scene)
+{
+    shade_pixel(pixel, get_ray_surface_intersection(scene.origin, ray, scene, scene.epsilon), scene);
+}
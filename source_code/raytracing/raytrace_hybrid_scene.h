@@ -0,0 +1,22 @@
+#ifndef raytrace_hybrid_scene_h
+#define raytrace_hybrid_scene_h
+
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include <raytracing/scene_descriptor.h>
+#include <raytracing/raytrace_mesh_through_quasi_interpolation.h>
+#include <geometry/types/vector.h>
+
+// solves the surface of the leaf in its widened parameter window with the solver of the scene, the roots are
+// mapped back to the domain of the surface; window is the buffer the surface is clipped in
+void update_closest_intersection_in_leaf(const v3& origin, const v3& ray, int leaf, const hybrid_surfaces_scene_descriptor& scene, double epsilon, varmesh<4>& window, closest_intersection& closest);
+
+// the candidates are the leaves whose padded boxes are hit by the ray, front to back; the leaves entered behind the
+// closest exact hit are skipped; rays missing all boxes miss the scene
+std::optional<std::tuple<int, v3, v3, v2>> get_ray_surface_intersection(v3 origin, v3 ray, hybrid_surfaces_scene_descriptor& scene, double epsilon);
+
+void trace_ray(std::vector<int>::iterator pixel, v3 ray, hybrid_surfaces_scene_descriptor& scene);
+
+#endif
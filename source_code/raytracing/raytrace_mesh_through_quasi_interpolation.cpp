@@ -1,5 +1,8 @@
 #include "raytrace_mesh_through_quasi_interpolation.h"
 
+#include <graphics/screen_geometry.h>
+#include <geometry/algorithms/render_trace.h>
+
 std::pair<v3, v3> evaluate_bezier_surface_derivatives(const varmesh<4> &mesh, double u, double v)
 {
     auto curve_u = bezier_curve_on_surface_u(mesh, v);
@@ -19,7 +22,7 @@ std::pair<v3, v3> evaluate_bezier_surface_derivatives(const varmesh<4> &mesh, do
 
 std::optional<std::tuple<v3, v3, v2>> get_ray_surface_intersection(v3 ray, varmesh_scene_descriptor& scene, double epsilon)
 {
-    std::vector<v2> intersections = get_intersections_quasi(scene.origin, ray, scene.mesh, epsilon);
+    std::vector<v2> intersections = get_intersections_quasi(scene.origin, ray, scene.mesh, epsilon, scene.solver);
 
     if (0 < intersections.size())
     {
@@ -56,51 +59,169 @@ std::optional<std::tuple<v3, v3, v2>> get_ray_surface_intersection(v3 ray, varme
 }
 
 std::optional<std::tuple<int, v3, v3, v2>> get_ray_surface_intersection(v3 ray, multiple_surfaces_scene_descriptor& scene, double epsilon)
-{   
-    double dist2 = std::numeric_limits<double>::max();
-    v2 intersection_uv;
-    int intersection_scene_object = -1;
-    v3 distance_vector;
+{
+    return get_ray_surface_intersection(scene.origin, ray, scene, epsilon);
+}
 
-    for (int scene_object_index = 0; scene_object_index < scene.surfaces.size(); scene_object_index++)
+namespace
+{
+    // trim may be null for untrimmed surfaces
+    void update_closest_trimmed_intersection(const v3& origin, const v3& ray, const varmesh<4>& mesh, const trim_region* trim, int scene_object_index, double epsilon, closest_intersection& closest, intersection_solver solver)
     {
-        std::vector<v2> intersections = get_intersections_quasi(scene.origin, ray, scene.surfaces[scene_object_index].mesh, epsilon);
+        std::vector<v2> intersections = get_intersections_quasi(origin, ray, mesh, epsilon, solver);
 
-        if (0 < intersections.size())
+        for (int i = 0; i < intersections.size(); i++)
         {
-            for (int i = 0; i < intersections.size(); i++)
+            if (trim && !trim->contains(intersections[i]))
             {
-                v3 distvec = remove_dimension(evaluate_bezier_surface(scene.surfaces[scene_object_index].mesh, intersections[i][0], intersections[i][1])) - scene.origin;
-
-                //std::cout << "\nDist vec : " << distvec[0] << ", " << distvec[1] << ", " << distvec[2];
-
-                //auto a = angle(distvec, ray);
+                continue;
+            }
 
-                //std::cout << "\nangle : " << 180 * a / std::numbers::pi;
+            v3 distvec = remove_dimension(evaluate_bezier_surface(mesh, intersections[i][0], intersections[i][1])) - origin;
 
-                if (0 < distvec * ray)
+            if (0 < distvec * ray)
+            {
+                double this_t = distvec * distvec;
+                if (this_t < closest.distance2)
                 {
-                    double this_t = distvec * distvec;
-                    if (this_t < dist2)
-                    {
-                        dist2 = this_t;
-                        intersection_uv = intersections[i];
-                        distance_vector = distvec;
-                        intersection_scene_object = scene_object_index;
-                    }
+                    closest.distance2 = this_t;
+                    closest.uv = intersections[i];
+                    closest.distance_vector = distvec;
+                    closest.scene_object = scene_object_index;
                 }
             }
         }
     }
+}
+
+void update_closest_intersection(const v3& origin, const v3& ray, const varmesh<4>& mesh, int scene_object_index, double epsilon, closest_intersection& closest, intersection_solver solver)
+{
+    update_closest_trimmed_intersection(origin, ray, mesh, nullptr, scene_object_index, epsilon, closest, solver);
+}
 
-    if (intersection_scene_object < 0)
+void update_closest_intersection(const v3& origin, const v3& ray, const scene_object& object, int scene_object_index, double epsilon, closest_intersection& closest, intersection_solver solver)
+{
+    update_closest_trimmed_intersection(origin, ray, object.mesh, object.trim.is_trimmed() ? &object.trim : nullptr, scene_object_index, epsilon, closest, solver);
+}
+
+std::optional<std::tuple<int, v3, v3, v2>> get_ray_surface_intersection(const closest_intersection& closest, const multiple_surfaces_scene_descriptor& scene)
+{
+    if (closest.scene_object < 0)
         return {};
 
-    auto [du, dv] = evaluate_bezier_surface_derivatives(scene.surfaces[intersection_scene_object].mesh, intersection_uv[0], intersection_uv[1]);
+    auto [du, dv] = evaluate_bezier_surface_derivatives(scene.surfaces[closest.scene_object].mesh, closest.uv[0], closest.uv[1]);
 
     auto normale = cross_product((du), (dv));
 
-    return { std::make_tuple(intersection_scene_object, distance_vector, normale, intersection_uv) };
+    return { std::make_tuple(closest.scene_object, closest.distance_vector, normale, closest.uv) };
+}
+
+std::optional<std::tuple<int, v3, v3, v2>> get_ray_surface_intersection(v3 origin, v3 ray, const multiple_surfaces_scene_descriptor& scene, double epsilon)
+{
+    closest_intersection closest;
+
+    for (int scene_object_index = 0; scene_object_index < scene.surfaces.size(); scene_object_index++)
+    {
+        update_closest_intersection(origin, ray, scene.surfaces[scene_object_index], scene_object_index, epsilon, closest, scene.solver);
+    }
+
+    return get_ray_surface_intersection(closest, scene);
+}
+
+std::optional<std::tuple<int, v3, v3, v2>> get_ray_surface_intersection(v3 origin, v3 ray, bounded_surfaces_scene_descriptor& scene, double epsilon)
+{
+    thread_local std::vector<int> candidates;
+    candidates.clear();
+
+    scene.bounds.candidates(origin, ray, candidates);
+
+    closest_intersection closest;
+
+    for (int scene_object_index : candidates)
+    {
+        update_closest_intersection(origin, ray, scene.surfaces[scene_object_index], scene_object_index, epsilon, closest, scene.solver);
+    }
+
+    return get_ray_surface_intersection(closest, scene);
+}
+
+double primary_ray_footprint(const scene_descriptor& scene, const varmesh<4>& mesh, const v3& distance_vector, const v2& uv)
+{
+    screen_geometry screen(scene.screen_width, scene.screen_height, scene.field_of_view, 0, 0, 0);
+
+    v3 ray = normalize(distance_vector);
+
+    auto [x, y] = screen.get_corresponding_screen_pixel(ray);
+    auto [ray_dx, ray_dy] = screen.get_ray_differentials(x, y);
+
+    // derivatives of the rational surface from those of the homogeneous one
+    auto derivatives = evaluate_bezier_surface_with_derivatives(mesh, uv[0], uv[1]);
+
+    double w = derivatives[0][3];
+    v3 p = remove_dimension(derivatives[0]);
+    v3 su = (1 / w) * (remove_last_component(derivatives[1]) - derivatives[1][3] * p);
+    v3 sv = (1 / w) * (remove_last_component(derivatives[2]) - derivatives[2][3] * p);
+
+    v3 n = cross_product(su, sv);
+
+    double a = su * su;
+    double b = su * sv;
+    double c = sv * sv;
+    double det = a * c - b * b;
+
+    if (det <= 0)
+    {
+        return 0;
+    }
+
+    double t = length(distance_vector);
+    double footprint = 0;
+
+    for (const v3& differential : { ray_dx, ray_dy })
+    {
+        v3 neighbour = ray + differential;
+
+        double cosine = neighbour * n;
+
+        // the neighbouring ray misses the tangent plane, the pixel covers the whole surface
+        if (0 == cosine || (ray * n) / cosine <= 0)
+        {
+            return 1;
+        }
+
+        v3 dp = (t * (ray * n) / cosine) * neighbour - t * ray;
+
+        double du = (c * (dp * su) - b * (dp * sv)) / det;
+        double dv = (a * (dp * sv) - b * (dp * su)) / det;
+
+        footprint = std::max(footprint, std::sqrt(du * du + dv * dv));
+    }
+
+    return footprint;
+}
+
+color surface_color(const varmesh_scene_descriptor& scene, const v2& uv, double footprint)
+{
+    if (scene.materials.has_material(0))
+    {
+        return scene.materials.sample(0, uv[0], uv[1], footprint);
+    }
+
+    auto c = scene.mesh_color(uv[0], uv[1]);
+
+    return color{ {c[0], c[1], c[2]} };
+}
+
+color surface_color(const multiple_surfaces_scene_descriptor& scene, int surface, const v2& uv, double footprint)
+{
+    if (scene.materials.has_material(surface))
+    {
+        return scene.materials.sample(surface, uv[0], uv[1], footprint);
+    }
+
+    auto c = scene.surfaces[surface].mesh_color(uv[0], uv[1]);
+
+    return color{ {c[0], c[1], c[2]} };
 }
 
 void trace_ray(std::vector<int>::iterator pixel, v3 ray, varmesh_scene_descriptor& scene)
@@ -113,7 +234,9 @@ void trace_ray(std::vector<int>::iterator pixel, v3 ray, varmesh_scene_descripto
 
         double shade_factor = shade(normale, scene.light);
 
-        auto mesh_color = scene.mesh_color(uv_parameter[0], uv_parameter[1]);
+        double footprint = scene.materials.needs_footprint(0) ? primary_ray_footprint(scene, scene.mesh, distance_vector, uv_parameter) : 0;
+
+        auto mesh_color = surface_color(scene, uv_parameter, footprint);
 
         *pixel++ = (std::round(shade_factor * mesh_color[0]));
         *pixel++ = (std::round(shade_factor * mesh_color[1]));
@@ -123,18 +246,96 @@ void trace_ray(std::vector<int>::iterator pixel, v3 ray, varmesh_scene_descripto
 
 void trace_ray(std::vector<int>::iterator pixel, v3 ray, multiple_surfaces_scene_descriptor& scene)
 {
-    auto intersection = get_ray_surface_intersection(ray, scene, scene.epsilon);
+    shade_pixel(pixel, get_ray_surface_intersection(ray, scene, scene.epsilon), scene);
+}
+
+void trace_ray(std::vector<int>::iterator pixel, v3 ray, bounded_surfaces_scene_descriptor& scene)
+{
+    shade_pixel(pixel, get_ray_surface_intersection(scene.origin, ray, scene, scene.epsilon), scene);
+}
+
+v3 shade_intersection(const std::tuple<int, v3, v3, v2>& intersection, multiple_surfaces_scene_descriptor& scene)
+{
+    RENDER_TRACE_DETAIL_SPAN("shading");
+
+    auto [intersection_scene_object, distance_vector, normale, uv_parameter] = intersection;
+
+    double shade_factor = shade(normale, scene.light);
+
+    double footprint = scene.materials.needs_footprint(intersection_scene_object) ? primary_ray_footprint(scene, scene.surfaces[intersection_scene_object].mesh, distance_vector, uv_parameter) : 0;
+
+    auto mesh_color = surface_color(scene, intersection_scene_object, uv_parameter, footprint);
+
+    return v3{ shade_factor * mesh_color[0], shade_factor * mesh_color[1], shade_factor * mesh_color[2] };
+}
 
+void shade_pixel(std::vector<int>::iterator pixel, const std::optional<std::tuple<int, v3, v3, v2>>& intersection, multiple_surfaces_scene_descriptor& scene)
+{
     if (intersection.has_value())
     {
-        auto [intersection_scene_object, distance_vector, normale, uv_parameter] = *intersection;
+        v3 shaded = shade_intersection(*intersection, scene);
 
-        double shade_factor = shade(normale, scene.light);
+        *pixel++ = (std::round(shaded[0]));
+        *pixel++ = (std::round(shaded[1]));
+        *pixel++ = (std::round(shaded[2]));
+    }
+}
 
-        auto mesh_color = scene.surfaces[intersection_scene_object].mesh_color(uv_parameter[0], uv_parameter[1]);
+void shade_pixel(hdr_image& image, int index, const std::optional<std::tuple<int, v3, v3, v2>>& intersection, multiple_surfaces_scene_descriptor& scene)
+{
+    v3 radiance{ 0, 0, 0 };
 
-        *pixel++ = (std::round(shade_factor * mesh_color[0]));
-        *pixel++ = (std::round(shade_factor * mesh_color[1]));
-        *pixel++ = (std::round(shade_factor * mesh_color[2]));
+    if (intersection.has_value())
+    {
+        radiance = (1. / 255) * shade_intersection(*intersection, scene);
+    }
+
+    image.add_sample(index, radiance);
+}
+
+void raytrace_scene(std::vector<int>& pixel, synciterator& iter, multiple_surfaces_scene_descriptor& scene, aov_buffers& aovs)
+{
+    screen_geometry screen(scene.screen_width, scene.screen_height, scene.field_of_view, 0, 0, 0);
+
+    std::pair<int, int> xy;
+
+    while ((xy = iter.next()) != std::make_pair(-1, -1))
+    {
+        auto ray = normalize(screen.get_corresponding_ray(xy.first, xy.second));
+
+        int index = scene.screen_width * xy.second + xy.first;
+
+        long long cost = ray_cost(thread_intersection_statistics());
+
+        auto intersection = get_ray_surface_intersection(ray, scene, scene.epsilon);
+
+        shade_pixel(pixel.begin() + 3 * index, intersection, scene);
+
+        aovs.store(index, intersection, ray_cost(thread_intersection_statistics()) - cost);
     }
-}
\ No newline at end of file
+}
+
+void raytrace_scene(hdr_image& image, synciterator& iter, multiple_surfaces_scene_descriptor& scene, aov_buffers* aovs)
+{
+    screen_geometry screen(scene.screen_width, scene.screen_height, scene.field_of_view, 0, 0, 0);
+
+    std::pair<int, int> xy;
+
+    while ((xy = iter.next()) != std::make_pair(-1, -1))
+    {
+        auto ray = normalize(screen.get_corresponding_ray(xy.first, xy.second));
+
+        int index = scene.screen_width * xy.second + xy.first;
+
+        long long cost = ray_cost(thread_intersection_statistics());
+
+        auto intersection = get_ray_surface_intersection(ray, scene, scene.epsilon);
+
+        shade_pixel(image, index, intersection, scene);
+
+        if (nullptr != aovs)
+        {
+            aovs->store(index, intersection, ray_cost(thread_intersection_statistics()) - cost);
+        }
+    }
+}
@@ -5,6 +5,7 @@
 #include <thread>
 #include <vector>
 #include <optional>
+#include <limits>
 
 #include <raytracing/scene_descriptor.h>
 #include <geometry/types/vector.h>
@@ -17,14 +18,59 @@
 #include <geometry/algorithms/quasi_interpolation.h>
 #include <file_io/file_io.h>
 #include <raytracing/synciterator.h>
+#include <raytracing/aov_buffers.h>
+#include <graphics/hdr_image.h>
 #include <graphics/graphics_formulas.h>
 
+struct closest_intersection
+{
+    double distance2 = std::numeric_limits<double>::max();
+    v2 uv;
+    int scene_object = -1;
+    v3 distance_vector;
+};
+
+// replaces closest, if the ray hits the mesh in front of origin and closer than the current closest intersection
+void update_closest_intersection(const v3& origin, const v3& ray, const varmesh<4>& mesh, int scene_object_index, double epsilon, closest_intersection& closest, intersection_solver solver = intersection_solver::clipping);
+// only roots inside the trim region of the object count
+void update_closest_intersection(const v3& origin, const v3& ray, const scene_object& object, int scene_object_index, double epsilon, closest_intersection& closest, intersection_solver solver = intersection_solver::clipping);
+
+std::pair<v3, v3> evaluate_bezier_surface_derivatives(const varmesh<4>& mesh, double u, double v);
+
 std::optional<std::tuple<v3, v3, v2>> get_ray_surface_intersection(v3 ray, varmesh_scene_descriptor& scene, double epsilon);
 std::optional<std::tuple<int, v3, v3, v2>> get_ray_surface_intersection(v3 ray, multiple_surfaces_scene_descriptor& scene, double epsilon);
+std::optional<std::tuple<int, v3, v3, v2>> get_ray_surface_intersection(v3 origin, v3 ray, const multiple_surfaces_scene_descriptor& scene, double epsilon);
+std::optional<std::tuple<int, v3, v3, v2>> get_ray_surface_intersection(const closest_intersection& closest, const multiple_surfaces_scene_descriptor& scene);
+// only the surfaces, whose bounds are hit, are projected and clipped
+std::optional<std::tuple<int, v3, v3, v2>> get_ray_surface_intersection(v3 origin, v3 ray, bounded_surfaces_scene_descriptor& scene, double epsilon);
 
 void trace_ray(std::vector<int>::iterator pixel, v3 ray, varmesh_scene_descriptor& scene);
 
 void trace_ray(std::vector<int>::iterator pixel, v3 ray, multiple_surfaces_scene_descriptor& scene);
 
+void trace_ray(std::vector<int>::iterator pixel, v3 ray, bounded_surfaces_scene_descriptor& scene);
+
+// the material of the surface, if the scene has one, otherwise its mesh_color; footprint is the edge length of the
+// pixel in uv, used for the filtering of mip mapped textures
+color surface_color(const varmesh_scene_descriptor& scene, const v2& uv, double footprint = 0);
+color surface_color(const multiple_surfaces_scene_descriptor& scene, int surface, const v2& uv, double footprint = 0);
+
+// footprint in uv of the pixel, whose camera ray hits mesh at scene.origin + distance_vector: the ray differentials of
+// the pixel are transferred to the tangent plane of the hit and expressed in the derivatives of the surface
+double primary_ray_footprint(const scene_descriptor& scene, const varmesh<4>& mesh, const v3& distance_vector, const v2& uv);
+
+// the shaded colour of the intersected surface in 8 bit units, before rounding
+v3 shade_intersection(const std::tuple<int, v3, v3, v2>& intersection, multiple_surfaces_scene_descriptor& scene);
+
+// writes the shaded colour of the intersected surface, leaves the pixel untouched without intersection
+void shade_pixel(std::vector<int>::iterator pixel, const std::optional<std::tuple<int, v3, v3, v2>>& intersection, multiple_surfaces_scene_descriptor& scene);
+// adds the shaded colour as a sample of the pixel at index, black without intersection
+void shade_pixel(hdr_image& image, int index, const std::optional<std::tuple<int, v3, v3, v2>>& intersection, multiple_surfaces_scene_descriptor& scene);
+
+// like trace_ray for the camera rays of the pixels of iter, additionally storing the selected channels in aovs
+void raytrace_scene(std::vector<int>& pixel, synciterator& iter, multiple_surfaces_scene_descriptor& scene, aov_buffers& aovs);
+// the camera rays of the pixels of iter as samples of image
+void raytrace_scene(hdr_image& image, synciterator& iter, multiple_surfaces_scene_descriptor& scene, aov_buffers* aovs = nullptr);
+
 
 #endif
\ No newline at end of file
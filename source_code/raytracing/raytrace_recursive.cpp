@@ -0,0 +1,153 @@
+#include <cmath>
+
+#include "raytrace_recursive.h"
+#include "raytrace_mesh_through_quasi_interpolation.h"
+
+#include <graphics/graphics_formulas.h>
+#include <graphics/screen_geometry.h>
+#include <geometry/algorithms/render_trace.h>
+
+v3 offset_ray_origin(const v3& hit, const v3& normale, const v3& direction)
+{
+    v3 n = normalize(normale);
+
+    double side = (0 > n * direction) ? -1 : 1;
+
+    return hit + (side * 1E-6 * (1 + length(hit))) * n;
+}
+
+void shade_ray(const traced_ray& ray, const std::optional<std::tuple<int, v3, v3, v2>>& intersection, bool spawn_secondary_rays, std::vector<v3>& radiance, ray_queue& secondary_rays, const multiple_surfaces_scene_descriptor& scene)
+{
+    if (!intersection.has_value())
+    {
+        return;
+    }
+
+    auto [intersection_scene_object, distance_vector, normale, uv_parameter] = *intersection;
+
+    const scene_object& object = scene.surfaces[intersection_scene_object];
+
+    double shade_factor = shade(normale, scene.light);
+
+    // the ray differentials are only known for the camera rays
+    double footprint = ray.origin == scene.origin && scene.materials.needs_footprint(intersection_scene_object) ? primary_ray_footprint(scene, object.mesh, distance_vector, uv_parameter) : 0;
+
+    auto mesh_color = surface_color(scene, intersection_scene_object, uv_parameter, footprint);
+
+    double local_weight = ray.weight * (1 - object.reflectivity - object.transparency);
+
+    radiance[ray.pixel] = radiance[ray.pixel] + local_weight * shade_factor * v3{ double(mesh_color[0]), double(mesh_color[1]), double(mesh_color[2]) };
+
+    if (!spawn_secondary_rays)
+    {
+        return;
+    }
+
+    v3 hit = ray.origin + distance_vector;
+
+    double reflected_weight = ray.weight * object.reflectivity;
+    double refracted_weight = ray.weight * object.transparency;
+
+    if (minimum_ray_weight < refracted_weight)
+    {
+        auto refracted = refract(ray.direction, normale, object.refractive_index);
+
+        if (refracted.has_value())
+        {
+            secondary_rays.push(traced_ray{ offset_ray_origin(hit, normale, *refracted), *refracted, ray.pixel, refracted_weight });
+        }
+        else
+        {
+            // total internal reflection
+            reflected_weight += refracted_weight;
+        }
+    }
+
+    if (minimum_ray_weight < reflected_weight)
+    {
+        v3 reflected = reflect(ray.direction, normale);
+
+        secondary_rays.push(traced_ray{ offset_ray_origin(hit, normale, reflected), reflected, ray.pixel, reflected_weight });
+    }
+}
+
+void trace_rays_recursive(std::vector<v3>& radiance, std::vector<traced_ray> rays, const multiple_surfaces_scene_descriptor& scene, bool coherent)
+{
+    ray_queue queue;
+
+    for (const auto& ray : rays)
+    {
+        queue.push(ray);
+    }
+
+    for (int depth = 0; depth <= scene.max_depth && !queue.empty(); depth++)
+    {
+        ray_queue secondary_rays;
+
+        bool spawn_secondary_rays = depth < scene.max_depth;
+
+        if (coherent)
+        {
+            auto bins = queue.bin_rays();
+
+            for (const auto& bin : bins)
+            {
+                auto begin = queue.rays().begin() + bin.begin;
+                auto end = queue.rays().begin() + bin.end;
+
+                auto intersections = trace_ray_bin(begin, end, scene);
+
+                for (auto ray = begin; ray != end; ray++)
+                {
+                    shade_ray(*ray, intersections[ray - begin], spawn_secondary_rays, radiance, secondary_rays, scene);
+                }
+            }
+        }
+        else
+        {
+            for (const auto& ray : queue.rays())
+            {
+                auto intersection = get_ray_surface_intersection(ray.origin, ray.direction, scene, scene.epsilon);
+
+                shade_ray(ray, intersection, spawn_secondary_rays, radiance, secondary_rays, scene);
+            }
+        }
+
+        queue = std::move(secondary_rays);
+    }
+}
+
+void raytrace_scene_recursive(std::vector<int>& pixel, synciterator& rows, const multiple_surfaces_scene_descriptor& scene, bool coherent)
+{
+    screen_geometry screen(scene.screen_width, scene.screen_height, scene.field_of_view, 0, 0, 0);
+
+    std::pair<int, int> xy;
+
+    while ((xy = rows.next()) != std::make_pair(-1, -1))
+    {
+        int y = xy.second;
+
+        RENDER_TRACE_SPAN("row");
+
+        std::vector<traced_ray> rays;
+
+        for (int x = 0; x < scene.screen_width; x++)
+        {
+            rays.push_back(traced_ray{ scene.origin, normalize(screen.get_corresponding_ray(x, y)), x, 1 });
+        }
+
+        std::vector<v3> radiance(scene.screen_width, v3{ 0, 0, 0 });
+
+        trace_rays_recursive(radiance, std::move(rays), scene, coherent);
+
+        for (int x = 0; x < scene.screen_width; x++)
+        {
+            int pixelindex = 3 * (scene.screen_width * y + x);
+
+            for (int c = 0; c < 3; c++)
+            {
+                pixel[pixelindex + c] = std::round(radiance[x][c]);
+            }
+        }
+    }
+}
@@ -0,0 +1,24 @@
+#ifndef raytrace_recursive_h
+#define raytrace_recursive_h
+
+#include <vector>
+
+#include <raytracing/scene_descriptor.h>
+#include <raytracing/synciterator.h>
+#include <raytracing/ray_queue.h>
+#include <geometry/types/vector.h>
+
+// rays carrying less weight can't change the 8 bit result of a pixel noticeably and are dropped
+const double minimum_ray_weight = 1. / 512;
+
+v3 offset_ray_origin(const v3& hit, const v3& normale, const v3& direction);
+
+// traces the rays level by level: all rays of one depth are intersected, before the secondary rays
+// they spawn (reflection, refraction) are processed; if coherent, the rays of a level are binned by
+// direction octant and origin and each bin is traced surface by surface, otherwise ray by ray
+void trace_rays_recursive(std::vector<v3>& radiance, std::vector<traced_ray> rays, const multiple_surfaces_scene_descriptor& scene, bool coherent = true);
+
+// each element of rows is a complete screen row, which is traced as one batch
+void raytrace_scene_recursive(std::vector<int>& pixel, synciterator& rows, const multiple_surfaces_scene_descriptor& scene, bool coherent = true);
+
+#endif
@@ -1,26 +1,33 @@
 #include "raytrace_subdivided_mesh.h"
+#include "raytrace_mesh_through_quasi_interpolation.h"
 
-void trace_ray_with_meshes_hierarchy(std::vector<int>::iterator pixel, v3 ray, subdivided_mesh_scene_descriptor scene)
+void trace_ray_with_meshes_hierarchy(std::vector<int>::iterator pixel, v3 ray, const subdivided_mesh_scene_descriptor& scene)
 {
-    std::vector<int> intersected_meshes = intersects_mesh(scene.origin, ray, scene.meshes_hierarchy);
+    // reused by the rays of the thread
+    thread_local std::vector<int> intersected_meshes;
+    thread_local std::vector<v2> projection_coordinates;
+
+    scene.hierarchy.intersected_leaves(scene.origin, ray, intersected_meshes, projection_coordinates);
 
     double t = std::numeric_limits<double>::max();
     double shade_factor = 0;
 
     for (auto index : intersected_meshes)
     {
-        v3 bary = remove_dimension(barycentre_of_mesh(scene.meshes_hierarchy[index]));
+        v3 bary = remove_dimension(barycentre_of_mesh(scene.hierarchy.leaf(index).mesh));
 
         double this_t = bary * bary;
         if (this_t < t)
         {
             t = this_t;
-            v3 normale = normale_of_mesh(remove_dimension(scene.meshes_hierarchy[index]));
+            v3 normale = normale_of_mesh(remove_dimension(scene.hierarchy.leaf(index).mesh));
             shade_factor = shade(normale, scene.light);
         }
     }
 
-    *pixel++ = std::round(shade_factor * scene.mesh_color(0, 0)[0]);
-    *pixel++ = std::round(shade_factor * scene.mesh_color(0, 0)[1]);
-    *pixel++ = std::round(shade_factor * scene.mesh_color(0, 0)[2]);
+    auto mesh_color = surface_color(scene, v2{ {0, 0} });
+
+    *pixel++ = std::round(shade_factor * mesh_color[0]);
+    *pixel++ = std::round(shade_factor * mesh_color[1]);
+    *pixel++ = std::round(shade_factor * mesh_color[2]);
 }
@@ -16,7 +16,7 @@
 #include <raytracing/synciterator.h>
 #include <graphics/graphics_formulas.h>
 
-void trace_ray_with_meshes_hierarchy(std::vector<int>::iterator pixel, v3 ray, subdivided_mesh_scene_descriptor scene);
+void trace_ray_with_meshes_hierarchy(std::vector<int>::iterator pixel, v3 ray, const subdivided_mesh_scene_descriptor& scene);
 
 #endif
 
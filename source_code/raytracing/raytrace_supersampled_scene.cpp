@@ -0,0 +1,262 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "raytrace_supersampled_scene.h"
+#include "raytrace_mesh_through_quasi_interpolation.h"
+#include "raytrace_binned_scene.h"
+
+#include <geometry/algorithms/render_trace.h>
+
+namespace
+{
+    // splitmix64, the jitter has to be the same, whichever thread traces the pixel
+    std::uint64_t mix(std::uint64_t z)
+    {
+        z += 0x9e3779b97f4a7c15ull;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+
+        return z ^ (z >> 31);
+    }
+
+    double luminance(const v3& c)
+    {
+        return 0.2126 * c[0] + 0.7152 * c[1] + 0.0722 * c[2];
+    }
+
+    void add_hint(std::vector<int>& hints, int surface)
+    {
+        if (0 <= surface && std::find(hints.begin(), hints.end(), surface) == hints.end())
+        {
+            hints.push_back(surface);
+        }
+    }
+
+    // radiance in units of white, black without intersection
+    v3 shade_sample(const std::optional<std::tuple<int, v3, v3, v2>>& intersection, binned_surfaces_scene_descriptor& scene)
+    {
+        return intersection.has_value() ? (1. / 255) * shade_intersection(*intersection, scene) : v3{ 0, 0, 0 };
+    }
+}
+
+v2 stratified_sample(int x, int y, int sample, int strata)
+{
+    std::uint64_t h = mix((std::uint64_t(std::uint32_t(x)) << 32 | std::uint32_t(y)) ^ mix(std::uint64_t(sample)));
+
+    // 24 bits each, exact in double
+    double jitter_x = double(h & 0xffffff) / double(1 << 24);
+    double jitter_y = double((h >> 24) & 0xffffff) / double(1 << 24);
+
+    int cell = sample % (strata * strata);
+
+    return v2{ (cell % strata + jitter_x) / strata, (cell / strata + jitter_y) / strata };
+}
+
+std::optional<std::tuple<int, v3, v3, v2>> get_ray_surface_intersection(v3 ray, int tile, const std::vector<int>& hints, binned_surfaces_scene_descriptor& scene, const std::vector<bounding_box>& surface_bounds, double epsilon)
+{
+    closest_intersection closest;
+
+    for (int scene_object_index : hints)
+    {
+        update_closest_intersection(scene.origin, ray, scene.surfaces[scene_object_index], scene_object_index, epsilon, closest, scene.solver);
+    }
+
+    for (int scene_object_index : scene.tile_surfaces[tile])
+    {
+        if (std::find(hints.begin(), hints.end(), scene_object_index) != hints.end())
+        {
+            continue;
+        }
+
+        double entry;
+
+        if (!ray_intersects_bounding_box(scene.origin, ray, surface_bounds[scene_object_index], entry) || (0 <= closest.scene_object && closest.distance2 < entry * entry))
+        {
+            continue;
+        }
+
+        update_closest_intersection(scene.origin, ray, scene.surfaces[scene_object_index], scene_object_index, epsilon, closest, scene.solver);
+    }
+
+    return get_ray_surface_intersection(closest, scene);
+}
+
+supersampling_state::supersampling_state(const binned_surfaces_scene_descriptor& scene)
+{
+    for (const auto& surface : scene.surfaces)
+    {
+        surface_bounds.push_back(bounding_box_of_mesh(surface.mesh));
+    }
+
+    size_t size = size_t(scene.screen_width) * scene.screen_height;
+
+    centre_surface.assign(size, -1);
+    centre_luminance.assign(size, 0);
+    luminance_sum.assign(size, 0);
+    luminance_square_sum.assign(size, 0);
+    refine.assign(size, false);
+}
+
+void raytrace_centre_sample(int x, int y, int tile, screen_geometry& screen, hdr_image& image, supersampling_state& state, binned_surfaces_scene_descriptor& scene, aov_buffers* aovs)
+{
+    int index = scene.screen_width * y + x;
+
+    auto ray = normalize(screen.get_corresponding_ray(x, y));
+
+    long long cost = ray_cost(thread_intersection_statistics());
+
+    auto intersection = get_ray_surface_intersection(ray, tile, scene, scene.epsilon);
+
+    v3 radiance = shade_sample(intersection, scene);
+
+    image.add_sample(index, radiance);
+
+    double l = luminance(radiance);
+
+    state.centre_surface[index] = intersection.has_value() ? std::get<0>(*intersection) : -1;
+    state.centre_luminance[index] = float(l);
+    state.luminance_sum[index] = l;
+    state.luminance_square_sum[index] = l * l;
+
+    if (nullptr != aovs)
+    {
+        aovs->store(index, intersection, ray_cost(thread_intersection_statistics()) - cost);
+    }
+}
+
+void raytrace_centre_samples(hdr_image& image, supersampling_state& state, synciterator& tile_iterator, binned_surfaces_scene_descriptor& scene, aov_buffers* aovs)
+{
+    screen_geometry screen(scene.screen_width, scene.screen_height, scene.field_of_view, 0, 0, 0);
+
+    std::pair<int, int> xy;
+
+    while ((xy = tile_iterator.next()) != std::make_pair(-1, -1))
+    {
+        int tile_index = xy.second;
+        const screen_tile& tile = scene.tiles[tile_index];
+
+        RENDER_TRACE_SPAN("tile");
+
+        for (int y = tile.y_begin; y < tile.y_end; y++)
+        {
+            for (int x = tile.x_begin; x < tile.x_end; x++)
+            {
+                raytrace_centre_sample(x, y, tile_index, screen, image, state, scene, aovs);
+            }
+        }
+    }
+}
+
+int mark_pixels_to_refine(const hdr_image& image, supersampling_state& state, const supersampling_settings& settings, int pass)
+{
+    int width = image.width;
+    int height = image.height;
+
+    int marked = 0;
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            int index = width * y + x;
+
+            bool refine = false;
+
+            if (1 == pass)
+            {
+                for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, height - 1) && !refine; ny++)
+                {
+                    for (int nx = std::max(x - 1, 0); nx <= std::min(x + 1, width - 1) && !refine; nx++)
+                    {
+                        int neighbour = width * ny + nx;
+
+                        refine = state.centre_surface[neighbour] != state.centre_surface[index]
+                            || settings.contrast_threshold < std::abs(state.centre_luminance[neighbour] - state.centre_luminance[index]);
+                    }
+                }
+            }
+            else if (state.refine[index] && image.weights[index] < settings.max_samples)
+            {
+                double n = image.weights[index];
+                double mean = state.luminance_sum[index] / n;
+                double variance = std::max(state.luminance_square_sum[index] / n - mean * mean, 0.);
+
+                refine = settings.noise_threshold < std::sqrt(variance);
+            }
+
+            state.refine[index] = refine;
+            marked += refine;
+        }
+    }
+
+    return marked;
+}
+
+void raytrace_refinement_samples(int x, int y, int tile, screen_geometry& screen, hdr_image& image, supersampling_state& state, binned_surfaces_scene_descriptor& scene, const supersampling_settings& settings, int pass, std::vector<int>& hints)
+{
+    int index = scene.screen_width * y + x;
+
+    int samples_per_pass = settings.strata * settings.strata;
+
+    hints.clear();
+
+    for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, scene.screen_height - 1); ny++)
+    {
+        for (int nx = std::max(x - 1, 0); nx <= std::min(x + 1, scene.screen_width - 1); nx++)
+        {
+            add_hint(hints, state.centre_surface[scene.screen_width * ny + nx]);
+        }
+    }
+
+    for (int i = 0; i < samples_per_pass && image.weights[index] < settings.max_samples; i++)
+    {
+        v2 point = stratified_sample(x, y, (pass - 1) * samples_per_pass + i, settings.strata);
+
+        auto ray = normalize(screen.get_corresponding_ray(x, y, point[0], point[1]));
+
+        auto intersection = get_ray_surface_intersection(ray, tile, hints, scene, state.surface_bounds, scene.epsilon);
+
+        v3 radiance = shade_sample(intersection, scene);
+
+        image.add_sample(index, radiance);
+
+        double l = luminance(radiance);
+
+        state.luminance_sum[index] += l;
+        state.luminance_square_sum[index] += l * l;
+
+        if (intersection.has_value())
+        {
+            add_hint(hints, std::get<0>(*intersection));
+        }
+    }
+}
+
+void raytrace_refinement_pass(hdr_image& image, supersampling_state& state, synciterator& tile_iterator, binned_surfaces_scene_descriptor& scene, const supersampling_settings& settings, int pass)
+{
+    screen_geometry screen(scene.screen_width, scene.screen_height, scene.field_of_view, 0, 0, 0);
+
+    std::vector<int> hints;
+
+    std::pair<int, int> xy;
+
+    while ((xy = tile_iterator.next()) != std::make_pair(-1, -1))
+    {
+        int tile_index = xy.second;
+        const screen_tile& tile = scene.tiles[tile_index];
+
+        RENDER_TRACE_SPAN("refinement tile");
+
+        for (int y = tile.y_begin; y < tile.y_end; y++)
+        {
+            for (int x = tile.x_begin; x < tile.x_end; x++)
+            {
+                if (state.refine[scene.screen_width * y + x])
+                {
+                    raytrace_refinement_samples(x, y, tile_index, screen, image, state, scene, settings, pass, hints);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef raytrace_supersampled_scene_h
+#define raytrace_supersampled_scene_h
+
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include <raytracing/scene_descriptor.h>
+#include <raytracing/synciterator.h>
+#include <raytracing/aov_buffers.h>
+#include <graphics/hdr_image.h>
+#include <graphics/screen_geometry.h>
+#include <geometry/algorithms/bezier_patch_bvh.h>
+
+// every pixel gets a sample at its centre; pixels at the edges of surfaces or with contrast to their neighbours are
+// refined pass by pass with strata x strata samples, until their samples agree or they have max_samples
+struct supersampling_settings
+{
+	int strata = 2;
+	int max_samples = 16;
+	// refinement stops, when the standard deviation of the luminance of the samples of a pixel is at most this
+	double noise_threshold = 1. / 64;
+	// a pixel is refined, if the luminance of its centre sample differs more from one of its 8 neighbours
+	double contrast_threshold = 1. / 16;
+};
+
+// the point in the pixel of its sample with the index, jittered in the cells of a strata x strata grid, which are
+// visited in order; the same for the same arguments
+v2 stratified_sample(int x, int y, int sample, int strata);
+
+// the surfaces of hints are tested first, then the other surfaces of the tile, unless the ray enters their bounds
+// behind the closest hit found so far; the hit is the one without hints
+std::optional<std::tuple<int, v3, v3, v2>> get_ray_surface_intersection(v3 ray, int tile, const std::vector<int>& hints, binned_surfaces_scene_descriptor& scene, const std::vector<bounding_box>& surface_bounds, double epsilon);
+
+// per pixel the surface hit by the centre sample and the luminance moments of all samples
+struct supersampling_state
+{
+	supersampling_state(const binned_surfaces_scene_descriptor& scene);
+
+	std::vector<bounding_box> surface_bounds;
+	// -1 for the background
+	std::vector<int> centre_surface;
+	std::vector<float> centre_luminance;
+	std::vector<double> luminance_sum;
+	std::vector<double> luminance_square_sum;
+	std::vector<bool> refine;
+};
+
+// the sample at the centre of the pixel (x, y) of the tile
+void raytrace_centre_sample(int x, int y, int tile, screen_geometry& screen, hdr_image& image, supersampling_state& state, binned_surfaces_scene_descriptor& scene, aov_buffers* aovs = nullptr);
+
+// the first pass, aovs receive the channels of the centre samples
+void raytrace_centre_samples(hdr_image& image, supersampling_state& state, synciterator& tile_iterator, binned_surfaces_scene_descriptor& scene, aov_buffers* aovs = nullptr);
+
+// marks the pixels of the next pass, pass 1 by the centre samples, later ones by the noise of the samples; returns
+// the number of marked pixels
+int mark_pixels_to_refine(const hdr_image& image, supersampling_state& state, const supersampling_settings& settings, int pass);
+
+// the strata x strata samples of the pass of one pixel, hints is scratch space
+void raytrace_refinement_samples(int x, int y, int tile, screen_geometry& screen, hdr_image& image, supersampling_state& state, binned_surfaces_scene_descriptor& scene, const supersampling_settings& settings, int pass, std::vector<int>& hints);
+
+// adds strata x strata samples to the marked pixels of the tiles; the surfaces hit by the centre samples of the pixel
+// and its neighbours and by its earlier samples in the pass are the hints of the next sample
+void raytrace_refinement_pass(hdr_image& image, supersampling_state& state, synciterator& tile_iterator, binned_surfaces_scene_descriptor& scene, const supersampling_settings& settings, int pass);
+
+#endif
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#include "raytrace_surface_analysis.h"
+#include "raytrace_mesh_through_quasi_interpolation.h"
+
+#include <graphics/graphics_formulas.h>
+
+v3 zebra_stripe_color(const v3& reflected, const surface_analysis_settings& settings)
+{
+    double elevation = std::asin(std::clamp(normalize(reflected) * normalize(settings.stripe_axis), -1., 1.));
+
+    double stripe = (elevation / std::numbers::pi + 0.5) * settings.stripe_count;
+
+    if (0 == int(std::floor(stripe)) % 2)
+    {
+        return v3{ 255, 255, 255 };
+    }
+
+    return v3{ 0, 0, 0 };
+}
+
+v3 curvature_false_color(double curvature, double curvature_scale)
+{
+    double c = std::tanh(curvature * curvature_scale);
+
+    if (0 <= c)
+    {
+        return v3{ 255, 255 * (1 - c), 255 * (1 - c) };
+    }
+
+    return v3{ 255 * (1 + c), 255 * (1 + c), 255 };
+}
+
+v3 surface_analysis_color(const v3& ray, const varmesh<4>& mesh, const v2& uv_parameter, const surface_analysis_settings& settings)
+{
+    auto differentials = evaluate_rational_bezier_surface_differentials(mesh, uv_parameter[0], uv_parameter[1]);
+
+    switch (settings.mode)
+    {
+    case surface_analysis_mode::gaussian_curvature:
+        return curvature_false_color(curvature_of_surface(differentials).gaussian, settings.curvature_scale * settings.curvature_scale);
+    case surface_analysis_mode::mean_curvature:
+        return curvature_false_color(curvature_of_surface(differentials).mean, settings.curvature_scale);
+    default:
+        return zebra_stripe_color(reflect(ray, cross_product(differentials.du, differentials.dv)), settings);
+    }
+}
+
+void write_color(std::vector<int>::iterator pixel, const v3& color)
+{
+    *pixel++ = std::round(color[0]);
+    *pixel++ = std::round(color[1]);
+    *pixel++ = std::round(color[2]);
+}
+
+void trace_ray_surface_analysis(std::vector<int>::iterator pixel, v3 ray, varmesh_scene_descriptor& scene, const surface_analysis_settings& settings)
+{
+    auto intersection = get_ray_surface_intersection(ray, scene, scene.epsilon);
+
+    if (intersection.has_value())
+    {
+        auto [distance_vector, normale, uv_parameter] = *intersection;
+
+        write_color(pixel, surface_analysis_color(ray, scene.mesh, uv_parameter, settings));
+    }
+}
+
+void trace_ray_surface_analysis(std::vector<int>::iterator pixel, v3 ray, multiple_surfaces_scene_descriptor& scene, const surface_analysis_settings& settings)
+{
+    auto intersection = get_ray_surface_intersection(ray, scene, scene.epsilon);
+
+    if (intersection.has_value())
+    {
+        auto [intersection_scene_object, distance_vector, normale, uv_parameter] = *intersection;
+
+        write_color(pixel, surface_analysis_color(ray, scene.surfaces[intersection_scene_object].mesh, uv_parameter, settings));
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef raytrace_surface_analysis_h
+#define raytrace_surface_analysis_h
+
+#include <vector>
+
+#include <raytracing/scene_descriptor.h>
+#include <geometry/types/vector.h>
+#include <geometry/algorithms/surface_curvature.h>
+
+enum class surface_analysis_mode
+{
+    zebra,
+    gaussian_curvature,
+    mean_curvature
+};
+
+struct surface_analysis_settings
+{
+    surface_analysis_mode mode = surface_analysis_mode::zebra;
+    // the stripes of the environment are parallel to the plane orthogonal to stripe_axis
+    v3 stripe_axis{ 0, 1, 0 };
+    int stripe_count = 16;
+    // curvatures of about 1/curvature_scale get saturated colours
+    double curvature_scale = 1;
+};
+
+v3 zebra_stripe_color(const v3& reflected, const surface_analysis_settings& settings);
+
+// white for flat, red for positive and blue for negative curvature
+v3 curvature_false_color(double curvature, double curvature_scale);
+
+v3 surface_analysis_color(const v3& ray, const varmesh<4>& mesh, const v2& uv_parameter, const surface_analysis_settings& settings);
+
+void trace_ray_surface_analysis(std::vector<int>::iterator pixel, v3 ray, varmesh_scene_descriptor& scene, const surface_analysis_settings& settings);
+
+void trace_ray_surface_analysis(std::vector<int>::iterator pixel, v3 ray, multiple_surfaces_scene_descriptor& scene, const surface_analysis_settings& settings);
+
+#endif
@@ -0,0 +1,145 @@
+#include <atomic>
+#include <cmath>
+#include <numbers>
+
+#include "raytrace_tessellated_scene.h"
+#include "render_threads.h"
+
+#include <graphics/graphics_formulas.h>
+
+tessellation_settings screen_space_tessellation_settings(const scene_descriptor& scene, double pixel_tolerance, double chordal_tolerance)
+{
+    tessellation_settings settings;
+
+    settings.chordal_tolerance = chordal_tolerance;
+    settings.pixel_tolerance = pixel_tolerance;
+    settings.eye = scene.origin;
+    settings.pixel_angle = 2 * std::tan(std::numbers::pi * 0.5 * scene.field_of_view / 180.) / scene.screen_height;
+
+    return settings;
+}
+
+facetted_surface_scene_descriptor tessellate_surfaces(const multiple_surfaces_scene_descriptor& scene, const tessellation_settings& settings, int threadcount)
+{
+    std::vector<patch_tessellation> tessellations(scene.surfaces.size());
+
+    std::atomic<int> next_surface = 0;
+
+    trace_multithreaded(threadcount, [&] {
+        int surface;
+        while ((surface = next_surface++) < scene.surfaces.size())
+        {
+            const scene_object& object = scene.surfaces[surface];
+
+            tessellations[surface] = tessellate_patch(object.mesh, settings, object.trim.is_trimmed() ? &object.trim : nullptr);
+        }
+    });
+
+    facetted_surface_scene_descriptor facetted{ scene };
+    facetted.materials = scene.materials;
+
+    for (int surface = 0; surface < tessellations.size(); surface++)
+    {
+        const patch_tessellation& tessellation = tessellations[surface];
+
+        int offset = facetted.points.size();
+
+        facetted.points.insert(facetted.points.end(), tessellation.points.begin(), tessellation.points.end());
+        facetted.normals.insert(facetted.normals.end(), tessellation.normals.begin(), tessellation.normals.end());
+        facetted.uvs.insert(facetted.uvs.end(), tessellation.uvs.begin(), tessellation.uvs.end());
+
+        for (const auto& f : tessellation.facettes)
+        {
+            facetted.facettes.push_back({ f[0] + offset, f[1] + offset, f[2] + offset });
+            facetted.facette_surfaces.push_back(surface);
+        }
+    }
+
+    return facetted;
+}
+
+tessellated_scene_descriptor tessellate_scene(const multiple_surfaces_scene_descriptor& scene, const tessellation_settings& settings, int threadcount)
+{
+    tessellated_scene_descriptor result(tessellate_surfaces(scene, settings, threadcount));
+
+    for (const auto& object : scene.surfaces)
+    {
+        result.surface_colors.push_back(object.mesh_color);
+    }
+
+    return result;
+}
+
+std::optional<std::tuple<int, v3, v3, v2>> get_ray_surface_intersection(v3 ray, const tessellated_scene_descriptor& scene)
+{
+    auto hit = scene.hierarchy.closest_hit(scene.origin, ray, scene.points, scene.facettes);
+
+    if (!hit.has_value())
+    {
+        return {};
+    }
+
+    const auto& f = scene.facettes[hit->facette];
+
+    double b0 = 1 - hit->b1 - hit->b2;
+
+    v3 normale = cross_product(scene.points[f[1]] - scene.points[f[0]], scene.points[f[2]] - scene.points[f[0]]);
+
+    if (!scene.normals.empty())
+    {
+        v3 n[3];
+        for (int i = 0; i < 3; i++)
+        {
+            n[i] = scene.normals[f[i]];
+        }
+
+        // degenerate at the poles of a patch
+        if (0 < length2(n[0]) && 0 < length2(n[1]) && 0 < length2(n[2]))
+        {
+            normale = b0 * normalize(n[0]) + hit->b1 * normalize(n[1]) + hit->b2 * normalize(n[2]);
+        }
+    }
+
+    v2 uv{ 0, 0 };
+
+    if (!scene.uvs.empty())
+    {
+        uv = b0 * scene.uvs[f[0]] + hit->b1 * scene.uvs[f[1]] + hit->b2 * scene.uvs[f[2]];
+    }
+
+    int surface = scene.facette_surfaces.empty() ? 0 : scene.facette_surfaces[hit->facette];
+
+    return { std::make_tuple(surface, hit->t * ray, normale, uv) };
+}
+
+void trace_ray(std::vector<int>::iterator pixel, v3 ray, tessellated_scene_descriptor& scene)
+{
+    auto intersection = get_ray_surface_intersection(ray, scene);
+
+    if (!intersection.has_value())
+    {
+        return;
+    }
+
+    auto [surface, distance_vector, normale, uv_parameter] = *intersection;
+
+    double shade_factor = shade(normale, scene.light);
+
+    color mesh_color{ {255, 255, 255} };
+
+    // the mip maps are sampled at their finest level, there are no ray differentials for triangles yet
+    if (scene.materials.has_material(surface))
+    {
+        mesh_color = scene.materials.sample(surface, uv_parameter[0], uv_parameter[1]);
+    }
+    else if (surface < scene.surface_colors.size())
+    {
+        auto c = scene.surface_colors[surface](uv_parameter[0], uv_parameter[1]);
+
+        mesh_color = color{ {c[0], c[1], c[2]} };
+    }
+
+    *pixel++ = (std::round(shade_factor * mesh_color[0]));
+    *pixel++ = (std::round(shade_factor * mesh_color[1]));
+    *pixel++ = (std::round(shade_factor * mesh_color[2]));
+}
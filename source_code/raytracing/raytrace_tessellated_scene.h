@@ -0,0 +1,27 @@
+#ifndef raytrace_tessellated_scene_h
+#define raytrace_tessellated_scene_h
+
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include <raytracing/scene_descriptor.h>
+#include <geometry/types/vector.h>
+#include <geometry/algorithms/tessellation.h>
+
+// bounds the tessellation error by pixel_tolerance pixels as seen from the camera of the scene, and by chordal_tolerance
+tessellation_settings screen_space_tessellation_settings(const scene_descriptor& scene, double pixel_tolerance, double chordal_tolerance = 1E-2);
+
+// the patches are tessellated by threadcount threads and merged in the order of the surfaces; the facettes keep the
+// index of their surface, the surfaces keep their materials
+facetted_surface_scene_descriptor tessellate_surfaces(const multiple_surfaces_scene_descriptor& scene, const tessellation_settings& settings, int threadcount);
+
+// tessellate_surfaces with the tree over the triangles; the surfaces keep their colours
+tessellated_scene_descriptor tessellate_scene(const multiple_surfaces_scene_descriptor& scene, const tessellation_settings& settings, int threadcount);
+
+// same as the exact tracers: scene object, distance vector, normale and uv, which are interpolated over the triangle
+std::optional<std::tuple<int, v3, v3, v2>> get_ray_surface_intersection(v3 ray, const tessellated_scene_descriptor& scene);
+
+void trace_ray(std::vector<int>::iterator pixel, v3 ray, tessellated_scene_descriptor& scene);
+
+#endif
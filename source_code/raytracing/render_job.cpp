@@ -0,0 +1,32 @@
+#include "render_job.h"
+
+void run_render_threads(int threadcount, const cancellation_token& token, std::function<void()> trace)
+{
+    trace_multithreaded(threadcount, [&] {
+        scoped_cancellation_token scope(&token);
+
+        trace();
+    });
+}
+
+image_render_job start_render_job(binned_surfaces_scene_descriptor& scene, int threadcount)
+{
+    auto progress = std::make_shared<render_progress>((long long)scene.tiles.size());
+
+    auto result = std::async(std::launch::async, [&scene, threadcount, progress]() -> std::optional<std::tuple<std::vector<int>, unsigned int, unsigned int>> {
+        std::vector<int> pixel(scene.screen_width * scene.screen_height * 3, 0);
+
+        synciterator tile_iterator(1, int(scene.tiles.size()), progress.get());
+
+        run_render_threads(threadcount, progress->token(), [&] { raytrace_binned_scene(pixel, tile_iterator, scene); });
+
+        if (progress->is_cancelled())
+        {
+            return std::nullopt;
+        }
+
+        return std::make_tuple(pixel, scene.screen_width, scene.screen_height);
+    });
+
+    return image_render_job{ progress, std::move(result) };
+}
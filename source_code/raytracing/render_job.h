@@ -0,0 +1,56 @@
+#ifndef render_job_h
+#define render_job_h
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include <raytracing/nurbs_raytracing.h>
+#include <raytracing/render_progress.h>
+
+// a render running in the background; progress may be polled and the job cancelled from any thread, the image is
+// delivered through result and is empty, if the job was cancelled before it was finished; the scene has to outlive
+// the job
+template<class result_type> struct render_job
+{
+    std::shared_ptr<render_progress> progress;
+    std::future<std::optional<result_type>> result;
+
+    void cancel() { progress->cancel(); }
+};
+
+using image_render_job = render_job<std::tuple<std::vector<int>, unsigned int, unsigned int>>;
+
+// runs trace in threadcount threads, whose clipping loops poll the token, and waits for them
+void run_render_threads(int threadcount, const cancellation_token& token, std::function<void()> trace);
+
+// raytrace_scene_multithreaded as a job, progress counts pixels
+template<class scene_descriptor_type> image_render_job start_render_job(scene_descriptor_type& scene, std::function<void(std::vector<int>::iterator, v3, scene_descriptor_type&)> trace_ray_functional, int threadcount)
+{
+    auto progress = std::make_shared<render_progress>((long long)scene.screen_width * scene.screen_height);
+
+    auto result = std::async(std::launch::async, [&scene, trace_ray_functional, threadcount, progress]() -> std::optional<std::tuple<std::vector<int>, unsigned int, unsigned int>> {
+        std::vector<int> pixel(scene.screen_width * scene.screen_height * 3, 0);
+
+        synciterator iter(scene.screen_width, scene.screen_height, progress.get());
+
+        run_render_threads(threadcount, progress->token(), [&] { raytrace_scene(pixel, iter, scene, trace_ray_functional); });
+
+        if (progress->is_cancelled())
+        {
+            return std::nullopt;
+        }
+
+        return std::make_tuple(pixel, scene.screen_width, scene.screen_height);
+    });
+
+    return image_render_job{ progress, std::move(result) };
+}
+
+// the binned tracer as a job, progress counts tiles
+image_render_job start_render_job(binned_surfaces_scene_descriptor& scene, int threadcount);
+
+#endif
@@ -0,0 +1,27 @@
+#include "render_progress.h"
+
+render_progress::render_progress(long long total) : total(total), start(std::chrono::steady_clock::now())
+{
+}
+
+double render_progress::fraction() const
+{
+    return 0 < total ? double(completed_units()) / total : 1;
+}
+
+double render_progress::elapsed_seconds() const
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::optional<double> render_progress::remaining_seconds() const
+{
+    long long units = completed_units();
+
+    if (0 == units)
+    {
+        return std::nullopt;
+    }
+
+    return elapsed_seconds() * double(total - units) / units;
+}
@@ -0,0 +1,39 @@
+#ifndef render_progress_h
+#define render_progress_h
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+
+#include <geometry/algorithms/cancellation.h>
+
+// progress of a render in units of work (pixels, rows or tiles), which the workers mark finished through their
+// synciterator; may be read and cancelled from any thread
+class render_progress
+{
+public:
+    render_progress(long long total);
+
+    void advance() { completed.fetch_add(1, std::memory_order_relaxed); }
+
+    long long total_units() const { return total; }
+    long long completed_units() const { return completed.load(std::memory_order_relaxed); }
+    double fraction() const;
+
+    double elapsed_seconds() const;
+    // extrapolated from the rate of the units completed so far, empty before the first one
+    std::optional<double> remaining_seconds() const;
+
+    // the workers stop taking units, the clipping loops of their threads give up
+    void cancel() { cancellation.cancel(); }
+    bool is_cancelled() const { return cancellation.is_cancelled(); }
+    const cancellation_token& token() const { return cancellation; }
+
+private:
+    long long total;
+    std::atomic<long long> completed{ 0 };
+    std::chrono::steady_clock::time_point start;
+    cancellation_token cancellation;
+};
+
+#endif
@@ -0,0 +1,265 @@
+#include <chrono>
+#include <thread>
+
+#include "render_scene_description.h"
+#include <file_io/file_io.h>
+#include "nurbs_raytracing.h"
+#include "raytrace_binned_scene.h"
+#include "raytrace_tessellated_scene.h"
+
+namespace
+{
+    double seconds_since(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::chrono::steady_clock::time_point start_render_phase(hardware_counters* counters)
+    {
+        if (nullptr != counters)
+        {
+            counters->start();
+        }
+
+        return std::chrono::steady_clock::now();
+    }
+
+    // the triangles of the models are white, they get surface indices beyond those of the patches
+    tessellated_scene_descriptor tessellate_description(const scene_description& description, int threadcount)
+    {
+        const multiple_surfaces_scene_descriptor& scene = description.scene;
+
+        facetted_surface_scene_descriptor facetted = tessellate_surfaces(scene, screen_space_tessellation_settings(scene, description.pixel_tolerance), threadcount);
+
+        std::vector<std::function<std::vector<int>(double, double)>> surface_colors;
+        for (const auto& object : scene.surfaces)
+        {
+            surface_colors.push_back(object.mesh_color);
+        }
+
+        int offset = facetted.points.size();
+        int model_surface = scene.surfaces.size();
+
+        facetted.points.insert(facetted.points.end(), description.model_points.begin(), description.model_points.end());
+
+        // zero normals fall back to the normal of the facette
+        facetted.normals.resize(facetted.points.size(), v3{ 0, 0, 0 });
+        facetted.uvs.resize(facetted.points.size(), v2{ 0, 0 });
+
+        for (auto facette : description.model_facettes)
+        {
+            for (int& index : facette)
+            {
+                index += offset;
+            }
+
+            facetted.facettes.push_back(facette);
+            facetted.facette_surfaces.push_back(model_surface);
+        }
+
+        tessellated_scene_descriptor result(facetted);
+        result.surface_colors = surface_colors;
+
+        return result;
+    }
+}
+
+int threads_of_description(const scene_description& description)
+{
+    return 0 < description.threads ? description.threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+rendered_frame render_scene_description(const scene_description& description, render_report& report, hardware_counters* counters)
+{
+    const multiple_surfaces_scene_descriptor& scene = description.scene;
+
+    int threadcount = threads_of_description(description);
+
+    report.screen_width = scene.screen_width;
+    report.screen_height = scene.screen_height;
+    report.threads = threadcount;
+    report.tile_size = description.tile_size;
+    report.surfaces = scene.surfaces.size();
+    report.triangles = description.model_facettes.size();
+
+    rendered_frame frame;
+
+    auto start = std::chrono::steady_clock::now();
+
+    if (scene_renderer::tessellated == description.renderer)
+    {
+        report.renderer = "tessellated";
+
+        auto tessellated = tessellate_description(description, threadcount);
+
+        report.triangles = tessellated.facettes.size();
+        report.phase_seconds.emplace_back("preprocess", seconds_since(start));
+
+        start = start_render_phase(counters);
+        frame.pixel = std::get<0>(raytrace_scene_with_tessellated_surfaces_multithreaded(tessellated, threadcount));
+    }
+    else if (0 < scene.max_depth)
+    {
+        report.renderer = "recursive";
+
+        report.phase_seconds.emplace_back("preprocess", 0.);
+
+        intersection_statistics statistics;
+
+        start = start_render_phase(counters);
+
+        frame.pixel = std::get<0>(raytrace_scene_recursive_multithreaded(scene, threadcount, statistics));
+
+        report.statistics = statistics;
+    }
+    else
+    {
+        report.renderer = "binned";
+
+        auto binned = bin_surfaces_to_tiles(scene, description.tile_size);
+
+        report.phase_seconds.emplace_back("preprocess", seconds_since(start));
+
+        intersection_statistics statistics;
+
+        start = start_render_phase(counters);
+
+        if (needs_float_output(description))
+        {
+            frame.aovs.emplace(scene.screen_width, scene.screen_height, description.aovs);
+
+            if (description.supersampling.has_value())
+            {
+                frame.hdr = raytrace_scene_supersampled_multithreaded(binned, *description.supersampling, threadcount, statistics, &*frame.aovs);
+            }
+            else
+            {
+                frame.hdr = raytrace_scene_hdr_multithreaded(binned, threadcount, statistics, &*frame.aovs);
+            }
+        }
+        else
+        {
+            frame.pixel = std::get<0>(raytrace_scene_through_quasi_interpolation_multithreaded(binned, threadcount, statistics));
+        }
+
+        report.statistics = statistics;
+    }
+
+    double render_seconds = seconds_since(start);
+
+    if (nullptr != counters)
+    {
+        report.hardware_counters = counters->stop();
+    }
+
+    report.phase_seconds.emplace_back("render", render_seconds);
+
+    double rays = double(scene.screen_width) * scene.screen_height;
+
+    if (frame.hdr.has_value())
+    {
+        rays = 0;
+
+        for (float weight : frame.hdr->weights)
+        {
+            rays += weight;
+        }
+
+        report.samples_per_pixel = rays / (double(scene.screen_width) * scene.screen_height);
+    }
+
+    report.rays = rays;
+    report.rays_per_second = 0 < render_seconds ? rays / render_seconds : 0;
+
+    if (frame.hdr.has_value())
+    {
+        start = std::chrono::steady_clock::now();
+
+        frame.pixel = tone_map(*frame.hdr, description.mapping);
+
+        report.phase_seconds.emplace_back("tone_map", seconds_since(start));
+    }
+
+    return frame;
+}
+
+std::string write_rendered_frame(const scene_description& description, const rendered_frame& frame)
+{
+    const multiple_surfaces_scene_descriptor& scene = description.scene;
+
+    if (!serialize_as_ppm(description.output, scene.screen_width, scene.screen_height, frame.pixel))
+    {
+        return description.output.string();
+    }
+
+    if (frame.hdr.has_value() && !description.hdr_output.empty() && !serialize_as_pfm(description.hdr_output, *frame.hdr))
+    {
+        return description.hdr_output.string();
+    }
+
+    if (!frame.aovs.has_value())
+    {
+        return "";
+    }
+
+    const aov_buffers& aovs = *frame.aovs;
+
+    auto aov_path = [&](const std::string& channel) {
+        auto path = description.output;
+        return path.replace_filename(description.output.stem().string() + "." + channel + ".pfm");
+    };
+
+    // vectors as colour maps, the third component of uv is 0
+    auto as_colours = [&](const std::vector<float>& x, const std::vector<float>& y, const std::vector<float>* z) {
+        hdr_image image(aovs.width, aovs.height);
+
+        for (int i = 0; i < x.size(); i++)
+        {
+            image.add_sample(i, v3{ x[i], y[i], nullptr == z ? 0 : (*z)[i] });
+        }
+
+        return image;
+    };
+
+    // ids and costs are exact in float up to 2^24
+    auto as_floats = [](const std::vector<int>& values) {
+        return std::vector<float>(values.begin(), values.end());
+    };
+
+    std::vector<std::pair<std::filesystem::path, bool>> written;
+
+    if (aovs.selection.depth)
+    {
+        written.emplace_back(aov_path("depth"), serialize_as_pfm(aov_path("depth"), aovs.width, aovs.height, aovs.depth));
+    }
+
+    if (aovs.selection.normal)
+    {
+        written.emplace_back(aov_path("normal"), serialize_as_pfm(aov_path("normal"), as_colours(aovs.normal[0], aovs.normal[1], &aovs.normal[2])));
+    }
+
+    if (aovs.selection.uv)
+    {
+        written.emplace_back(aov_path("uv"), serialize_as_pfm(aov_path("uv"), as_colours(aovs.uv[0], aovs.uv[1], nullptr)));
+    }
+
+    if (aovs.selection.object_id)
+    {
+        written.emplace_back(aov_path("object_id"), serialize_as_pfm(aov_path("object_id"), aovs.width, aovs.height, as_floats(aovs.object_id)));
+    }
+
+    if (aovs.selection.cost)
+    {
+        written.emplace_back(aov_path("cost"), serialize_as_pfm(aov_path("cost"), aovs.width, aovs.height, as_floats(aovs.cost)));
+    }
+
+    for (const auto& [path, ok] : written)
+    {
+        if (!ok)
+        {
+            return path.string();
+        }
+    }
+
+    return "";
+}
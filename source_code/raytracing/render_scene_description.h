@@ -0,0 +1,31 @@
+#ifndef render_scene_description_h
+#define render_scene_description_h
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <file_io/scene_description.h>
+#include <file_io/render_report.h>
+
+struct rendered_frame
+{
+	std::vector<int> pixel;
+	// only, if the description needs a float output
+	std::optional<hdr_image> hdr;
+	std::optional<aov_buffers> aovs;
+};
+
+// threads of a description, that leaves the choice to the machine
+int threads_of_description(const scene_description& description);
+
+// the exact renderer bins the surfaces to tiles of the tile size, or traces recursively, if the scene has a max_depth;
+// the tessellated renderer traces the patches, tessellated with the pixel tolerance, together with the triangles of
+// the models; report receives the renderer, the preprocess, render and tone map phases and the counters, and the
+// hardware counters of the render phase, if given
+rendered_frame render_scene_description(const scene_description& description, render_report& report, hardware_counters* counters = nullptr);
+
+// the 8 bit image to the output, the float image and the aovs, if rendered; empty or the file, that can't be written
+std::string write_rendered_frame(const scene_description& description, const rendered_frame& frame);
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef render_threads_h
+#define render_threads_h
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <geometry/algorithms/intersection_statistics.h>
+
+// runs trace in threadcount threads and waits for them
+template<class tracer> void trace_multithreaded(int threadcount, tracer trace)
+{
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadcount; i++)
+    {
+        threads.push_back(std::thread([&] { trace(); }));
+    }
+
+    for (int i = 0; i < threads.size(); i++)
+    {
+        threads[i].join();
+    }
+}
+
+// as above, each thread counts into its own statistics, which are summed up
+template<class tracer> void trace_multithreaded(int threadcount, intersection_statistics& statistics, tracer trace)
+{
+    std::mutex statistics_mutex;
+
+    trace_multithreaded(threadcount, [&] {
+        thread_intersection_statistics() = intersection_statistics{};
+
+        trace();
+
+        std::lock_guard<std::mutex> guard(statistics_mutex);
+        statistics += thread_intersection_statistics();
+    });
+}
+
+#endif
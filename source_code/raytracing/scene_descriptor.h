@@ -6,6 +6,14 @@
 #include <geometry/types/vector.h>
 #include <geometry/types/varmesh.h>
 #include <geometry/types/bezier_surface.h>
+#include <geometry/algorithms/bezier_patch_bvh.h>
+#include <geometry/algorithms/quasi_interpolation.h>
+#include <geometry/algorithms/trim_region.h>
+#include <geometry/algorithms/triangle_bvh.h>
+#include <geometry/algorithms/tessellation.h>
+#include <geometry/algorithms/patch_bounds.h>
+#include <graphics/material.h>
+#include <graphics/screen_geometry.h>
 
 struct scene_descriptor
 {
@@ -24,33 +32,176 @@ struct varmesh_scene_descriptor : scene_descriptor
 	varmesh<4> mesh;
 	std::function<std::vector<int>(double, double)> mesh_color;
 	double epsilon;
+	intersection_solver solver = intersection_solver::clipping;
+	// material 0 is used instead of mesh_color, if present
+	material_table materials{};
 };
 
 struct facetted_surface_scene_descriptor : scene_descriptor
 {
-	std::vector<std::array<int, 3>>& facettes;
-	std::vector<v3>& points;
+	std::vector<std::array<int, 3>> facettes{};
+	std::vector<v3> points{};
+	// optional, per point
+	std::vector<v3> normals{};
+	std::vector<v2> uvs{};
+	// optional, per facette the index of the surface it approximates, which indexes the materials
+	std::vector<int> facette_surfaces{};
+	material_table materials{};
 };
 
 struct subdivided_mesh_scene_descriptor : varmesh_scene_descriptor
 {
-	subdivided_mesh_scene_descriptor(const varmesh_scene_descriptor &base) : varmesh_scene_descriptor(base)
+	subdivided_mesh_scene_descriptor(const varmesh_scene_descriptor &base) : varmesh_scene_descriptor(base), hierarchy(mesh)
 	{
-		meshes_hierarchy = mesh_subdivision_hierarchy(mesh, 6);
 	}
 
-	std::vector<varmesh<4>> meshes_hierarchy;
+	bezier_patch_bvh hierarchy;
+};
+
+// the triangles of the tessellated surfaces of a scene with a tree over them
+struct tessellated_scene_descriptor : facetted_surface_scene_descriptor
+{
+	tessellated_scene_descriptor(const facetted_surface_scene_descriptor &base) : facetted_surface_scene_descriptor(base), hierarchy(points, facettes)
+	{
+	}
+
+	// colours of the surfaces without material
+	std::vector<std::function<std::vector<int>(double, double)>> surface_colors;
+
+	triangle_bvh hierarchy;
 };
 
 struct scene_object {
 	varmesh<4> mesh;
 	std::function<std::vector<int>(double, double)> mesh_color;
+	double reflectivity = 0;
+	double transparency = 0;
+	double refractive_index = 1;
+	// roots outside the trim region aren't hits
+	trim_region trim{};
 };
 
 struct multiple_surfaces_scene_descriptor : scene_descriptor
 {
 	std::vector<scene_object> surfaces;
 	double epsilon;
+	int max_depth = 0;
+	intersection_solver solver = intersection_solver::clipping;
+	// indexed by the index of the surface; surfaces without material use their mesh_color
+	material_table materials{};
+};
+
+// rays are tested against the bounds of blocks of surfaces, before a surface is projected and clipped
+struct bounded_surfaces_scene_descriptor : multiple_surfaces_scene_descriptor
+{
+	bounded_surfaces_scene_descriptor(const multiple_surfaces_scene_descriptor &base) : multiple_surfaces_scene_descriptor(base)
+	{
+		std::vector<varmesh<4>> meshes;
+
+		for (const auto& surface : surfaces)
+		{
+			meshes.push_back(surface.mesh);
+		}
+
+		bounds = patch_bounds(meshes);
+	}
+
+	patch_bounds bounds;
+};
+
+// the screen in tiles, each with the surfaces whose projected control points overlap it; the camera rays of a tile
+// only test these, see bin_surfaces_to_tiles
+struct binned_surfaces_scene_descriptor : multiple_surfaces_scene_descriptor
+{
+	binned_surfaces_scene_descriptor(const multiple_surfaces_scene_descriptor &base) : multiple_surfaces_scene_descriptor(base)
+	{
+	}
+
+	std::vector<screen_tile> tiles;
+	std::vector<std::vector<int>> tile_surfaces;
+};
+
+// keeps a subdivision tree per surface and a tree over the surfaces, which are refitted, when a surface is updated
+struct accelerated_surfaces_scene_descriptor : multiple_surfaces_scene_descriptor
+{
+	accelerated_surfaces_scene_descriptor(const multiple_surfaces_scene_descriptor &base) : multiple_surfaces_scene_descriptor(base)
+	{
+		std::vector<bounding_box> surface_bounds;
+
+		for (const auto& surface : surfaces)
+		{
+			patch_hierarchies.emplace_back(surface.mesh, patch_hierarchy_depth);
+			surface_bounds.push_back(patch_hierarchies.back().bounds());
+		}
+
+		hierarchy = surface_bvh(surface_bounds);
+	}
+
+	// shallow, the patch trees only cull rays missing the convex hulls of the leaves
+	static const int patch_hierarchy_depth = 3;
+
+	std::vector<bezier_patch_bvh> patch_hierarchies;
+	surface_bvh hierarchy;
+};
+
+// a coarse tessellation of the surfaces; the surface of a leaf is within its error of the two triangles of the leaf,
+// so it lies in the box of the triangles padded by the error. A box hit seeds the exact solver with the parameter
+// window of its leaf
+struct hybrid_surfaces_scene_descriptor : multiple_surfaces_scene_descriptor
+{
+	hybrid_surfaces_scene_descriptor(const multiple_surfaces_scene_descriptor &base, int depth = coarse_tessellation_depth) : multiple_surfaces_scene_descriptor(base)
+	{
+		tessellation_settings settings;
+		settings.max_depth = depth;
+
+		for (int surface = 0; surface < surfaces.size(); surface++)
+		{
+			// untrimmed, leaves partially inside the trim loops are needed as well
+			auto tessellation = tessellate_patch(surfaces[surface].mesh, settings);
+
+			for (int leaf = 0; leaf < tessellation.leaf_errors.size(); leaf++)
+			{
+				leaf_surfaces.push_back(surface);
+				leaf_u.push_back(tessellation.leaf_u[leaf]);
+				leaf_v.push_back(tessellation.leaf_v[leaf]);
+
+				// the searched window is inside the convex hull of its control net
+				auto [u, v] = leaf_window(int(leaf_u.size()) - 1);
+
+				varmesh<4> window = surfaces[surface].mesh;
+				bezier_clip_surface(window, u, v);
+
+				leaf_bounds.push_back(bounding_box_of_mesh(window));
+			}
+		}
+
+		hierarchy = surface_bvh(leaf_bounds);
+	}
+
+	// the parameter window of the leaf widened by window_margin, in which its roots are searched
+	std::pair<v2, v2> leaf_window(int leaf) const
+	{
+		v2 u = leaf_u[leaf];
+		v2 v = leaf_v[leaf];
+
+		double u_margin = window_margin * (u[1] - u[0]);
+		double v_margin = window_margin * (v[1] - v[0]);
+
+		return std::make_pair(v2{ std::max(0., u[0] - u_margin), std::min(1., u[1] + u_margin) }, v2{ std::max(0., v[0] - v_margin), std::min(1., v[1] + v_margin) });
+	}
+
+	// at most 4^depth leaves per surface, flat surfaces stay one leaf
+	static const int coarse_tessellation_depth = 3;
+	// the windows of the leaves are widened by this fraction on every side for roots near their border
+	static constexpr double window_margin = 0.25;
+
+	std::vector<int> leaf_surfaces;
+	std::vector<v2> leaf_u;
+	std::vector<v2> leaf_v;
+	// bounds of the control nets of the leaf windows
+	std::vector<bounding_box> leaf_bounds;
+	// over the leaf bounds
+	surface_bvh hierarchy;
 };
 
 #endif // RAYRACING_SCENE_DESCRIPTOR_H_
\ No newline at end of file
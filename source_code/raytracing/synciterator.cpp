@@ -1,6 +1,6 @@
 #include "synciterator.h"
 
-synciterator::synciterator(int px, int py) : i{-1}, j{0}, x{px}, y{py}
+synciterator::synciterator(int px, int py, render_progress* progress) : i{-1}, j{0}, x{px}, y{py}, progress{progress}
 {
     
 }
@@ -8,6 +8,11 @@ synciterator::synciterator(int px, int py) : i{-1}, j{0}, x{px}, y{py}
 std::pair<int, int> synciterator::next()
 {
     std::lock_guard<std::mutex> guard(m);
+
+    if (nullptr != progress && progress->is_cancelled())
+    {
+        return std::make_pair(-1, -1);
+    }
     
     if (i >= x - 1 && j >= y - 1)
     {
@@ -24,3 +29,12 @@ std::pair<int, int> synciterator::next()
     
     return std::make_pair(i, j);
 }
+
+void synciterator::finish()
+{
+    // a cancelled worker may have cut its element short
+    if (nullptr != progress && !progress->is_cancelled())
+    {
+        progress->advance();
+    }
+}
@@ -3,13 +3,19 @@
 
 #include <mutex>
 
+#include <raytracing/render_progress.h>
+
 class synciterator {
 private:
     std::mutex m;
     int i, j, x, y;
+    render_progress* progress;
 public:
-    synciterator(int to_x, int to_y);
+    // progress, if given, counts the elements finished and ends the iteration, once it is cancelled
+    synciterator(int to_x, int to_y, render_progress* progress = nullptr);
     std::pair<int, int> next();
+    // the worker has completed an element taken with next
+    void finish();
 };
 
 #endif // !synciterator_h
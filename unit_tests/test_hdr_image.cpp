@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include <graphics/hdr_image.h>
+#include <file_io/file_io.h>
+
+TEST(HdrImage, test_samples_are_averaged)
+{
+	hdr_image image(2, 1);
+
+	image.add_sample(0, v3{ 0.2, 0.4, 1 });
+	image.add_sample(0, v3{ 0.4, 0.8, 3 });
+	image.add_sample(0, v3{ 1, 1, 1 }, 0);
+
+	EXPECT_NEAR(0.3, image.resolve(0)[0], 1E-6);
+	EXPECT_NEAR(0.6, image.resolve(0)[1], 1E-6);
+	EXPECT_NEAR(2, image.resolve(0)[2], 1E-6);
+	// no samples
+	EXPECT_EQ((v3{ 0, 0, 0 }), image.resolve(1));
+}
+
+TEST(HdrImage, test_tone_map)
+{
+	hdr_image image(3, 1);
+
+	image.add_sample(0, v3{ 0, 0.5, 1 });
+	image.add_sample(1, v3{ 2, -1, 0.25 });
+
+	EXPECT_EQ((std::vector<int>{ 0, 128, 255, 255, 0, 64, 0, 0, 0 }), tone_map(image));
+
+	EXPECT_EQ((std::vector<int>{ 0, 255, 255, 255, 0, 128, 0, 0, 0 }), tone_map(image, tone_mapping{ 2 }));
+
+	// c / (1 + c)
+	EXPECT_EQ((std::vector<int>{ 0, 85, 128, 170, 0, 51, 0, 0, 0 }), tone_map(image, tone_mapping{ 1, tone_operator::reinhard }));
+}
+
+TEST(HdrImage, test_pfm_round_trip)
+{
+	auto folder = std::filesystem::temp_directory_path();
+
+	hdr_image image(3, 2);
+
+	for (int i = 0; i < 6; i++)
+	{
+		image.add_sample(i, v3{ 0.1 * i, 1000. + i, -0.5 * i });
+	}
+
+	ASSERT_TRUE(serialize_as_pfm(folder / "test_pfm_colour.pfm", image));
+
+	auto loaded = load_pfm(folder / "test_pfm_colour.pfm");
+
+	ASSERT_TRUE(loaded.has_value());
+	EXPECT_EQ(3, loaded->width);
+	EXPECT_EQ(2, loaded->height);
+
+	for (int c = 0; c < 3; c++)
+	{
+		EXPECT_EQ(image.channels[c], loaded->channels[c]);
+	}
+
+	std::vector<float> depth{ 1, 2, std::numeric_limits<float>::infinity(), 4, 5, 6 };
+
+	ASSERT_TRUE(serialize_as_pfm(folder / "test_pfm_grey.pfm", 3, 2, depth));
+
+	loaded = load_pfm(folder / "test_pfm_grey.pfm");
+
+	ASSERT_TRUE(loaded.has_value());
+	EXPECT_EQ(depth, loaded->channels[0]);
+	EXPECT_EQ(depth, loaded->channels[2]);
+
+	EXPECT_FALSE(load_pfm(folder / "test_pfm_missing.pfm").has_value());
+}
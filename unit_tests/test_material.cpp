@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+
+#include <fstream>
+
+#include <graphics/material.h>
+#include <graphics/mipmapped_texture.h>
+#include <file_io/file_io.h>
+
+using ::testing::InitGoogleTest;
+using ::testing::Test;
+using ::testing::TestCase;
+using ::testing::TestEventListeners;
+using ::testing::TestInfo;
+using ::testing::TestPartResult;
+using ::testing::UnitTest;
+
+TEST(Material, test_checker)
+{
+	color even{ {255, 210, 80} };
+	color odd{ {210, 80, 255} };
+
+	EXPECT_EQ(even, sample_checker(even, odd, 10, 0, 0));
+	EXPECT_EQ(odd, sample_checker(even, odd, 10, 0.1, 0));
+	EXPECT_EQ(odd, sample_checker(even, odd, 10, 0.04, 0.12));
+	EXPECT_EQ(even, sample_checker(even, odd, 10, 0.16, 0.24));
+	// negative remainders count as even
+	EXPECT_EQ(even, sample_checker(even, odd, 10, -0.1, 0));
+}
+
+TEST(Material, test_bitmap_bilinear_filtering)
+{
+	bitmap_texture bitmap{ 2, 2, { color{ {0, 0, 0} }, color{ {100, 0, 0} }, color{ {0, 100, 0} }, color{ {100, 100, 200} } } };
+
+	// the texel centres
+	EXPECT_EQ((color{ {0, 0, 0} }), sample_bitmap(bitmap, 0.25, 0.25));
+	EXPECT_EQ((color{ {100, 100, 200} }), sample_bitmap(bitmap, 0.75, 0.75));
+
+	EXPECT_EQ((color{ {50, 50, 50} }), sample_bitmap(bitmap, 0.5, 0.5));
+	EXPECT_EQ((color{ {50, 0, 0} }), sample_bitmap(bitmap, 0.5, 0.25));
+
+	// clamped at the border
+	EXPECT_EQ((color{ {0, 0, 0} }), sample_bitmap(bitmap, 0, 0));
+	EXPECT_EQ((color{ {100, 100, 200} }), sample_bitmap(bitmap, 1, 1));
+}
+
+TEST(Material, test_material_table)
+{
+	material_table table;
+	table.bitmaps.push_back(bitmap_texture{ 1, 1, { color{ {1, 2, 3} } } });
+	table.materials.push_back(constant_material(color{ {7, 8, 9} }));
+	table.materials.push_back(checker_material(color{ {1, 1, 1} }, color{ {2, 2, 2} }));
+	table.materials.push_back(material{ material_kind::bitmap, color{}, color{}, 0, 0 });
+
+	EXPECT_EQ((color{ {7, 8, 9} }), table.sample(0, 0.3, 0.3));
+	EXPECT_EQ((color{ {2, 2, 2} }), table.sample(1, 0.1, 0));
+	EXPECT_EQ((color{ {1, 2, 3} }), table.sample(2, 0.3, 0.7));
+
+	EXPECT_TRUE(table.has_material(2));
+	EXPECT_FALSE(table.has_material(3));
+}
+
+bitmap_texture get_checker_bitmap(int size, int squares)
+{
+	bitmap_texture bitmap{ size, size, std::vector<color>(size * size) };
+
+	for (int y = 0; y < size; y++)
+	{
+		for (int x = 0; x < size; x++)
+		{
+			bool odd = (x * squares / size + y * squares / size) % 2;
+			bitmap.texels[y * size + x] = odd ? color{ {255, 255, 255} } : color{ {0, 0, 0} };
+		}
+	}
+
+	return bitmap;
+}
+
+TEST(Material, test_mipmapped_texture_levels)
+{
+	bitmap_texture bitmap{ 5, 3, std::vector<color>(15) };
+	for (int i = 0; i < 15; i++)
+	{
+		bitmap.texels[i] = color{ {i * 10, 255 - i * 10, 7} };
+	}
+
+	mipmapped_texture texture(bitmap);
+
+	ASSERT_EQ(4, texture.level_count());
+	EXPECT_EQ(3, texture.width(1));
+	EXPECT_EQ(2, texture.height(1));
+	EXPECT_EQ(1, texture.width(3));
+	EXPECT_EQ(1, texture.height(3));
+
+	// the tiled layout keeps every texel
+	for (int y = 0; y < 3; y++)
+	{
+		for (int x = 0; x < 5; x++)
+		{
+			EXPECT_EQ(bitmap.texels[y * 5 + x], texture.texel(0, x, y));
+		}
+	}
+
+	// box filter of the texels 0, 1, 5 and 6
+	EXPECT_EQ((color{ {30, 225, 7} }), texture.texel(1, 0, 0));
+}
+
+TEST(Material, test_mipmapped_texture_filtering)
+{
+	mipmapped_texture texture(get_checker_bitmap(64, 8));
+
+	EXPECT_EQ(7, texture.level_count());
+	EXPECT_EQ(0, texture.level_of_detail(1. / 128));
+	EXPECT_DOUBLE_EQ(2, texture.level_of_detail(4. / 64));
+
+	// the finest level is bilinear filtering of the bitmap
+	for (double u : { 0.1, 0.37, 0.5, 0.93 })
+	{
+		EXPECT_EQ(sample_bitmap(get_checker_bitmap(64, 8), u, 0.3), texture.sample(u, 0.3, 0));
+	}
+
+	// a pixel covering many squares sees their average
+	for (double u : { 0.1, 0.37, 0.5, 0.93 })
+	{
+		auto c = texture.sample(u, 0.3, 0.5);
+
+		EXPECT_NEAR(128, c[0], 1);
+	}
+}
+
+TEST(Material, test_load_ppm)
+{
+	auto folder = std::filesystem::temp_directory_path();
+
+	std::vector<int> pixel{ 1, 2, 3, 40, 50, 60, 255, 0, 128, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+
+	serialize_as_ppm(folder / "test_load_ppm_p3.ppm", 3, 2, pixel);
+
+	{
+		std::ofstream binary(folder / "test_load_ppm_p6.ppm", std::ofstream::binary | std::ofstream::trunc);
+		binary << "P6\n# comment\n3 2\n255\n";
+		for (int p : pixel)
+		{
+			binary.put(char(p));
+		}
+	}
+
+	for (auto name : { "test_load_ppm_p3.ppm", "test_load_ppm_p6.ppm" })
+	{
+		auto bitmap = load_ppm(folder / name);
+
+		ASSERT_TRUE(bitmap.has_value());
+		EXPECT_EQ(3, bitmap->width);
+		EXPECT_EQ(2, bitmap->height);
+
+		for (int i = 0; i < 6; i++)
+		{
+			EXPECT_EQ((color{ {pixel[3 * i], pixel[3 * i + 1], pixel[3 * i + 2]} }), bitmap->texels[i]);
+		}
+	}
+
+	EXPECT_FALSE(load_ppm(folder / "test_load_ppm_missing.ppm").has_value());
+
+	auto load_text = [&](const std::string& text) {
+		std::ofstream(folder / "test_load_ppm_text.ppm", std::ofstream::trunc) << text;
+		return load_ppm(folder / "test_load_ppm_text.ppm");
+	};
+
+	// values out of range are clamped
+	auto clamped = load_text("P3 1 1 100\n-5 150 50\n");
+	ASSERT_TRUE(clamped.has_value());
+	EXPECT_EQ((color{ {0, 255, 127} }), clamped->texels[0]);
+
+	EXPECT_FALSE(load_text("P3 1 1 255\n1 2x 3\n").has_value());
+	EXPECT_FALSE(load_text("P3 1 1 255\n1 two 3\n").has_value());
+	EXPECT_FALSE(load_text("P3 65536 65536 255\n1 2 3\n").has_value());
+}
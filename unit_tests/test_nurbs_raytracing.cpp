@@ -3,6 +3,12 @@
 #include <raytracing/nurbs_raytracing.h>
 #include <geometry/types/bezier_curve.h>
 #include <geometry/types/bezier_surface.h>
+#include <geometry/algorithms/surface_curvature.h>
+#include <geometry/algorithms/trim_region.h>
+#include <geometry/algorithms/tessellation.h>
+#include <geometry/algorithms/triangle_bvh.h>
+#include <geometry/algorithms/patch_bounds.h>
+#include <geometry/algorithms/scratch_arena.h>
 
 using ::testing::InitGoogleTest;
 using ::testing::Test;
@@ -173,6 +179,115 @@ TEST(Nurbs, test_vertical_plane_of_ray)
     EXPECT_EQ(-1, add_dimension(r) * vertical_plane_of_ray(p, q - p));
 }
 
+TEST(Nurbs, test_planes_of_ray)
+{
+    v3 origin{{1, 2, 3}};
+
+    for (auto dir : {v3{{0, 0, 1}}, v3{{1, 0, 0}}, v3{{0, -1, 0}}, v3{{1, 2, 0.5}}, v3{{-3, 1, 1}}})
+    {
+        auto [vertical_plane, horizontal_plane] = planes_of_ray(origin, dir);
+
+        for (double t : {0., 1., 10.})
+        {
+            v4 point = add_dimension(origin + t * dir);
+
+            EXPECT_NEAR(0, point * vertical_plane, 1e-12);
+            EXPECT_NEAR(0, point * horizontal_plane, 1e-12);
+        }
+
+        v3 n1{{vertical_plane[0], vertical_plane[1], vertical_plane[2]}};
+        v3 n2{{horizontal_plane[0], horizontal_plane[1], horizontal_plane[2]}};
+
+        EXPECT_LT(0.1, length(cross_product(n1, n2)));
+    }
+}
+
+TEST(Nurbs, test_reflect_and_refract)
+{
+    v3 normale{{0, 0, -2}};
+
+    expect_near(v3{{1, 0, -1}}, reflect(v3{{1, 0, 1}}, normale));
+
+    auto straight = refract(v3{{0, 0, 1}}, normale, 1.5);
+    ASSERT_TRUE(straight.has_value());
+    expect_near(v3{{0, 0, 1}}, *straight);
+
+    auto bent = refract(normalize(v3{{1, 0, 1}}), normale, 1.5);
+    ASSERT_TRUE(bent.has_value());
+    EXPECT_NEAR(std::sin(std::numbers::pi / 4) / 1.5, (*bent)[0], 1e-12);
+
+    // leaving the denser medium at a flat angle
+    EXPECT_FALSE(refract(normalize(v3{{3, 0, -1}}), normale, 1.5).has_value());
+}
+
+TEST(Nurbs, test_curvature_of_cylinder_patch)
+{
+    // quarter of a cylinder with radius 2 as rational quadratic x linear patch
+    double w = std::sqrt(0.5);
+
+    varmesh<4> m(2, 3);
+    m[0][0] = v4{{2, 0, 0, 1}};
+    m[0][1] = v4{{2 * w, 2 * w, 0, w}};
+    m[0][2] = v4{{0, 2, 0, 1}};
+    m[1][0] = v4{{2, 0, 3, 1}};
+    m[1][1] = v4{{2 * w, 2 * w, 3 * w, w}};
+    m[1][2] = v4{{0, 2, 3, 1}};
+
+    for (double u : {0., 0.3, 0.5, 1.})
+    {
+        for (double v : {0., 0.6})
+        {
+            auto differentials = evaluate_rational_bezier_surface_differentials(m, u, v);
+
+            EXPECT_NEAR(2, length(v2{{differentials.point[0], differentials.point[1]}}), 1e-12);
+
+            if (0 < u && u < 1)
+            {
+                double h = 1e-6;
+                auto du = (1. / (2 * h)) * (remove_dimension(evaluate_bezier_surface(m, u + h, v)) - remove_dimension(evaluate_bezier_surface(m, u - h, v)));
+                expect_near(differentials.du, du);
+            }
+
+            auto curvature = curvature_of_surface(differentials);
+
+            EXPECT_NEAR(0, curvature.gaussian, 1e-12);
+            EXPECT_NEAR(0.25, std::abs(curvature.mean), 1e-12);
+        }
+    }
+}
+
+TEST(Nurbs, test_curvature_of_sphere_patch)
+{
+    // octant of a sphere with radius 8 as surface of revolution of a quarter circle
+    double w = std::sqrt(0.5);
+    std::vector<v3> circle{v3{{1, 0, 1}}, v3{{1, 1, w}}, v3{{0, 1, 1}}};
+
+    varmesh<4> m(3, 3);
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            double weight = circle[i][2] * circle[j][2];
+            m[i][j] = v4{{8 * weight * circle[i][0] * circle[j][0], 8 * weight * circle[i][0] * circle[j][1], 8 * weight * circle[i][1], weight}};
+        }
+    }
+
+    for (double u = 0.1; u < 1; u += 0.2)
+    {
+        for (double v = 0.1; v < 0.95; v += 0.2)
+        {
+            auto differentials = evaluate_rational_bezier_surface_differentials(m, u, v);
+
+            EXPECT_NEAR(8, length(differentials.point), 1e-12);
+
+            auto curvature = curvature_of_surface(differentials);
+
+            EXPECT_NEAR(1. / 64, curvature.gaussian, 1e-12);
+            EXPECT_NEAR(1. / 8, std::abs(curvature.mean), 1e-12);
+        }
+    }
+}
+
 TEST(Nurbs, test_quasi_get_intersections)
 {
     auto points = std::vector<v<1>>{{
@@ -569,3 +684,629 @@ TEST(Nurbs, test_raytrace_scene_multithreaded_empty)
     EXPECT_EQ(512 * 512, count_calls);
 }
 
+
+
+TEST(Nurbs, test_morton_code)
+{
+    EXPECT_EQ(0u, morton_code(0, 0, 0));
+    EXPECT_EQ(1u, morton_code(1, 0, 0));
+    EXPECT_EQ(2u, morton_code(0, 1, 0));
+    EXPECT_EQ(4u, morton_code(0, 0, 1));
+    EXPECT_EQ(0x3fffffffu, morton_code(1023, 1023, 1023));
+}
+
+TEST(Nurbs, test_ray_queue_bins)
+{
+    ray_queue queue;
+
+    for (int i = 0; i < 64; i++)
+    {
+        v3 origin{{double(i % 4), double((i / 4) % 4), double(i / 16)}};
+        v3 direction{{i % 3 == 0 ? -1. : 1., i % 5 == 0 ? -1. : 1., 1}};
+        queue.push(traced_ray{origin, direction, i, 1});
+    }
+
+    auto bins = queue.bin_rays();
+
+    ASSERT_EQ(64, queue.size());
+    EXPECT_EQ(0, bins.front().begin);
+    EXPECT_EQ(64, bins.back().end);
+
+    std::vector<bool> seen(64, false);
+
+    for (int b = 0; b < bins.size(); b++)
+    {
+        if (0 < b)
+        {
+            EXPECT_EQ(bins[b - 1].end, bins[b].begin);
+            EXPECT_TRUE(bins[b - 1].octant < bins[b].octant || (bins[b - 1].octant == bins[b].octant && bins[b - 1].cell < bins[b].cell));
+        }
+
+        for (size_t i = bins[b].begin; i < bins[b].end; i++)
+        {
+            const auto& ray = queue.rays()[i];
+            EXPECT_EQ(bins[b].octant, direction_octant(ray.direction));
+            seen[ray.pixel] = true;
+        }
+    }
+
+    EXPECT_EQ(std::vector<bool>(64, true), seen);
+}
+TEST(Nurbs, test_patch_bvh_is_adaptive)
+{
+    varmesh<4> plane(2, 2);
+    plane[0][0] = v4{{-1, -1, 2, 1}};
+    plane[0][1] = v4{{1, -1, 2, 1}};
+    plane[1][0] = v4{{-1, 1, 2, 1}};
+    plane[1][1] = v4{{1, 1, 2, 1}};
+
+    bezier_patch_bvh flat(plane);
+
+    EXPECT_EQ(1, flat.leaf_count());
+    EXPECT_EQ(1, flat.node_count());
+
+    varmesh<4> twisted(2, 2);
+    twisted[0][0] = v4{{-2, 0, 1, 1}};
+    twisted[0][1] = v4{{2, 0, 1, 1}};
+    twisted[1][0] = v4{{0, -2, 2, 1}};
+    twisted[1][1] = v4{{0, 2, 2, 1}};
+
+    bezier_patch_bvh bvh(twisted, 3);
+
+    EXPECT_EQ(64, bvh.leaf_count());
+    EXPECT_EQ(1 + 4 + 16 + 64, bvh.node_count());
+}
+
+TEST(Nurbs, test_patch_bvh_traversal_and_refit)
+{
+    varmesh<4> twisted(2, 2);
+    twisted[0][0] = v4{{-2, 0, 1, 1}};
+    twisted[0][1] = v4{{2, 0, 1, 1}};
+    twisted[1][0] = v4{{0, -2, 2, 1}};
+    twisted[1][1] = v4{{0, 2, 2, 1}};
+
+    bezier_patch_bvh bvh(twisted, 4);
+
+    v3 origin{{0, 0, -5}};
+    v3 ray{{0.1, 0.05, 1}};
+
+    std::vector<int> expected;
+    std::vector<v2> projection_coordinates;
+    for (int i = 0; i < bvh.leaf_count(); i++)
+    {
+        if (intersects_convex_hull(horizontal_plane_of_ray(origin, ray), vertical_plane_of_ray(origin, ray), bvh.leaf(i).mesh, projection_coordinates))
+        {
+            expected.push_back(i);
+        }
+    }
+
+    std::vector<int> leaves;
+    bvh.intersected_leaves(origin, ray, leaves, projection_coordinates);
+    ASSERT_FALSE(leaves.empty());
+
+    double previous_entry = -std::numeric_limits<double>::max();
+    for (auto leaf : leaves)
+    {
+        double entry;
+        EXPECT_TRUE(line_intersects_bounding_box(origin, ray, bounding_box_of_mesh(bvh.leaf(leaf).mesh), entry));
+        EXPECT_LE(previous_entry, entry + 1E-9);
+        previous_entry = entry;
+    }
+
+    std::sort(leaves.begin(), leaves.end());
+    EXPECT_EQ(expected, leaves);
+
+    for (int i = 0; i < 2; i++)
+    {
+        for (int j = 0; j < 2; j++)
+        {
+            twisted[i][j][2] += 10;
+        }
+    }
+
+    bvh.refit(twisted);
+
+    EXPECT_EQ(256, bvh.leaf_count());
+    EXPECT_NEAR(11, bvh.bounds().lower[2], 1E-6);
+    EXPECT_NEAR(12, bvh.bounds().upper[2], 1E-6);
+    expect_near(v3{{-2, 0, 11}}, remove_dimension(evaluate_bezier_surface(bvh.leaf(0).mesh, 0, 0)));
+}
+
+TEST(Nurbs, test_surface_bvh_refit)
+{
+    std::vector<bounding_box> bounds;
+    for (int i = 0; i < 5; i++)
+    {
+        bounds.push_back(bounding_box{v3{{double(i), 0, 10. + i}}, v3{{i + 0.5, 0.5, 10.5 + i}}});
+    }
+
+    surface_bvh bvh(bounds);
+
+    EXPECT_EQ(9, bvh.node_count());
+
+    v3 origin{{0.25, 0.25, 0}};
+    v3 ray{{0, 0, 1}};
+
+    std::vector<std::pair<double, int>> surfaces, stack;
+
+    bvh.intersected_surfaces(origin, ray, surfaces, stack);
+    ASSERT_EQ(1, surfaces.size());
+    EXPECT_EQ(0, surfaces[0].second);
+    EXPECT_NEAR(10, surfaces[0].first, 1E-9);
+
+    // move surface 3 in front of surface 0
+    bvh.refit(3, bounding_box{v3{{0, 0, 5}}, v3{{0.5, 0.5, 5.5}}});
+
+    bvh.intersected_surfaces(origin, ray, surfaces, stack);
+    ASSERT_EQ(2, surfaces.size());
+    EXPECT_EQ(3, surfaces[0].second);
+    EXPECT_EQ(0, surfaces[1].second);
+
+    bvh.intersected_surfaces(v3{{0.25, 0.25, 20}}, ray, surfaces, stack);
+    EXPECT_TRUE(surfaces.empty());
+    EXPECT_LE(bvh.node(0).bounds.lower[2], 5);
+}
+
+TEST(Nurbs, test_hybrid_solver_matches_clipping)
+{
+    varmesh<4> m(3, 3);
+    m[0][0] = v4{{-1.5, 1.5, 1, 1}};
+    m[0][1] = v4{{0, 0, 5, 5}};
+    m[0][2] = v4{{1.5, -0.5, 1, 1}};
+    m[1][0] = v4{{-1, 0.5, 2, 1}};
+    m[1][1] = v4{{0, -0.5, 2, 1}};
+    m[1][2] = v4{{1, 0.5, 2, 1}};
+    m[2][0] = v4{{-1, -3, 3, 1}};
+    m[2][1] = v4{{0, -2, 15, 5}};
+    m[2][2] = v4{{1, -1, 3, 1}};
+
+    v3 origin{{0, 0, -5}};
+
+    intersection_statistics& statistics = thread_intersection_statistics();
+
+    for (int i = 0; i < 8; i++)
+    {
+        v3 ray = remove_dimension(evaluate_bezier_surface(m, 0.2 + 0.08 * i, 0.3 + 0.05 * i)) - origin;
+
+        statistics = intersection_statistics{};
+        auto clipping_roots = get_intersections_quasi(origin, ray, m, 1E-8, intersection_solver::clipping);
+        auto clipping_steps = statistics.clipping_steps;
+
+        statistics = intersection_statistics{};
+        auto hybrid_roots = get_intersections_quasi(origin, ray, m, 1E-8, intersection_solver::hybrid);
+
+        ASSERT_FALSE(clipping_roots.empty());
+        ASSERT_FALSE(hybrid_roots.empty());
+
+        for (const auto& root : hybrid_roots)
+        {
+            expect_near(remove_dimension(evaluate_bezier_surface(m, clipping_roots[0][0], clipping_roots[0][1])), remove_dimension(evaluate_bezier_surface(m, root[0], root[1])));
+        }
+
+        EXPECT_LT(statistics.clipping_steps, clipping_steps);
+        EXPECT_LE(1, statistics.newton_roots);
+    }
+}
+
+TEST(Nurbs, test_float_first_solver_matches_clipping)
+{
+    varmesh<4> m(3, 3);
+    m[0][0] = v4{{-1.5, 1.5, 1, 1}};
+    m[0][1] = v4{{0, 0, 5, 5}};
+    m[0][2] = v4{{1.5, -0.5, 1, 1}};
+    m[1][0] = v4{{-1, 0.5, 2, 1}};
+    m[1][1] = v4{{0, -0.5, 2, 1}};
+    m[1][2] = v4{{1, 0.5, 2, 1}};
+    m[2][0] = v4{{-1, -3, 3, 1}};
+    m[2][1] = v4{{0, -2, 15, 5}};
+    m[2][2] = v4{{1, -1, 3, 1}};
+
+    v3 origin{{0, 0, -5}};
+
+    intersection_statistics& statistics = thread_intersection_statistics();
+    statistics = intersection_statistics{};
+
+    for (int i = 0; i < 8; i++)
+    {
+        v3 ray = remove_dimension(evaluate_bezier_surface(m, 0.2 + 0.08 * i, 0.3 + 0.05 * i)) - origin;
+
+        auto clipping_roots = get_intersections_quasi(origin, ray, m, 1E-8, intersection_solver::clipping);
+        auto float_roots = get_intersections_quasi(origin, ray, m, 1E-8, intersection_solver::float_first);
+
+        ASSERT_FALSE(clipping_roots.empty());
+        ASSERT_FALSE(float_roots.empty());
+
+        for (const auto& root : float_roots)
+        {
+            EXPECT_NEAR(0, length(remove_dimension(evaluate_bezier_surface(m, clipping_roots[0][0], clipping_roots[0][1])) - remove_dimension(evaluate_bezier_surface(m, root[0], root[1]))), 1E-3);
+        }
+    }
+
+    EXPECT_EQ(8, statistics.float_solves);
+    EXPECT_GT(8, statistics.double_resolves);
+
+    // a ray grazing the silhouette of a sphere like patch is near tangent at its root
+    varmesh<2> tangent(3, 3);
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            tangent[i][j] = v2{{(j - 1) * 1., (i - 1) * (i - 1) * 1. - 1E-6}};
+        }
+    }
+
+    EXPECT_TRUE(are_float_roots_ambiguous(tangent, std::vector<v2>{ v2{{0.5, 0.5}} }, 1E-4));
+    // two distinct roots closer than float_close_roots_distance
+    EXPECT_TRUE(are_float_roots_ambiguous(tangent, std::vector<v2>{ v2{{0.3, 0.1}}, v2{{0.305, 0.1}} }, 1E-4));
+    // one root found in two neighbouring windows
+    EXPECT_FALSE(are_float_roots_ambiguous(tangent, std::vector<v2>{ v2{{0.3, 0.1}}, v2{{0.3001, 0.1}} }, 1E-4));
+}
+
+TEST(Nurbs, test_primary_ray_footprint)
+{
+    // a square of edge length 2 facing the camera in distance 5
+    varmesh<4> m(2, 2);
+    m[0][0] = v4{ {-1, -1, 0, 1} };
+    m[0][1] = v4{ {1, -1, 0, 1} };
+    m[1][0] = v4{ {-1, 1, 0, 1} };
+    m[1][1] = v4{ {1, 1, 0, 1} };
+
+    scene_descriptor scene{ 512, 512, v3{ {0, 0, -5} }, 0, 0, 0, 30, v3{ {0, 0, -5} } };
+
+    double pixel_size = 5 * 2 * std::tan(std::numbers::pi * 0.5 * 30 / 180) / 512;
+
+    EXPECT_NEAR(pixel_size / 2, primary_ray_footprint(scene, m, v3{ {0, 0, 5} }, v2{ {0.5, 0.5} }), 1E-5);
+
+    // the same square with doubled weights on one side is the same plane with a different parametrization
+    m[0][1] = 2 * m[0][1];
+    m[1][1] = 2 * m[1][1];
+
+    EXPECT_NEAR(pixel_size / 2, primary_ray_footprint(scene, m, v3{ {0, 0, 5} }, v2{ {0.5, 0.5} }), 1E-3);
+
+    // twice as far away, the pixel covers twice as much of the square
+    for (int i = 0; i < 2; i++)
+    {
+        for (int j = 0; j < 2; j++)
+        {
+            m[i][j] = v4{ {m[i][j][0] / m[i][j][3], m[i][j][1] / m[i][j][3], 5, 1} };
+        }
+    }
+
+    EXPECT_NEAR(pixel_size, primary_ray_footprint(scene, m, v3{ {0, 0, 10} }, v2{ {0.5, 0.5} }), 1E-5);
+}
+
+TEST(Nurbs, test_trim_region_grid_matches_exact_test)
+{
+    std::vector<v2> outer{ v2{ {0.1, 0.1} }, v2{ {0.9, 0.1} }, v2{ {0.9, 0.9} }, v2{ {0.1, 0.9} } };
+
+    // circular hole of radius 0.2 from four cubic quarter circles
+    double k = 0.2 * 0.5523;
+    v2 c{ {0.5, 0.5} };
+    std::vector<std::vector<v2>> quarters{
+        { c + v2{ {0.2, 0} }, c + v2{ {0.2, k} }, c + v2{ {k, 0.2} }, c + v2{ {0, 0.2} } },
+        { c + v2{ {0, 0.2} }, c + v2{ {-k, 0.2} }, c + v2{ {-0.2, k} }, c + v2{ {-0.2, 0} } },
+        { c + v2{ {-0.2, 0} }, c + v2{ {-0.2, -k} }, c + v2{ {-k, -0.2} }, c + v2{ {0, -0.2} } },
+        { c + v2{ {0, -0.2} }, c + v2{ {k, -0.2} }, c + v2{ {0.2, -k} }, c + v2{ {0.2, 0} } }
+    };
+
+    trim_region trim({ outer, polyline_of_bezier_loop(quarters) });
+
+    ASSERT_TRUE(trim.is_trimmed());
+    EXPECT_LT(trim.boundary_cell_fraction(), 0.2);
+
+    EXPECT_TRUE(trim.contains(v2{ {0.2, 0.2} }));
+    EXPECT_FALSE(trim.contains(v2{ {0.5, 0.5} }));
+    EXPECT_FALSE(trim.contains(v2{ {0.05, 0.5} }));
+
+    for (int i = 0; i <= 200; i++)
+    {
+        for (int j = 0; j <= 200; j++)
+        {
+            v2 uv{ {i / 200., j / 200.} };
+
+            EXPECT_EQ(trim.contains_exactly(uv), trim.contains(uv));
+        }
+    }
+
+    EXPECT_TRUE(trim_region().contains(v2{ {0.5, 0.5} }));
+}
+
+TEST(Nurbs, test_tessellation_error_bound)
+{
+    // cubic height field over [0, 3]^2
+    varmesh<4> m(4, 4);
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            m.element(i, j) = v4{ {double(j), double(i), ((i + j) % 2) * 1.5 - 0.5 * i, 1} };
+        }
+    }
+
+    tessellation_settings settings;
+    settings.chordal_tolerance = 1E-2;
+
+    auto tessellation = tessellate_patch(m, settings);
+
+    ASSERT_FALSE(tessellation.facettes.empty());
+    ASSERT_EQ(tessellation.points.size(), tessellation.uvs.size());
+    ASSERT_EQ(tessellation.points.size(), tessellation.normals.size());
+
+    // every surface point is close to the point of the triangle with the same uv
+    double max_error = 0;
+    for (const auto& f : tessellation.facettes)
+    {
+        const v2& uv0 = tessellation.uvs[f[0]];
+        v2 e1 = tessellation.uvs[f[1]] - uv0;
+        v2 e2 = tessellation.uvs[f[2]] - uv0;
+
+        for (double b1 : { 0.2, 0.5 })
+        {
+            for (double b2 : { 0.1, 0.3 })
+            {
+                v2 uv = uv0 + b1 * e1 + b2 * e2;
+                v3 on_triangle = (1 - b1 - b2) * tessellation.points[f[0]] + b1 * tessellation.points[f[1]] + b2 * tessellation.points[f[2]];
+
+                max_error = std::max(max_error, length(remove_dimension(evaluate_bezier_surface(m, uv[0], uv[1])) - on_triangle));
+            }
+        }
+
+        v3 facette_normale = cross_product(tessellation.points[f[1]] - tessellation.points[f[0]], tessellation.points[f[2]] - tessellation.points[f[0]]);
+        EXPECT_LT(0, facette_normale * tessellation.normals[f[0]]);
+    }
+
+    EXPECT_LE(max_error, settings.chordal_tolerance);
+
+    // a coarser tolerance needs fewer triangles
+    settings.chordal_tolerance = 1E-1;
+    EXPECT_LT(tessellate_patch(m, settings).facettes.size(), tessellation.facettes.size());
+
+    // a bilinear patch with evenly spaced control points, which is flat, is exactly two triangles
+    varmesh<3> flat(3, 3);
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            flat.element(i, j) = v3{ {double(j), 2. * i, 1} };
+        }
+    }
+    EXPECT_NEAR(0, tessellation_error(flat), 1E-12);
+}
+
+TEST(Nurbs, test_triangle_bvh_matches_all_triangles)
+{
+    std::vector<v3> points;
+    std::vector<std::array<int, 3>> facettes;
+
+    // a grid of triangles on a wavy surface
+    for (int i = 0; i <= 20; i++)
+    {
+        for (int j = 0; j <= 20; j++)
+        {
+            points.push_back(v3{ {i / 10. - 1, j / 10. - 1, 5 + 0.3 * std::sin(i) * std::cos(j)} });
+        }
+    }
+    for (int i = 0; i < 20; i++)
+    {
+        for (int j = 0; j < 20; j++)
+        {
+            int p = 21 * i + j;
+            facettes.push_back({ p, p + 21, p + 22 });
+            facettes.push_back({ p, p + 22, p + 1 });
+        }
+    }
+
+    triangle_bvh bvh(points, facettes);
+
+    EXPECT_LT(facettes.size() / triangle_bvh::leaf_size, bvh.node_count());
+
+    for (int x = -12; x <= 12; x++)
+    {
+        for (int y = -12; y <= 12; y++)
+        {
+            v3 origin{ {0, 0, 0} };
+            v3 ray = normalize(v3{ {x / 70., y / 70., 1} });
+
+            std::optional<triangle_hit> expected;
+            for (int i = 0; i < facettes.size(); i++)
+            {
+                auto hit = intersect_triangle(origin, ray, points[facettes[i][0]], points[facettes[i][1]], points[facettes[i][2]]);
+                if (hit.has_value() && (!expected.has_value() || hit->t < expected->t))
+                {
+                    expected = hit;
+                    expected->facette = i;
+                }
+            }
+
+            auto hit = bvh.closest_hit(origin, ray, points, facettes);
+
+            ASSERT_EQ(expected.has_value(), hit.has_value());
+            if (hit.has_value())
+            {
+                // rays through a shared edge may report either facette
+                EXPECT_NEAR(expected->t, hit->t, 1E-12);
+
+                const auto& f = facettes[hit->facette];
+                auto own_hit = intersect_triangle(origin, ray, points[f[0]], points[f[1]], points[f[2]]);
+                ASSERT_TRUE(own_hit.has_value());
+                EXPECT_NEAR(own_hit->t, hit->t, 1E-12);
+            }
+        }
+    }
+
+    // nothing behind the origin
+    EXPECT_FALSE(bvh.closest_hit(v3{ {0, 0, 10} }, v3{ {0, 0, 1} }, points, facettes).has_value());
+}
+
+TEST(Nurbs, test_patch_bounds_reject_distant_patches)
+{
+    // a row of 11 flat unit patches along e1 at z = 10, more than one block
+    std::vector<varmesh<4>> meshes;
+    for (int i = 0; i < 11; i++)
+    {
+        varmesh<4> m(2, 2);
+        m.element(0, 0) = v4{ {3. * i, 0, 10, 1} };
+        m.element(0, 1) = v4{ {3. * i + 1, 0, 10, 1} };
+        m.element(1, 0) = v4{ {3. * i, 1, 10, 1} };
+        m.element(1, 1) = v4{ {3. * i + 1, 1, 10, 1} };
+        meshes.push_back(m);
+    }
+
+    patch_bounds bounds(meshes);
+    EXPECT_EQ(11, bounds.size());
+
+    intersection_statistics& statistics = thread_intersection_statistics();
+    statistics = intersection_statistics{};
+
+    std::vector<int> candidates;
+    bounds.candidates(v3{ {27.5, 0.5, 0} }, v3{ {0, 0, 1} }, candidates);
+
+    EXPECT_EQ(std::vector<int>{ 9 }, candidates);
+    EXPECT_EQ(11, statistics.bounds_tests);
+    EXPECT_EQ(10, statistics.box_rejections + statistics.sphere_rejections);
+
+    // behind the origin
+    candidates.clear();
+    bounds.candidates(v3{ {27.5, 0.5, 20} }, v3{ {0, 0, 1} }, candidates);
+    EXPECT_TRUE(candidates.empty());
+
+    // a diamond leaves the corners of its box outside of its sphere
+    varmesh<4> diamond(2, 2);
+    diamond.element(0, 0) = v4{ {0.5, 0, 10, 1} };
+    diamond.element(0, 1) = v4{ {1, 0.5, 10, 1} };
+    diamond.element(1, 0) = v4{ {0, 0.5, 10, 1} };
+    diamond.element(1, 1) = v4{ {0.5, 1, 10, 1} };
+
+    candidates.clear();
+    statistics = intersection_statistics{};
+    patch_bounds({ diamond }).candidates(v3{ {0.05, 0.05, 0} }, v3{ {0, 0, 1} }, candidates);
+    EXPECT_TRUE(candidates.empty());
+    EXPECT_EQ(1, statistics.sphere_rejections);
+
+    bounds.update(3, meshes[9]);
+    candidates.clear();
+    bounds.candidates(v3{ {27.5, 0.5, 0} }, v3{ {0, 0, 1} }, candidates);
+    EXPECT_EQ((std::vector<int>{ 3, 9 }), candidates);
+}
+
+TEST(Nurbs, test_scratch_arena_rewinds_and_grows)
+{
+    scratch_arena arena(1024);
+
+    {
+        varmesh<2> mesh(4, 4, arena.resource());
+        EXPECT_EQ(0, arena.overflow());
+
+        // beyond the buffer
+        varmesh<2> large(32, 32, arena.resource());
+        large.element(31, 31) = v2{ {1, 2} };
+        EXPECT_LT(0, arena.overflow());
+
+        // a copy into the arena keeps the points
+        varmesh<2> copy(large, arena.resource());
+        expect_near(v2{ {1, 2} }, copy.element(31, 31));
+    }
+
+    arena.rewind();
+
+    // the buffer grew by the overflow, the same allocations stay in it
+    EXPECT_EQ(0, arena.overflow());
+    EXPECT_LT(1024, arena.capacity());
+
+    {
+        varmesh<2> mesh(4, 4, arena.resource());
+        varmesh<2> large(32, 32, arena.resource());
+        varmesh<2> copy(large, arena.resource());
+        EXPECT_EQ(0, arena.overflow());
+    }
+
+    // nested scopes share the arena of the thread, only the outermost rewinds it
+    {
+        scratch_scope outer;
+
+        varmesh<2> mesh(4, 4, outer.resource());
+        mesh.element(0, 0) = v2{ {1, 2} };
+        mesh.element(3, 3) = v2{ {3, 4} };
+
+        {
+            scratch_scope inner;
+            varmesh<2> other(4, 4, inner.resource());
+            other.element(0, 0) = v2{ {5, 6} };
+        }
+
+        // if the inner scope had rewound the arena, next would be allocated over mesh
+        varmesh<2> next(4, 4, outer.resource());
+        next.element(0, 0) = v2{ {7, 8} };
+
+        expect_near(v2{ {1, 2} }, mesh.element(0, 0));
+        expect_near(v2{ {3, 4} }, mesh.element(3, 3));
+    }
+}
+
+TEST(Nurbs, test_clipping_steps_stay_in_scratch_arena)
+{
+    varmesh<4> m(4, 4);
+
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            m.element(i, j) = v4{ {double(j), double(i), 5 + 0.3 * ((i + j) % 2), 1} };
+        }
+    }
+
+    v3 origin{ {1.2, 1.7, 0} };
+    v3 ray{ {0.1, -0.05, 1} };
+
+    for (auto solver : { intersection_solver::clipping, intersection_solver::hybrid, intersection_solver::float_first })
+    {
+        auto roots = get_intersections_quasi(origin, ray, m, 1E-8, solver);
+        ASSERT_EQ(1, roots.size());
+
+        // the arena has grown to the high water mark of the first ray, the second doesn't take more; meshes and
+        // curves, that still went to the default resource, would throw
+        size_t capacity = thread_scratch_arena().capacity();
+
+        auto previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+        std::vector<v2> again;
+        EXPECT_NO_THROW(again = get_intersections_quasi(origin, ray, m, 1E-8, solver));
+        std::pmr::set_default_resource(previous);
+
+        EXPECT_EQ(roots, again);
+        EXPECT_EQ(capacity, thread_scratch_arena().capacity());
+    }
+}
+
+TEST(Nurbs, test_progress_counts_finished_units)
+{
+    render_progress progress(3);
+    synciterator iter(1, 3, &progress);
+
+    // the unit handed out is only finished, when its worker marks it
+    EXPECT_EQ(std::make_pair(0, 0), iter.next());
+    EXPECT_EQ(0, progress.completed_units());
+    EXPECT_FALSE(progress.remaining_seconds().has_value());
+
+    iter.finish();
+    EXPECT_EQ(1, progress.completed_units());
+
+    EXPECT_EQ(std::make_pair(0, 1), iter.next());
+    iter.finish();
+    EXPECT_EQ(std::make_pair(0, 2), iter.next());
+    iter.finish();
+    EXPECT_EQ(std::make_pair(-1, -1), iter.next());
+    EXPECT_EQ(3, progress.completed_units());
+    EXPECT_EQ(1, progress.fraction());
+    EXPECT_EQ(0, progress.remaining_seconds());
+
+    // units cut short by a cancellation aren't finished
+    render_progress cancelled(2);
+    synciterator cancelled_iter(1, 2, &cancelled);
+
+    EXPECT_EQ(std::make_pair(0, 0), cancelled_iter.next());
+    cancelled.cancel();
+    cancelled_iter.finish();
+
+    EXPECT_EQ(0, cancelled.completed_units());
+    EXPECT_EQ(std::make_pair(-1, -1), cancelled_iter.next());
+}
@@ -0,0 +1,110 @@
+#include <sstream>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <geometry/algorithms/render_trace.h>
+
+#ifdef RENDER_TRACING
+
+TEST(RenderTrace, test_spans_of_threads_as_chrome_trace)
+{
+	clear_trace_events();
+
+	auto trace = [] {
+		RENDER_TRACE_SPAN("tile");
+		RENDER_TRACE_DETAIL_SPAN("clipping");
+	};
+
+	std::thread first(trace);
+	std::thread second(trace);
+
+	first.join();
+	second.join();
+
+	std::ostringstream json;
+	write_chrome_trace(json);
+
+	auto s = json.str();
+
+	EXPECT_EQ(0, s.find("{ \"traceEvents\": ["));
+	EXPECT_NE(std::string::npos, s.find("\"name\": \"tile\", \"ph\": \"X\""));
+	EXPECT_NE(std::string::npos, s.find("\"name\": \"clipping\", \"ph\": \"X\""));
+	EXPECT_NE(s.find("\"name\": \"tile\""), s.rfind("\"name\": \"tile\""));
+
+	// the buffers of the finished threads are dropped
+	clear_trace_events();
+
+	json.str("");
+	write_chrome_trace(json);
+
+	EXPECT_EQ(std::string::npos, json.str().find("\"tile\""));
+}
+
+TEST(RenderTrace, test_ring_keeps_the_last_events)
+{
+	trace_ring_buffer buffer(8);
+
+	for (size_t i = 0; i < buffer.capacity + 3; i++)
+	{
+		buffer.record("span", i, i + 1);
+	}
+
+	EXPECT_EQ(buffer.capacity + 3, buffer.count);
+	EXPECT_EQ(buffer.capacity, buffer.events[0].begin_ns);
+	EXPECT_EQ(3, buffer.events[3].begin_ns);
+}
+
+TEST(RenderTrace, test_later_threads_reuse_finished_buffers)
+{
+	clear_trace_events();
+
+	for (int pass = 0; pass < 3; pass++)
+	{
+		std::thread render([] { RENDER_TRACE_SPAN("tile"); });
+
+		render.join();
+	}
+
+	std::ostringstream json;
+	write_chrome_trace(json);
+
+	auto s = json.str();
+
+	// one thread name for the three passes, which keep their spans
+	EXPECT_EQ(s.find("\"thread_name\""), s.rfind("\"thread_name\""));
+
+	size_t tiles = 0;
+	for (size_t position = s.find("\"tile\""); position != std::string::npos; position = s.find("\"tile\"", position + 1))
+	{
+		tiles++;
+	}
+	EXPECT_EQ(3, tiles);
+
+	clear_trace_events();
+}
+
+TEST(RenderTrace, test_details_dont_overwrite_tiles)
+{
+	clear_trace_events();
+
+	std::thread render([] {
+		RENDER_TRACE_SPAN("tile");
+
+		for (size_t i = 0; i < thread_trace::detail_capacity + 1; i++)
+		{
+			RENDER_TRACE_DETAIL_SPAN("clipping");
+		}
+	});
+
+	render.join();
+
+	std::ostringstream json;
+	write_chrome_trace(json);
+
+	EXPECT_NE(std::string::npos, json.str().find("\"name\": \"tile\""));
+
+	clear_trace_events();
+}
+
+#endif
@@ -0,0 +1,115 @@
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include <file_io/scene_description.h>
+#include <file_io/render_report.h>
+
+TEST(SceneDescription, test_parse_patches_and_settings)
+{
+	std::string text =
+		"screen 64 48 # comment\n"
+		"camera 0 0 -4\n"
+		"epsilon 1E-6\n"
+		"solver hybrid\n"
+		"threads 3\n"
+		"tile_size 8\n"
+		"output image.ppm\n"
+		"patch 2 2\n"
+		"  0 0 0 1   1 0 0 1\n"
+		"  0 1 0 1   1 1 0 2\n"
+		"reflectivity 0.5\n"
+		"patch 2 2 0 0 1 1  1 0 1 1  0 1 1 1  1 1 1 1\n"
+		"color 10 20 30\n";
+
+	std::string error;
+	auto description = parse_scene_description(text, "scenes", error);
+
+	ASSERT_TRUE(description.has_value()) << error;
+
+	const auto& scene = description->scene;
+
+	EXPECT_EQ(64, scene.screen_width);
+	EXPECT_EQ(48, scene.screen_height);
+	EXPECT_EQ((v3{ 0, 0, -4 }), scene.origin);
+	EXPECT_EQ(1E-6, scene.epsilon);
+	EXPECT_EQ(intersection_solver::hybrid, scene.solver);
+	EXPECT_EQ(3, description->threads);
+	EXPECT_EQ(8, description->tile_size);
+	EXPECT_EQ(std::filesystem::path("scenes") / "image.ppm", description->output);
+
+	ASSERT_EQ(2, scene.surfaces.size());
+	EXPECT_EQ((v4{ 1, 1, 0, 2 }), scene.surfaces[0].mesh[1][1]);
+	EXPECT_EQ(0.5, scene.surfaces[0].reflectivity);
+
+	// the first patch without colour is white
+	ASSERT_EQ(2, scene.materials.materials.size());
+	EXPECT_EQ((color{ 255, 255, 255 }), scene.materials.sample(0, 0.5, 0.5));
+	EXPECT_EQ((color{ 10, 20, 30 }), scene.materials.sample(1, 0.5, 0.5));
+}
+
+TEST(SceneDescription, test_reject_malformed_descriptions)
+{
+	std::string error;
+
+	EXPECT_FALSE(parse_scene_description("screen 64\n", ".", error).has_value());
+	EXPECT_FALSE(parse_scene_description("patch 2 2 0 0 0 1\n", ".", error).has_value());
+	EXPECT_FALSE(parse_scene_description("patch 2 2 0 0 0 1 1 0 0 1 0 1 0 1 1 1 0 0\n", ".", error).has_value());
+	EXPECT_FALSE(parse_scene_description("color 1 2 3\npatch 2 2 0 0 0 1 1 0 0 1 0 1 0 1 1 1 0 1\n", ".", error).has_value());
+	EXPECT_FALSE(parse_scene_description("zoom 2\npatch 2 2 0 0 0 1 1 0 0 1 0 1 0 1 1 1 0 1\n", ".", error).has_value());
+	EXPECT_EQ("zoom: unknown keyword", error);
+	// the renderers would ignore a rotation of the camera
+	EXPECT_FALSE(parse_scene_description("rotation 0 0.5 0\npatch 2 2 0 0 0 1 1 0 0 1 0 1 0 1 1 1 0 1\n", ".", error).has_value());
+	EXPECT_EQ(0u, error.find("rotation: "));
+	EXPECT_TRUE(parse_scene_description("rotation 0 0 0\npatch 2 2 0 0 0 1 1 0 0 1 0 1 0 1 1 1 0 1\n", ".", error).has_value());
+	// nothing to render
+	EXPECT_FALSE(parse_scene_description("screen 64 64\n", ".", error).has_value());
+}
+
+TEST(SceneDescription, test_parse_supersampling)
+{
+	std::string patch = "patch 2 2 0 0 0 1 1 0 0 1 0 1 0 1 1 1 0 1\n";
+	std::string error;
+
+	auto description = parse_scene_description("supersample 3 12 0.01\n" + patch, ".", error);
+
+	ASSERT_TRUE(description.has_value()) << error;
+	ASSERT_TRUE(description->supersampling.has_value());
+	EXPECT_EQ(3, description->supersampling->strata);
+	EXPECT_EQ(12, description->supersampling->max_samples);
+	EXPECT_EQ(0.01, description->supersampling->noise_threshold);
+	EXPECT_TRUE(needs_float_output(*description));
+
+	// the noise threshold is optional
+	description = parse_scene_description("supersample 2 4\n" + patch, ".", error);
+
+	ASSERT_TRUE(description.has_value()) << error;
+	EXPECT_EQ(supersampling_settings{}.noise_threshold, description->supersampling->noise_threshold);
+
+	EXPECT_FALSE(parse_scene_description("supersample 0 4\n" + patch, ".", error).has_value());
+	EXPECT_FALSE(parse_scene_description("renderer tessellated\nsupersample 2 4\n" + patch, ".", error).has_value());
+}
+
+TEST(SceneDescription, test_report_as_json)
+{
+	render_report report;
+	report.scene = "dir\\\"scene\".txt";
+	report.renderer = "binned";
+	report.phase_seconds = { { "load", 0.5 }, { "render", 2 } };
+	report.statistics = intersection_statistics{};
+	report.statistics->clipping_steps = 42;
+	report.rays = 10;
+	report.hardware_counters = hardware_counter_values{};
+	report.hardware_counters->cycles = 1000;
+
+	std::ostringstream json;
+	write_json(json, report);
+
+	auto s = json.str();
+
+	EXPECT_NE(std::string::npos, s.find("\"scene\": \"dir\\\\\\\"scene\\\".txt\""));
+	EXPECT_NE(std::string::npos, s.find("\"seconds\": { \"load\": 0.5, \"render\": 2 }"));
+	EXPECT_NE(std::string::npos, s.find("\"clipping_steps\": 42"));
+	EXPECT_NE(std::string::npos, s.find("\"hardware_counters_per_ray\": { \"cycles\": 100, \"instructions\": null"));
+	EXPECT_EQ('}', s[s.find_last_not_of("\n")]);
+}
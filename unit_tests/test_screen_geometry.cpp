@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <numbers>
+
 #include <graphics/screen_geometry.h>
 
 using ::testing::InitGoogleTest;
@@ -48,4 +51,42 @@ TEST(ScreenGeometry, test_screen_geometry_aspectratio)
 	auto ray_0y = s.get_corresponding_ray(1023, 256);
 	auto ray_xy = s.get_corresponding_ray(1024, 256);
 	std::cout << "";
-}
\ No newline at end of file
+}
+
+TEST(ScreenGeometry, test_screen_tiles_overlapping)
+{
+	auto tiles = screen_tiles_overlapping(100, 70, 32, 30, -5, 40, 33);
+
+	ASSERT_EQ(4, tiles.size());
+	EXPECT_EQ(0, tiles[0].x_begin);
+	EXPECT_EQ(0, tiles[0].y_begin);
+	EXPECT_EQ(64, tiles[1].x_end);
+	EXPECT_EQ(64, tiles[3].y_end);
+
+	auto border_tiles = screen_tiles_overlapping(100, 70, 32, 97, 66, 120, 90);
+
+	ASSERT_EQ(1, border_tiles.size());
+	EXPECT_EQ(100, border_tiles[0].x_end);
+	EXPECT_EQ(70, border_tiles[0].y_end);
+
+	EXPECT_TRUE(screen_tiles_overlapping(100, 70, 32, 101, 0, 120, 10).empty());
+}
+
+TEST(ScreenGeometry, test_ray_differentials)
+{
+	int w = 512;
+	int h = 512;
+	double fov = 30;
+
+	screen_geometry s(w, h, fov, 0, 0, 0);
+
+	auto [dx, dy] = s.get_ray_differentials(255, 255);
+
+	// at the centre the rays are one pixel apart on the plane in distance 1
+	double pixel_size = 2 * std::tan(std::numbers::pi * 0.5 * fov / 180) / w;
+
+	EXPECT_NEAR(pixel_size, dx[0], 1E-6);
+	EXPECT_NEAR(0, dx[1], 1E-9);
+	EXPECT_NEAR(-pixel_size, dy[1], 1E-6);
+	EXPECT_NEAR(0, dy[0], 1E-9);
+}
@@ -3,6 +3,7 @@
 #include <geometry/types/bezier.h>
 
 #include <geometry/algorithms/quasi_interpolation.h>
+#include <geometry/algorithms/bilinear_patch_intersection.h>
 #include <geometry/types/bezier_surface.h>
 
 using ::testing::InitGoogleTest;
@@ -161,6 +162,50 @@ TEST(BilinearPatchIntersection, test_patch_roots_clipping)
 	}
 }
 
+TEST(BilinearPatchIntersection, test_patch_roots_analytic)
+{
+	for (const auto& m : { get_simple_bilinear_patch(), get_bilinear_patch(), get_other_bilinear_patch() })
+	{
+		std::array<v2, 2> roots;
+
+		ASSERT_EQ(1, bilinear_patch_roots_analytic(m, 1E-8, roots));
+
+		auto y = evaluate_bezier_surface(m, roots[0][0], roots[0][1]);
+
+		EXPECT_NEAR(0, length(y), 1E-12);
+	}
+}
+
+TEST(BilinearPatchIntersection, test_twisted_patch_roots_analytic)
+{
+	// S(u, v) = (u v - 0.2, u + v - 1) covers the origin twice
+	varmesh<2> m(2, 2);
+	m.element(0, 0) = { -0.2, -1 };
+	m.element(0, 1) = { -0.2, 0 };
+	m.element(1, 0) = { -0.2, 0 };
+	m.element(1, 1) = { 0.8, 1 };
+
+	std::array<v2, 2> roots;
+
+	ASSERT_EQ(2, bilinear_patch_roots_analytic(m, 1E-8, roots));
+
+	for (const auto& root : roots)
+	{
+		EXPECT_NEAR(0, length(evaluate_bezier_surface(m, root[0], root[1])), 1E-12);
+	}
+
+	// S(u, v) = (u v + 0.1, u + v - 1) doesn't
+	for (int i = 0; i < 2; i++)
+	{
+		for (int j = 0; j < 2; j++)
+		{
+			m.element(i, j)[0] += 0.3;
+		}
+	}
+
+	EXPECT_EQ(0, bilinear_patch_roots_analytic(m, 1E-8, roots));
+}
+
 TEST(Nurbs, vectorAddition)
 {
 	v2 p{ {3, 4} };